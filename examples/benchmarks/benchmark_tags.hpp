@@ -0,0 +1,36 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief benchmark_tag gets the tag of the i-th constraint of a benchmark ("C0", "C1", ...).
+ *        The prefix is appended to a std::string, since "C" + std::string(...) makes GCC 12 report
+ *        a false -Wrestrict.
+ * @param i The index of the constraint.
+ * @return The desired tag.
+ */
+inline std::string benchmark_tag(const std::size_t& i)
+{
+    std::string tag("C");
+    tag += std::to_string(i);
+    return tag;
+}
@@ -0,0 +1,150 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Compares the time and the peak RSS of the VFIConfigurationFileYaml load modes and arena
+#   modes, and the time to release the loaded data.
+#
+#   Usage: ./load_benchmark [number_of_entries]
+#
+#   Each load mode runs in a forked process, so the peak RSS reported by
+#   getrusage belongs to that load mode only.
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_yaml.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace DQ_robotics_extensions;
+
+namespace
+{
+
+/**
+ * @brief write_synthetic_file writes a VFI configuration file with the requested number of
+ *        entries. The entries are written directly, so the generator does not affect the RSS.
+ * @param config_file The file name.
+ * @param entries The number of entries.
+ */
+void write_synthetic_file(const std::string& config_file, const std::size_t& entries)
+{
+    std::ofstream file(config_file);
+    file << "vfi_file_version: 2\n";
+    file << "zero_indexed: false\n";
+    file << "vfi_array:\n";
+    for (std::size_t i = 0; i < entries; ++i) {
+        file << "  -\n";
+        if (i % 10 == 0) {
+            file << "    vfi_type: \"ENVIRONMENT_TO_ROBOT\"\n";
+            file << "    cs_entity_environment: [\"Cylinder_" << i << "\"]\n";
+            file << "    cs_entity_robot: [\"Sphere_" << i << "\"]\n";
+            file << "    entity_environment_primitive_type: \"LINE\"\n";
+            file << "    entity_robot_primitive_type: \"POINT\"\n";
+            file << "    robot_index: " << 1 + i % 4 << "\n";
+            file << "    joint_index: " << 1 + i % 7 << "\n";
+        } else {
+            file << "    vfi_type: \"ROBOT_TO_ROBOT\"\n";
+            file << "    cs_entity_one: [\"line_" << i << "\", \"sphere_" << i << "_0\", \"sphere_" << i << "_1\"]\n";
+            file << "    cs_entity_two: [\"line_" << i+1 << "\", \"sphere_" << i+1 << "_0\", \"sphere_" << i+1 << "_1\"]\n";
+            file << "    entity_one_primitive_type: \"LINESEGMENT\"\n";
+            file << "    entity_two_primitive_type: \"LINESEGMENT\"\n";
+            file << "    robot_index_one: " << 1 + i % 4 << "\n";
+            file << "    robot_index_two: " << 1 + (i+1) % 4 << "\n";
+            file << "    joint_index_one: " << 1 + i % 7 << "\n";
+            file << "    joint_index_two: " << 1 + (i+3) % 7 << "\n";
+        }
+        file << "    safe_distance: 0.0" << 1 + i % 9 << "\n";
+        file << "    vfi_gain: 1.0\n";
+        file << "    direction: \"RESTRICTED_ZONE\"\n";
+        file << "    tag: \"C" << i << "\"\n";
+    }
+}
+
+/**
+ * @brief run_load_mode loads the file in a child process and reports the elapsed time, the peak RSS
+ *        and the time to release the data.
+ * @param name The name of the load mode to display.
+ * @param load_mode The load mode.
+ * @param config_file The file name.
+ * @param cache_directory The cache directory, or an empty string to disable the cache.
+ * @param arena_mode The arena mode.
+ */
+void run_load_mode(const std::string& name,
+                   const VFIConfigurationFileYaml::LOAD_MODE& load_mode,
+                   const std::string& config_file,
+                   const std::string& cache_directory = "",
+                   const VFIConfigurationFile::ARENA_MODE& arena_mode = VFIConfigurationFile::ARENA_MODE::HEAP)
+{
+    const pid_t pid = fork();
+    if (pid == 0) {
+        auto vfi_file = std::make_unique<VFIConfigurationFileYaml>();
+        vfi_file->set_load_mode(load_mode);
+        vfi_file->set_cache_directory(cache_directory);
+        vfi_file->set_arena_mode(arena_mode);
+
+        const auto start = std::chrono::steady_clock::now();
+        vfi_file->load_data(config_file);
+        const auto end = std::chrono::steady_clock::now();
+        std::size_t entries = 0;
+        vfi_file->for_each_data([&entries](const VFIConfigurationFile::Data&) { ++entries; });
+
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        const auto release_start = std::chrono::steady_clock::now();
+        vfi_file.reset();
+        const auto release_end = std::chrono::steady_clock::now();
+        std::cout << name << ": " << entries << " entries, "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+                  << "peak RSS " << usage.ru_maxrss / 1024.0 << " MB, release "
+                  << std::chrono::duration<double, std::milli>(release_end - release_start).count() << " ms" << std::endl;
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t entries = (argc > 1) ? std::stoul(argv[1]) : 50000;
+    const std::string config_file = "load_benchmark_" + std::to_string(entries) + ".yaml";
+    write_synthetic_file(config_file, entries);
+
+    run_load_mode("DOM      ", VFIConfigurationFileYaml::LOAD_MODE::DOM, config_file);
+    run_load_mode("STREAMING", VFIConfigurationFileYaml::LOAD_MODE::STREAMING, config_file);
+    run_load_mode("SCANNER  ", VFIConfigurationFileYaml::LOAD_MODE::SCANNER, config_file);
+    run_load_mode("PARALLEL ", VFIConfigurationFileYaml::LOAD_MODE::PARALLEL, config_file);
+    run_load_mode("SCANNER MONOTONIC", VFIConfigurationFileYaml::LOAD_MODE::SCANNER, config_file, "",
+                  VFIConfigurationFile::ARENA_MODE::MONOTONIC);
+    run_load_mode("SCANNER POOL     ", VFIConfigurationFileYaml::LOAD_MODE::SCANNER, config_file, "",
+                  VFIConfigurationFile::ARENA_MODE::POOL);
+
+    const std::string cache_directory = "load_benchmark_cache";
+    std::filesystem::remove_all(cache_directory);
+    run_load_mode("COLD CACHE", VFIConfigurationFileYaml::LOAD_MODE::PARALLEL, config_file, cache_directory);
+    run_load_mode("WARM CACHE", VFIConfigurationFileYaml::LOAD_MODE::PARALLEL, config_file, cache_directory);
+    return 0;
+}
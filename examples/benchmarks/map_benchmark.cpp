@@ -0,0 +1,124 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Compares the std::map previously used by the RobotConstraintEditor with the OrderedHashMap
+#   that replaced it: insertion, lookup of every tag in random order, and iteration.
+#
+#   Usage: ./map_benchmark [number_of_entries ...]
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/ordered_hash_map.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+#include "benchmark_tags.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+using namespace DQ_robotics_extensions;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(const Clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+VFIConfigurationFile::Data make_data(const std::string& tag, const std::size_t& i)
+{
+    VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA data;
+    data.vfi_type = VFI_TYPE::ENVIRONMENT_TO_ROBOT;
+    data.entity_environment_primitive_type = PRIMITIVE_TYPE::PLANE;
+    data.entity_robot_primitive_type = PRIMITIVE_TYPE::POINT;
+    data.robot_index = 1 + i % 4;
+    data.joint_index = 1 + i % 7;
+    data.safe_distance = 0.01 * (1 + i % 9);
+    data.vfi_gain = 1.0;
+    data.direction = DIRECTION::SAFE_ZONE;
+    data.tag = tag;
+    return data;
+}
+
+double get_safe_distance(const VFIConfigurationFile::Data& data)
+{
+    return std::visit([](auto&& arg) { return arg.safe_distance; }, data);
+}
+
+/**
+ * @brief run_benchmark fills the map with the tags, then looks up the tags in the given order
+ *        and iterates over the map.
+ */
+template<typename Map>
+void run_benchmark(const std::string& name, const std::vector<std::string>& tags,
+                   const std::vector<std::string>& lookups)
+{
+    Map map;
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < tags.size(); ++i)
+        map.try_emplace(tags[i], make_data(tags[i], i));
+    const double insert_ms = elapsed_ms(start);
+
+    double sum = 0;
+    start = Clock::now();
+    for (const auto& tag : lookups)
+        sum += get_safe_distance(map.find(tag)->second);
+    const double lookup_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    for (const auto& pair : map)
+        sum += get_safe_distance(pair.second);
+    const double iteration_ms = elapsed_ms(start);
+
+    std::cout << std::setw(14) << name << ": insert " << std::setw(9) << insert_ms << " ms, "
+              << "lookup " << std::setw(9) << lookup_ms << " ms, "
+              << "iterate " << std::setw(9) << iteration_ms << " ms (checksum " << sum << ")" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::size_t> sizes = {10000, 100000, 1000000};
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(std::stoul(argv[i]));
+    }
+
+    std::mt19937 generator(42);
+    for (const auto& size : sizes) {
+        std::vector<std::string> tags;
+        tags.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+            tags.push_back(benchmark_tag(i));
+        std::vector<std::string> lookups = tags;
+        std::shuffle(lookups.begin(), lookups.end(), generator);
+
+        std::cout << size << " tags" << std::endl;
+        run_benchmark<std::map<std::string, VFIConfigurationFile::Data>>("std::map", tags, lookups);
+        run_benchmark<OrderedHashMap<std::string, VFIConfigurationFile::Data>>("OrderedHashMap", tags, lookups);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Compares a scan over the RobotConstraintEditor data (a copy from get_data, and a DataView) with
+#   the same scan over a ConstraintTable: all ROBOT_TO_ROBOT with robot_index_one == 2 and
+#   safe_distance < 0.05.
+#
+#   Usage: ./table_benchmark [number_of_entries] [number_of_scans]
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/robot_constraint_editor.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_yaml.hpp>
+#include "benchmark_tags.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+using namespace DQ_robotics_extensions;
+
+int main(int argc, char* argv[])
+{
+    const std::size_t entries = (argc > 1) ? std::stoul(argv[1]) : 100000;
+    const std::size_t scans = (argc > 2) ? std::stoul(argv[2]) : 1000;
+
+    RobotConstraintEditor editor(std::make_shared<VFIConfigurationFileYaml>());
+    for (std::size_t i = 0; i < entries; ++i) {
+        VFIConfigurationFile::ROBOT_TO_ROBOT_DATA data;
+        data.vfi_type = "ROBOT_TO_ROBOT";
+        data.cs_entity_one = {"line_" + std::to_string(i)};
+        data.cs_entity_two = {"line_" + std::to_string(i + 1)};
+        data.entity_one_primitive_type = "LINE";
+        data.entity_two_primitive_type = "LINE";
+        data.robot_index_one = 1 + i % 4;
+        data.robot_index_two = 1 + (i + 1) % 4;
+        data.joint_index_one = 1 + i % 7;
+        data.joint_index_two = 1 + (i + 3) % 7;
+        data.safe_distance = 0.01 * (1 + i % 9);
+        data.vfi_gain = 1.0;
+        data.direction = "RESTRICTED_ZONE";
+        data.tag = benchmark_tag(i);
+        editor.add_data(data);
+    }
+
+    std::size_t map_matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t scan = 0; scan < scans; ++scan) {
+        map_matches = 0;
+        for (const auto& item : editor.get_data()) {
+            if (const auto data = std::get_if<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(&item))
+                map_matches += (data->robot_index_one == 2 && data->safe_distance < 0.05);
+        }
+    }
+    const double map_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t view_matches = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t scan = 0; scan < scans; ++scan) {
+        view_matches = 0;
+        for (const auto& item : editor.get_data_view()) {
+            if (const auto data = std::get_if<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(&item))
+                view_matches += (data->robot_index_one == 2 && data->safe_distance < 0.05);
+        }
+    }
+    const double view_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const auto table = editor.get_constraint_table();
+    std::size_t table_matches = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t scan = 0; scan < scans; ++scan) {
+        auto rows = table.select(ConstraintTable::TYPE::ROBOT_TO_ROBOT);
+        table.filter(rows, ConstraintTable::COLUMN::ROBOT_INDEX_ONE, ConstraintTable::COMPARISON::EQUAL, 2);
+        table.filter(rows, ConstraintTable::COLUMN::SAFE_DISTANCE, ConstraintTable::COMPARISON::LESS, 0.05);
+        table_matches = table.count(rows);
+    }
+    const double table_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "MAP  : " << map_matches << " matches, " << map_ms / scans << " ms per scan" << std::endl;
+    std::cout << "VIEW : " << view_matches << " matches, " << view_ms / scans << " ms per scan" << std::endl;
+    std::cout << "TABLE: " << table_matches << " matches, " << table_ms / scans << " ms per scan" << std::endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Measures the ConstraintValidator with its built-in rules on a single thread and on all the
+#   hardware threads. One constraint in a thousand has a non-positive safe_distance.
+#
+#   Usage: ./validation_benchmark [number_of_entries]
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_validator.hpp>
+#include "benchmark_tags.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+using namespace DQ_robotics_extensions;
+
+int main(int argc, char* argv[])
+{
+    const std::size_t entries = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+
+    std::vector<VFIConfigurationFile::Data> data;
+    data.reserve(entries);
+    for (std::size_t i = 0; i < entries; ++i) {
+        VFIConfigurationFile::ROBOT_TO_ROBOT_DATA item;
+        item.vfi_type = "ROBOT_TO_ROBOT";
+        item.cs_entity_one = {"line_" + std::to_string(i % 1000)};
+        item.cs_entity_two = {"line_" + std::to_string((i + 1) % 1000)};
+        item.entity_one_primitive_type = "LINE";
+        item.entity_two_primitive_type = "LINE";
+        item.robot_index_one = 1 + i % 4;
+        item.robot_index_two = 1 + (i + 1) % 4;
+        item.joint_index_one = 1 + i % 7;
+        item.joint_index_two = 1 + (i + 3) % 7;
+        item.safe_distance = (i % 1000 == 0) ? 0.0 : 0.01;
+        item.vfi_gain = 1.0;
+        item.direction = "RESTRICTED_ZONE";
+        item.tag = benchmark_tag(i);
+        data.push_back(std::move(item));
+    }
+
+    ConstraintValidator validator(false);
+    validator.set_number_of_joints({7, 7, 7, 7});
+    for (const int& number_of_threads : {1, 0}) {
+        validator.set_number_of_threads(number_of_threads);
+        const auto start = std::chrono::steady_clock::now();
+        const auto diagnostics = validator.validate(data);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << (number_of_threads == 1 ? "SINGLE THREAD: " : "ALL THREADS  : ")
+                  << diagnostics.size() << " diagnostics, " << ms << " ms" << std::endl;
+    }
+    return 0;
+}
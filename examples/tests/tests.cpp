@@ -1,9 +1,25 @@
 
 #include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_yaml.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_binary.hpp>
 #include <dqrobotics_extensions/robot_constraint_editor/robot_constraint_editor.hpp>
 #include <dqrobotics_extensions/robot_constraint_editor/utils.hpp>
+#include <atomic>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <sys/resource.h>
 using namespace DQ_robotics_extensions;
 
+static std::string read_file(const std::string& file_name)
+{
+    std::ifstream file(file_name);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
 
 
 int main()
@@ -16,6 +32,152 @@ int main()
     //-- Edit the YAML file-----
 
 
+    // The other load modes must produce the same data as the DOM loader
+    ri->save_data(ri->get_data(), ri->get_vfi_file_version(), ri->is_zero_indexed(), "config_file_dom.yaml");
+    for (const auto& load_mode : {VFIConfigurationFileYaml::LOAD_MODE::STREAMING,
+                                  VFIConfigurationFileYaml::LOAD_MODE::SCANNER,
+                                  VFIConfigurationFileYaml::LOAD_MODE::PARALLEL})
+    {
+        auto ri_mode = std::make_shared<VFIConfigurationFileYaml>();
+        ri_mode->set_load_mode(load_mode);
+        ri_mode->load_data("config_file.yaml");
+        ri_mode->save_data(ri_mode->get_data(), ri_mode->get_vfi_file_version(),
+                           ri_mode->is_zero_indexed(), "config_file_mode.yaml");
+        if (read_file("config_file_dom.yaml") != read_file("config_file_mode.yaml"))
+            throw std::runtime_error("The load mode does not match the DOM load mode!");
+    }
+
+    // A parallel load of a large file must match the DOM loader, also when its threads are reused
+    {
+        std::vector<VFIConfigurationFile::Data> large_data;
+        for (int i = 0; i < 2000; ++i)
+            for (auto item : ri->get_data())
+            {
+                std::visit([i](auto&& arg) { arg.tag = arg.tag + "_" + std::to_string(i); }, item);
+                large_data.push_back(std::move(item));
+            }
+        ri->save_data(large_data, ri->get_vfi_file_version(), ri->is_zero_indexed(), "config_file_large.yaml");
+        auto ri_dom = std::make_shared<VFIConfigurationFileYaml>();
+        ri_dom->load_data("config_file_large.yaml");
+        ri_dom->save_data(ri_dom->get_data(), ri_dom->get_vfi_file_version(), ri_dom->is_zero_indexed(), "config_file_large_dom.yaml");
+        auto ri_parallel = std::make_shared<VFIConfigurationFileYaml>();
+        ri_parallel->set_load_mode(VFIConfigurationFileYaml::LOAD_MODE::PARALLEL);
+        ri_parallel->set_number_of_load_threads(4);
+        for (int i = 0; i < 3; ++i)
+        {
+            ri_parallel->load_data("config_file_large.yaml");
+            ri_parallel->save_data(ri_parallel->get_data(), ri_parallel->get_vfi_file_version(),
+                                   ri_parallel->is_zero_indexed(), "config_file_large_parallel.yaml");
+            if (read_file("config_file_large_dom.yaml") != read_file("config_file_large_parallel.yaml"))
+                throw std::runtime_error("The parallel load mode does not match the DOM load mode!");
+        }
+    }
+
+    // The streaming writer must produce the same file as save_data
+    {
+        auto writer = ri->open_writer("config_file_writer.yaml", ri->get_vfi_file_version(), ri->is_zero_indexed());
+        for (const auto& item : ri->get_data())
+            writer->write(item);
+        writer->close();
+        if (read_file("config_file_dom.yaml") != read_file("config_file_writer.yaml"))
+            throw std::runtime_error("The streaming writer does not match save_data!");
+    }
+
+    // Concurrent atomic writers of a file must publish one whole version, and keep its permissions
+    {
+        const std::string first(1 << 20, 'a'), second(1 << 20, 'b');
+        write_file_atomically("config_file_atomic.yaml", first);
+        std::filesystem::permissions("config_file_atomic.yaml", std::filesystem::perms::owner_read |
+                                                                std::filesystem::perms::owner_write);
+        std::thread writer([&first]() {
+            for (int i = 0; i < 20; ++i)
+                write_file_atomically("config_file_atomic.yaml", first);
+        });
+        for (int i = 0; i < 20; ++i)
+            write_file_atomically("config_file_atomic.yaml", second);
+        writer.join();
+        const std::string contents = read_file("config_file_atomic.yaml");
+        if ((contents != first && contents != second) ||
+            std::filesystem::status("config_file_atomic.yaml").permissions() !=
+                (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write))
+            throw std::runtime_error("The atomic writers interleave!");
+        for (const auto& file : std::filesystem::directory_iterator("."))
+            if (file.path().filename().string().rfind("config_file_atomic.yaml.", 0) == 0)
+                throw std::runtime_error("An atomic writer left its temporary file!");
+    }
+
+    // A warm load from the parse cache must produce the same data as the DOM loader
+    std::filesystem::remove_all("vfi_cache");
+    for (int i = 0; i < 2; ++i)
+    {
+        auto ri_cached = std::make_shared<VFIConfigurationFileYaml>();
+        ri_cached->set_cache_directory("vfi_cache");
+        // Loading must not report the writes of the cache
+        std::ostringstream output;
+        auto* const previous_output = std::cout.rdbuf(output.rdbuf());
+        ri_cached->load_data("config_file.yaml");
+        std::cout.rdbuf(previous_output);
+        if (!output.str().empty())
+            throw std::runtime_error("The parse cache writes to the console: " + output.str());
+        ri_cached->save_data(ri_cached->get_data(), ri_cached->get_vfi_file_version(),
+                             ri_cached->is_zero_indexed(), "config_file_cached.yaml");
+        if (read_file("config_file_dom.yaml") != read_file("config_file_cached.yaml"))
+            throw std::runtime_error("The cached load does not match the DOM load mode!");
+    }
+    if (std::distance(std::filesystem::directory_iterator("vfi_cache"), std::filesystem::directory_iterator()) != 1)
+        throw std::runtime_error("The parse cache was not written!");
+
+    // The cache must keep one entry per configuration file as the file is modified
+    {
+        std::string text = read_file("config_file.yaml");
+        const std::size_t field = text.find("safe_distance: 0.16");
+        auto ri_cached = std::make_shared<VFIConfigurationFileYaml>();
+        ri_cached->set_cache_directory("vfi_cache");
+        for (int i = 0; i < 3; ++i)
+        {
+            text.replace(field, 19, "safe_distance: 0.1" + std::to_string(7 + i));
+            std::ofstream("config_file_revised.yaml") << text;
+            ri_cached->load_data("config_file_revised.yaml");
+        }
+        if (std::distance(std::filesystem::directory_iterator("vfi_cache"), std::filesystem::directory_iterator()) != 2)
+            throw std::runtime_error("The parse cache keeps the stale entries!");
+    }
+
+    // YAML -> binary -> YAML round trip
+    auto rb = std::make_shared<VFIConfigurationFileBinary>();
+    rb->save_data(ri->get_data(), ri->get_vfi_file_version(), ri->is_zero_indexed(), "config_file.vfib");
+    rb->load_data("config_file.vfib");
+    if (rb->get_number_of_records() != ri->get_data().size() ||
+        rb->get_vfi_file_version() != ri->get_vfi_file_version() ||
+        rb->is_zero_indexed() != ri->is_zero_indexed())
+        throw std::runtime_error("The binary header does not match the YAML file!");
+    const std::string vfib_image = read_file("config_file.vfib");
+    {
+        auto writer = rb->open_writer("config_file_writer.vfib", rb->get_vfi_file_version(), rb->is_zero_indexed());
+        for (const auto& item : rb->get_data())
+            writer->write(item);
+        writer->close();
+        if (read_file("config_file_writer.vfib") != vfib_image)
+            throw std::runtime_error("The buffering writer does not match save_data!");
+    }
+    rb->save_data(rb->get_data(), rb->get_vfi_file_version(), rb->is_zero_indexed(), "config_file.vfib");
+    if (read_file("config_file.vfib") != vfib_image)
+        throw std::runtime_error("The binary round trip changed the .vfib file!");
+    ri->save_data(rb->get_data(), rb->get_vfi_file_version(), rb->is_zero_indexed(), "config_file_binary.yaml");
+    if (read_file("config_file_dom.yaml") != read_file("config_file_binary.yaml"))
+        throw std::runtime_error("The binary round trip does not match the YAML file!");
+    {
+        // A lazy editor indexes the records of a .vfib file, which stay valid after another load
+        auto rce_vfib = RobotConstraintEditor(rb);
+        rce_vfib.set_lazy_loading(true);
+        rce_vfib.load_data("config_file.vfib");
+        rb->load_data("config_file_writer.vfib");
+        ri->save_data(rce_vfib.get_data(), rb->get_vfi_file_version(), rb->is_zero_indexed(), "config_file_lazy_binary.yaml");
+        if (read_file("config_file_dom.yaml") != read_file("config_file_lazy_binary.yaml"))
+            throw std::runtime_error("The lazy binary entries do not match the YAML file!");
+    }
+
+
     //----To test the RobotConstraintEditor---//
     auto rce = RobotConstraintEditor(ri);
     rce.load_data("config_file.yaml");
@@ -41,8 +203,615 @@ int main()
     //----Edit a constraint
     rce.edit_data("C3", "tag", std::string("C33"));
 
+    // The editor keeps the file order, a renamed constraint keeps its position, and a rename to
+    // a tag in use is rejected
+    {
+        auto get_tag = [](const VFIConfigurationFile::Data& item) {
+            return std::visit([](auto&& arg) { return arg.tag; }, item);
+        };
+        ri->load_data("config_file.yaml");
+        std::vector<std::string> expected_tags;
+        for (const auto& item : ri->get_data())
+            expected_tags.push_back(get_tag(item) == "C3" ? "C33" : get_tag(item));
+        expected_tags.push_back("TAG_X1");
+        std::vector<std::string> tags;
+        for (const auto& item : rce.get_data())
+            tags.push_back(get_tag(item));
+        if (tags != expected_tags)
+            throw std::runtime_error("The editor does not keep the file order!");
+
+        // The views must see the same constraints as get_data, without copying them
+        std::vector<std::string> view_tags;
+        for (const auto& item : rce.get_data_view())
+            view_tags.push_back(get_tag(item));
+        std::vector<std::string> visited_tags;
+        rce.for_each([&visited_tags](const auto& arg) { visited_tags.push_back(arg.tag); });
+        if (view_tags != expected_tags || visited_tags != expected_tags ||
+            &rce.get_data("TAG_X1") != &*std::next(rce.get_data_view().begin(), expected_tags.size() - 1))
+            throw std::runtime_error("The data views do not match the data!");
+        bool rejected = false;
+        try {
+            rce.edit_data("C33", "tag", std::string("TAG_X1"));
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        if (!rejected || rce.get_data().size() != expected_tags.size())
+            throw std::runtime_error("A rename to a tag in use was not rejected!");
+    }
 
+
+    rce.save_data("config_file2.yaml", 2, false);
+
+    // Saving again without changes must not rewrite the file, and a save after an edit must
+    // match a full serialization of the data
+    const auto write_time = std::filesystem::last_write_time("config_file2.yaml");
+    if (rce.save_data("config_file2.yaml", 2, false) ||
+        std::filesystem::last_write_time("config_file2.yaml") != write_time)
+        throw std::runtime_error("An unchanged save rewrote the file!");
+    rce.edit_data("C33", "vfi_gain", 2.5);
     rce.save_data("config_file2.yaml", 2, false);
+    ri->save_data(rce.get_data(), 2, false, "config_file2_full.yaml");
+    if (read_file("config_file2.yaml") != read_file("config_file2_full.yaml"))
+        throw std::runtime_error("The cached fragments do not match the data!");
+    rce.edit_data("C33", "vfi_gain", 1.0);
+    rce.save_data("config_file2.yaml", 2, false);
+
+    // The edit journal must restore the edits that were not saved, before and after a compaction
+    // and after a save
+    for (const std::size_t& threshold : {std::size_t(1) << 20, std::size_t(200), std::size_t(1)})
+    {
+        std::filesystem::copy_file("config_file.yaml", "config_file_journal.yaml",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::remove("config_file_journal.yaml.journal");
+        std::vector<VFIConfigurationFile::Data> edited_data;
+        {
+            auto rce_journal = RobotConstraintEditor(ri);
+            rce_journal.set_journal_mode(true);
+            rce_journal.set_journal_compaction_threshold(threshold);
+            rce_journal.load_data("config_file_journal.yaml");
+            rce_journal.add_data(data);
+            rce_journal.edit_data("C3", "tag", std::string("C33"));
+            rce_journal.edit_data("C33", "safe_distance", 0.125);
+            rce_journal.remove_data("TAG_X1");
+            rce_journal.save_data("config_file_journal.yaml", 2, false);
+            rce_journal.edit_data("C2", "safe_distance", 0.25);
+            rce_journal.edit_data("C1", "vfi_gain", 0.5);
+            rce_journal.edit_data("C1", "tag", std::string("C11")); // Keeps its position in the file
+            edited_data = rce_journal.get_data();
+        }
+        auto rce_replay = RobotConstraintEditor(ri);
+        rce_replay.set_journal_mode(true);
+        rce_replay.load_data("config_file_journal.yaml");
+        ri->save_data(edited_data, 2, false, "config_file_edited.yaml");
+        ri->save_data(rce_replay.get_data(), 2, false, "config_file_replayed.yaml");
+        if (read_file("config_file_edited.yaml") != read_file("config_file_replayed.yaml"))
+            throw std::runtime_error("The journal replay does not match the edited data!");
+    }
+
+    // A compaction that cannot move the journal aside must not fail the modification
+    {
+        std::filesystem::copy_file("config_file.yaml", "config_file_journal.yaml",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::remove("config_file_journal.yaml.journal");
+        {
+            auto rce_journal = RobotConstraintEditor(ri);
+            rce_journal.set_journal_mode(true);
+            rce_journal.set_undo_mode(true);
+            rce_journal.set_journal_compaction_threshold(1);
+            rce_journal.load_data("config_file_journal.yaml");
+            std::filesystem::create_directory("config_file_journal.yaml.journal.compacting");
+            rce_journal.add_data(data);
+            if (!rce_journal.get_snapshot().contains("TAG_X1") || !rce_journal.can_undo())
+                throw std::runtime_error("The failed compaction interrupted the modification!");
+        }
+        std::filesystem::remove("config_file_journal.yaml.journal.compacting");
+        auto rce_replay = RobotConstraintEditor(ri);
+        rce_replay.set_journal_mode(true);
+        rce_replay.load_data("config_file_journal.yaml");
+        if (!rce_replay.get_snapshot().contains("TAG_X1"))
+            throw std::runtime_error("The records of the failed compaction were lost!");
+    }
+
+    // Columnar scans and bulk updates
+    {
+        auto rce_table = RobotConstraintEditor(ri);
+        rce_table.load_data("config_file.yaml");
+        auto table = rce_table.get_constraint_table();
+        auto rows = table.select(ConstraintTable::TYPE::ROBOT_TO_ROBOT);
+        table.filter(rows, ConstraintTable::COLUMN::ROBOT_INDEX_ONE, ConstraintTable::COMPARISON::EQUAL, 1);
+        table.filter(rows, ConstraintTable::COLUMN::SAFE_DISTANCE, ConstraintTable::COMPARISON::LESS, 0.05);
+        if (table.get_tags(rows) != std::vector<std::string>{"C3"})
+            throw std::runtime_error("The ConstraintTable scan selected the wrong rows!");
+        table.set(rows, ConstraintTable::COLUMN::SAFE_DISTANCE, 0.05);
+        rce_table.apply_constraint_table(table);
+        for (const auto& item : rce_table.get_data())
+        {
+            const auto& base = std::visit([](auto&& arg) -> const VFIConfigurationFile::BASE_DATA& { return arg; }, item);
+            if ((base.tag == "C3" && base.safe_distance != 0.05) || (base.tag == "C2" && base.safe_distance != 0.16))
+                throw std::runtime_error("The ConstraintTable update was not applied!");
+        }
+    }
+
+    // The secondary indexes must follow the edits, including the tag renames
+    {
+        auto rce_index = RobotConstraintEditor(ri);
+        rce_index.load_data("config_file.yaml");
+        auto get_tags = [](const TagView& view) { return std::vector<std::string>(view.begin(), view.end()); };
+        if (get_tags(rce_index.get_tags_by_robot(2)) != std::vector<std::string>{"C2", "C3"} ||
+            get_tags(rce_index.get_tags_by_joint(2, 7)) != std::vector<std::string>{"C3"} ||
+            get_tags(rce_index.get_tags_by_entity("Cylinder_1")) != std::vector<std::string>{"C1"})
+            throw std::runtime_error("The secondary indexes do not match the data!");
+        rce_index.edit_data("C3", "tag", std::string("C33"));
+        rce_index.edit_data("C2", "robot_index_two", 3);
+        rce_index.remove_data("C1");
+        if (get_tags(rce_index.get_tags_by_robot(2)) != std::vector<std::string>{"C33"} ||
+            get_tags(rce_index.get_tags_by_joint(3, 1)) != std::vector<std::string>{"C2"} ||
+            !rce_index.get_tags_by_entity("Cylinder_1").empty())
+            throw std::runtime_error("The secondary indexes were not updated!");
+
+        // The lookups must not intern the strings of the caller
+        ConstraintQuery unknown;
+        unknown.where(FIELD::CS_ENTITY_ROBOT, ConstraintQuery::COMPARISON::CONTAINS, "Unknown_entity_1")
+               .where(FIELD::ENTITY_ROBOT_PRIMITIVE_TYPE, ConstraintQuery::COMPARISON::EQUAL, "Unknown_primitive_1");
+        if (!rce_index.get_tags_by_entity("Unknown_entity_2").empty() || !rce_index.select_tags(unknown).empty() ||
+            Symbol::find("Unknown_entity_1") || Symbol::find("Unknown_entity_2") || Symbol::find("Unknown_primitive_1") ||
+            !Symbol::find("Cylinder_1"))
+            throw std::runtime_error("The lookups intern unknown strings!");
+    }
+
+    // The ConstraintIds must survive the tag renames and the removal of other constraints
+    {
+        auto rce_id = RobotConstraintEditor(ri);
+        rce_id.set_lazy_loading(true);
+        rce_id.load_data("config_file.yaml");
+        const ConstraintId c3 = rce_id.get_id("C3");
+        const ConstraintId x1 = rce_id.add_data(data);
+        rce_id.edit_data(c3, "tag", std::string("C33"));
+        rce_id.remove_data("C1");
+        rce_id.edit_data(c3, "safe_distance", 0.25);
+        const auto& c33 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_id.get_data(c3));
+        if (c33.tag != "C33" || c33.safe_distance != 0.25 || rce_id.get_id("C33") != c3 ||
+            std::visit([](auto&& arg) { return arg.tag; }, rce_id.get_data(x1)) != "TAG_X1")
+            throw std::runtime_error("The ConstraintIds do not follow the constraints!");
+        rce_id.remove_data(x1);
+        if (rce_id.is_valid(x1) || !rce_id.is_valid(c3))
+            throw std::runtime_error("A removed ConstraintId is still valid!");
+    }
+
+    // The typed edits must match the edits by key, and reject the fields of the other VFI type
+    {
+        auto rce_typed = RobotConstraintEditor(ri);
+        rce_typed.load_data("config_file.yaml");
+        rce_typed.edit<FIELD::SAFE_DISTANCE>("C1", 0.25);
+        rce_typed.edit<FIELD::JOINT_INDEX_TWO>("C3", 6);
+        rce_typed.edit<FIELD::TAG>("C3", "C33");
+        const auto& c1 = std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(rce_typed.get_data("C1"));
+        const auto& c33 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_typed.get_data("C33"));
+        bool rejected = false;
+        try {
+            rce_typed.edit<FIELD::ROBOT_INDEX>("C2", 3);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        if (c1.safe_distance != 0.25 || c33.joint_index_two != 6 || !rejected ||
+            find_field("joint_index_two") != FIELD::JOINT_INDEX_TWO || find_field("joint"))
+            throw std::runtime_error("The typed edits do not match the field table!");
+    }
+
+    // The arena-backed documents must hold the same constraints, and never share their arenas
+    {
+        auto ri_arena = std::make_shared<VFIConfigurationFileYaml>();
+        ri_arena->set_arena_mode(VFIConfigurationFile::ARENA_MODE::MONOTONIC);
+        auto rce_arena = RobotConstraintEditor(ri_arena);
+        rce_arena.set_arena_mode(VFIConfigurationFile::ARENA_MODE::POOL);
+        rce_arena.load_data("config_file.yaml");
+        ri_arena->load_data("config_file.yaml");
+        rce_arena.edit_data("C2", "cs_entity_one", std::vector<std::string>{"entity5"});
+        rce_arena.save_data("config_file_arena.yaml", 2, false);
+        auto rce_heap = RobotConstraintEditor(ri);
+        rce_heap.load_data("config_file.yaml");
+        rce_heap.edit_data("C2", "cs_entity_one", std::vector<std::string>{"entity5"});
+        rce_heap.save_data("config_file_heap.yaml", 2, false);
+        const auto copy = rce_arena.get_data();
+        const auto& c2 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(copy.at(1));
+        if (read_file("config_file_arena.yaml") != read_file("config_file_heap.yaml") ||
+            c2.cs_entity_one.get_allocator().resource() != std::pmr::get_default_resource())
+            throw std::runtime_error("The arena-backed editor does not match the heap editor!");
+    }
+
+    // The snapshots must keep their versions, and share the constraints that did not change
+    {
+        auto rce_versions = RobotConstraintEditor(ri);
+        rce_versions.load_data("config_file.yaml");
+        std::vector<RobotConstraintEditor::Snapshot> versions;
+        for (int i = 0; i < 300; ++i)
+        {
+            rce_versions.edit<FIELD::SAFE_DISTANCE>("C2", i);
+            if (i == 100)
+                rce_versions.edit<FIELD::TAG>("C3", std::string("C33"));
+            versions.push_back(rce_versions.get_snapshot());
+        }
+        bool consistent = true;
+        for (int i = 0; i < 300; ++i)
+        {
+            const auto& c2 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(versions[i].get_data("C2"));
+            consistent = consistent && c2.safe_distance == i && versions[i].size() == 3 &&
+                         versions[i].contains("C3") == (i < 100) && versions[i].contains("C33") == (i >= 100) &&
+                         &versions[i].get_data("C1") == &versions.front().get_data("C1");
+        }
+        if (!consistent)
+            throw std::runtime_error("The snapshots of the editor do not keep their versions!");
+    }
+
+    // The readers of the snapshots must never see a partial modification of the editor
+    {
+        auto rce_concurrent = RobotConstraintEditor(ri);
+        rce_concurrent.load_data("config_file.yaml");
+        rce_concurrent.set_concurrent_mode(true);
+        const std::size_t size = rce_concurrent.get_snapshot().size();
+        auto temporary = rce_concurrent.get_data("C1");
+        std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(temporary).tag = "C_TEMPORARY";
+        std::atomic<bool> done{false};
+        std::atomic<bool> consistent{true};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+            readers.emplace_back([&]() {
+                while (!done)
+                {
+                    const auto snapshot = rce_concurrent.get_snapshot();
+                    const double c2 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(snapshot.get_data("C2")).safe_distance;
+                    const double c3 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(snapshot.get_data("C3")).safe_distance;
+                    std::size_t count = 0;
+                    snapshot.for_each([&count](const auto&) { ++count; });
+                    if (c3 > c2 || c2 - c3 > 1 || count != snapshot.size() ||
+                        (snapshot.size() != size && !snapshot.contains("C_TEMPORARY")))
+                        consistent = false;
+                }
+            });
+        for (int i = 1; i <= 2000; ++i)
+        {
+            rce_concurrent.edit<FIELD::SAFE_DISTANCE>("C2", i);
+            rce_concurrent.edit<FIELD::SAFE_DISTANCE>("C3", i);
+            if (i % 2)
+                rce_concurrent.add_data(temporary);
+            else
+                rce_concurrent.remove_data("C_TEMPORARY");
+        }
+        done = true;
+        for (auto& reader : readers)
+            reader.join();
+        if (!consistent || rce_concurrent.get_snapshot().size() != size)
+            throw std::runtime_error("The snapshots of the concurrent editor are inconsistent!");
+    }
+
+    // Undoing every modification must restore the loaded constraints, in order, and redo must make them again
+    {
+        auto rce_undo = RobotConstraintEditor(ri);
+        rce_undo.load_data("config_file.yaml");
+        rce_undo.set_undo_mode(true);
+        rce_undo.save_data("config_file_undo_before.yaml", 2, false);
+        for (int i = 1; i <= 100; ++i)
+            rce_undo.edit<FIELD::SAFE_DISTANCE>("C2", i); // Coalesced into a single step
+        rce_undo.set_undo_coalescing_window(std::chrono::milliseconds(0));
+        rce_undo.edit_data("C3", "tag", std::string("C33"));
+        rce_undo.replace_data("C1", data);
+        rce_undo.save_data("config_file_undo_after.yaml", 2, false);
+        int steps = 0;
+        while (rce_undo.undo())
+            ++steps;
+        rce_undo.save_data("config_file_undo_undone.yaml", 2, false);
+        const bool undone = steps == 3 && read_file("config_file_undo_before.yaml") == read_file("config_file_undo_undone.yaml");
+        while (rce_undo.redo())
+            ;
+        rce_undo.save_data("config_file_undo_redone.yaml", 2, false);
+        if (!undone || read_file("config_file_undo_after.yaml") != read_file("config_file_undo_redone.yaml"))
+            throw std::runtime_error("The undo history does not restore the constraints!");
+        rce_undo.set_undo_memory_limit(0);
+        if (rce_undo.can_undo() || rce_undo.can_redo())
+            throw std::runtime_error("The undo history exceeds its memory limit!");
+
+        // The removed constraints must be restored at their places, even after the map compacted
+        auto rce_order = RobotConstraintEditor(ri);
+        rce_order.load_data("config_file.yaml");
+        rce_order.set_undo_mode(true);
+        rce_order.set_undo_coalescing_window(std::chrono::milliseconds(0));
+        auto t = data;
+        for (int i = 0; i < 40; ++i)
+        {
+            t.tag = "T" + std::to_string(i);
+            rce_order.add_data(t);
+        }
+        const auto order = rce_order.select_tags(ConstraintQuery());
+        for (int i = 0; i < 30; ++i)
+            rce_order.remove_data("T" + std::to_string(i));
+        for (int i = 0; i < 30; ++i)
+            rce_order.undo();
+        if (rce_order.select_tags(ConstraintQuery()) != order)
+            throw std::runtime_error("The undo history does not restore the order of the constraints!");
+    }
+
+    // A transaction must apply all its operations, or none if any of them fails
+    {
+        auto rce_transaction = RobotConstraintEditor(ri);
+        rce_transaction.load_data("config_file.yaml");
+        const std::size_t robot_tags = rce_transaction.get_tags_by_robot(1).size();
+        rce_transaction.save_data("config_file_transaction_before.yaml", 2, false);
+        auto transaction = rce_transaction.begin();
+        transaction.edit<FIELD::SAFE_DISTANCE>("C2", 0.5);
+        transaction.replace_data("C1", data);
+        transaction.edit_data("C3", "robot_index", 1); // ROBOT_TO_ROBOT has no robot_index
+        bool rejected = false;
+        try {
+            transaction.commit();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        rce_transaction.save_data("config_file_transaction_after.yaml", 2, false);
+        if (!rejected || read_file("config_file_transaction_before.yaml") != read_file("config_file_transaction_after.yaml"))
+            throw std::runtime_error("A failed transaction modified the editor!");
+
+        transaction = rce_transaction.begin();
+        transaction.edit<FIELD::SAFE_DISTANCE>("C2", 0.5);
+        transaction.edit_data("C3", "tag", std::string("C33"));
+        transaction.replace_data("C1", data);
+        transaction.edit<FIELD::ROBOT_INDEX_ONE>("TAG_X1", 7);
+        transaction.commit();
+        const auto& c2 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_transaction.get_data("C2"));
+        const auto robot_one_tags = rce_transaction.get_tags_by_robot(1);
+        if (c2.safe_distance != 0.5 || !rce_transaction.get_tags_by_robot(7).contains("TAG_X1") ||
+            robot_one_tags.size() != robot_tags - 1 || !robot_one_tags.contains("C33") || robot_one_tags.contains("C3"))
+            throw std::runtime_error("The transaction was not applied!");
+    }
+
+    // A transaction is journaled as a single record group, and reverted if it cannot be journaled
+    {
+        std::filesystem::copy_file("config_file.yaml", "config_file_journal.yaml",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::remove("config_file_journal.yaml.journal");
+        std::filesystem::remove("config_file_journal.yaml.journal.compacting");
+        {
+            auto rce_journal = RobotConstraintEditor(ri);
+            rce_journal.set_journal_mode(true);
+            rce_journal.load_data("config_file_journal.yaml");
+            rce_journal.save_data("config_file_transaction_before.yaml", 2, false);
+            auto transaction = rce_journal.begin();
+            transaction.edit<FIELD::SAFE_DISTANCE>("C2", 0.5);
+            transaction.replace_data("C1", data);
+            transaction.edit_data("C3", "tag", std::string("C33"));
+
+            // The journal cannot grow, so the group cannot be written
+            const auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+            rlimit limit{};
+            getrlimit(RLIMIT_FSIZE, &limit);
+            const rlimit previous_limit = limit;
+            limit.rlim_cur = std::filesystem::file_size("config_file_journal.yaml.journal") + 16;
+            setrlimit(RLIMIT_FSIZE, &limit);
+            bool rejected = false;
+            try {
+                transaction.commit();
+            } catch (const std::runtime_error&) {
+                rejected = true;
+            }
+            setrlimit(RLIMIT_FSIZE, &previous_limit);
+            std::signal(SIGXFSZ, previous_handler);
+            rce_journal.save_data("config_file_transaction_after.yaml", 2, false);
+            if (!rejected || rce_journal.can_undo() ||
+                read_file("config_file_transaction_before.yaml") != read_file("config_file_transaction_after.yaml"))
+                throw std::runtime_error("A transaction that could not be journaled modified the editor!");
+        }
+        {
+            auto rce_journal = RobotConstraintEditor(ri);
+            rce_journal.set_journal_mode(true);
+            rce_journal.load_data("config_file_journal.yaml");
+            auto transaction = rce_journal.begin();
+            transaction.edit<FIELD::SAFE_DISTANCE>("C2", 0.5);
+            transaction.replace_data("C1", data);
+            transaction.commit();
+        }
+        // A crash in the middle of the group loses the whole transaction
+        std::filesystem::resize_file("config_file_journal.yaml.journal",
+                                     std::filesystem::file_size("config_file_journal.yaml.journal") - 1);
+        auto rce_replay = RobotConstraintEditor(ri);
+        rce_replay.set_journal_mode(true);
+        rce_replay.load_data("config_file_journal.yaml");
+        rce_replay.save_data("config_file_transaction_after.yaml", 2, false);
+        if (read_file("config_file_transaction_before.yaml") != read_file("config_file_transaction_after.yaml"))
+            throw std::runtime_error("The journal replays a part of a transaction!");
+    }
+
+    // A query must update the constraints that satisfy its conditions only, in a single undo step
+    {
+        auto rce_query = RobotConstraintEditor(ri);
+        rce_query.load_data("config_file.yaml");
+        rce_query.set_undo_mode(true);
+        ConstraintQuery scale_gain;
+        scale_gain.where(FIELD::VFI_TYPE, ConstraintQuery::COMPARISON::EQUAL, "ROBOT_TO_ROBOT")
+                  .where(FIELD::JOINT_INDEX_ONE, ConstraintQuery::COMPARISON::GREATER_EQUAL, 5)
+                  .scale(FIELD::VFI_GAIN, 1.5);
+        ConstraintQuery set_distance;
+        set_distance.where(FIELD::CS_ENTITY_ROBOT, ConstraintQuery::COMPARISON::CONTAINS, "Sphere_*")
+                    .set(FIELD::SAFE_DISTANCE, 0.02);
+        ConstraintQuery spheres;
+        spheres.where(FIELD::CS_ENTITY_ONE, ConstraintQuery::COMPARISON::CONTAINS, "sphere_1_?");
+        if (rce_query.apply_query(scale_gain) != 1 || rce_query.apply_query(set_distance) != 1 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_query.get_data("C3")).vfi_gain != 1.5 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_query.get_data("C2")).vfi_gain != 1.0 ||
+            std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(rce_query.get_data("C1")).safe_distance != 0.02 ||
+            rce_query.select_tags(spheres) != std::vector<std::string>{"C3"})
+            throw std::runtime_error("The query does not select the expected constraints!");
+        rce_query.undo();
+        if (std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(rce_query.get_data("C1")).safe_distance == 0.02 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_query.get_data("C3")).vfi_gain != 1.5)
+            throw std::runtime_error("The query was not undone as a single step!");
+        bool rejected = false;
+        try {
+            ConstraintQuery().set(FIELD::JOINT_INDEX_ONE, 2.7);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        if (!rejected)
+            throw std::runtime_error("The query truncates a non-integral value of an integer field!");
+
+        // The threads must match the same constraints as a single thread
+        auto c3 = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_query.get_data("C3"));
+        for (int i = 0; i < 20000; ++i)
+        {
+            c3.tag = "C3_" + std::to_string(i);
+            c3.joint_index_one = i % 10;
+            rce_query.add_data(c3);
+        }
+        const auto tags = rce_query.select_tags(scale_gain);
+        rce_query.set_number_of_query_threads(4);
+        if (rce_query.select_tags(scale_gain) != tags || tags.size() != 10001)
+            throw std::runtime_error("The threads of the query do not match a single thread!");
+    }
+
+    // The validator must accept the specification file, and report each broken rule of a constraint
+    {
+        auto rce_validated = RobotConstraintEditor(ri);
+        rce_validated.load_data("config_file.yaml");
+        auto validator = std::make_shared<ConstraintValidator>(false);
+        validator->set_number_of_joints({7, 7});
+        if (!rce_validated.validate(*validator).empty())
+            throw std::runtime_error("The validator rejects the specification file!");
+
+        auto broken = data;
+        broken.tag = "BROKEN";
+        broken.cs_entity_two = {"entity3"};
+        broken.robot_index_two = 3;                      // indices
+        broken.entity_one_primitive_type = "LINESEGMENT"; // entity_lists: a line and two endpoints
+        broken.direction = "SIDEWAYS";                  // types
+        broken.vfi_gain = 0;                            // gains
+        rce_validated.add_data(broken);
+        std::vector<std::string> rules;
+        for (const auto& diagnostic : rce_validated.validate(*validator))
+            if (diagnostic.tag == "BROKEN" && diagnostic.index == 3)
+                rules.push_back(diagnostic.rule);
+        if (rules != std::vector<std::string>{"indices", "entity_lists", "types", "gains"})
+            throw std::runtime_error("The validator does not report the broken rules!");
+
+        rce_validated.set_validator(validator);
+        bool rejected = false;
+        try {
+            rce_validated.save_data("config_file_invalid.yaml", 2, false);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        if (!rejected || std::filesystem::exists("config_file_invalid.yaml"))
+            throw std::runtime_error("An invalid constraint set was saved!");
+
+        // The indices are checked with the convention of the saved file: joint 7 of a robot with
+        // 7 joints is out of bounds when zero-indexed
+        auto rce_convention = RobotConstraintEditor(ri);
+        rce_convention.set_lazy_loading(true);
+        rce_convention.load_data("config_file.yaml");
+        rce_convention.set_validator(validator);
+        rce_convention.save_data("config_file_convention.yaml", 2, false);
+        rejected = false;
+        try {
+            rce_convention.save_data("config_file_convention_zero.yaml", 2, true);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        if (!rejected)
+            throw std::runtime_error("The validator ignores the index convention of the saved file!");
+    }
+
+    // The duplicates must be found in any order of the sides, and merged with the strictest safe_distance
+    {
+        auto rce_duplicates = RobotConstraintEditor(ri);
+        rce_duplicates.load_data("config_file.yaml");
+        rce_duplicates.set_undo_mode(true);
+        auto swapped = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_duplicates.get_data("C2"));
+        std::swap(swapped.cs_entity_one, swapped.cs_entity_two);
+        std::swap(swapped.entity_one_primitive_type, swapped.entity_two_primitive_type);
+        std::swap(swapped.robot_index_one, swapped.robot_index_two);
+        std::swap(swapped.joint_index_one, swapped.joint_index_two);
+        swapped.tag = "C2_SWAPPED";
+        swapped.safe_distance = 0.3;
+        rce_duplicates.add_data(swapped);
+        auto copy = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_duplicates.get_data("C3"));
+        copy.tag = "C3_COPY";
+        rce_duplicates.add_data(copy);
+
+        const auto groups = rce_duplicates.find_duplicates();
+        if (groups.size() != 2 ||
+            groups[0].tags != std::vector<std::string>{"C2", "C2_SWAPPED"} || !groups[0].conflicting || groups[0].safe_distance != 0.3 ||
+            groups[1].tags != std::vector<std::string>{"C3", "C3_COPY"} || groups[1].conflicting)
+            throw std::runtime_error("The duplicates were not found!");
+
+        if (rce_duplicates.merge_duplicates() != 2 || rce_duplicates.get_data().size() != 3 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_duplicates.get_data("C2")).safe_distance != 0.3 ||
+            !rce_duplicates.find_duplicates().empty())
+            throw std::runtime_error("The duplicates were not merged!");
+        rce_duplicates.undo();
+        if (rce_duplicates.get_data().size() != 5 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_duplicates.get_data("C2")).safe_distance != 0.16)
+            throw std::runtime_error("The merge was not undone as a single step!");
+
+        // A merge that cannot be journaled is reverted
+        std::filesystem::copy_file("config_file.yaml", "config_file_journal.yaml",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::remove("config_file_journal.yaml.journal");
+        std::filesystem::remove("config_file_journal.yaml.journal.compacting");
+        auto rce_journal = RobotConstraintEditor(ri);
+        rce_journal.set_journal_mode(true);
+        rce_journal.load_data("config_file_journal.yaml");
+        rce_journal.add_data(swapped);
+        rce_journal.add_data(copy);
+        const auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit limit{};
+        getrlimit(RLIMIT_FSIZE, &limit);
+        const rlimit previous_limit = limit;
+        limit.rlim_cur = std::filesystem::file_size("config_file_journal.yaml.journal") + 16;
+        setrlimit(RLIMIT_FSIZE, &limit);
+        bool rejected = false;
+        try {
+            rce_journal.merge_duplicates();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        setrlimit(RLIMIT_FSIZE, &previous_limit);
+        std::signal(SIGXFSZ, previous_handler);
+        if (!rejected || rce_journal.can_undo() || rce_journal.get_data().size() != 5 ||
+            std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(rce_journal.get_data("C2")).safe_distance != 0.16)
+            throw std::runtime_error("A merge that could not be journaled modified the editor!");
+    }
+
+    // A lazy editor must save the same constraints as the eager editor
+    auto rce_lazy = RobotConstraintEditor(ri);
+    rce_lazy.set_lazy_loading(true);
+    rce_lazy.load_data("config_file.yaml");
+    rce_lazy.add_data(data);
+    rce_lazy.edit_data("C3", "tag", std::string("C33"));
+    rce_lazy.save_data("config_file2_lazy.yaml", 2, false);
+    for (const auto& config_file : {"config_file2.yaml", "config_file2_lazy.yaml"})
+    {
+        ri->load_data(config_file);
+        ri->save_data(ri->get_data(), ri->get_vfi_file_version(), ri->is_zero_indexed(),
+                      std::string(config_file) + ".resaved");
+    }
+    if (read_file("config_file2.yaml.resaved") != read_file("config_file2_lazy.yaml.resaved") ||
+        rce_lazy.get_data().size() != rce.get_data().size())
+        throw std::runtime_error("The lazy editor does not match the eager editor!");
+
+    // A lazy editor must skip a malformed entry, as the eager editor does
+    {
+        std::string text = read_file("config_file2_lazy.yaml");
+        const std::size_t field = text.rfind("safe_distance: ", text.find("tag: \"C2\""));
+        text.replace(field, text.find('\n', field) - field, "safe_distance: abc");
+        std::ofstream("config_file_malformed.yaml") << text;
+        auto rce_eager = RobotConstraintEditor(ri);
+        rce_eager.load_data("config_file_malformed.yaml");
+        auto rce_malformed = RobotConstraintEditor(ri);
+        rce_malformed.set_lazy_loading(true);
+        rce_malformed.load_data("config_file_malformed.yaml");
+        rce_eager.save_data("config_file_malformed_eager.yaml", 2, false);
+        rce_malformed.save_data("config_file_malformed_lazy.yaml", 2, false);
+        if (rce_malformed.get_data().size() != rce_lazy.get_data().size() - 1 ||
+            read_file("config_file_malformed_eager.yaml") != read_file("config_file_malformed_lazy.yaml"))
+            throw std::runtime_error("The lazy editor does not skip a malformed entry!");
+    }
 
 
 
@@ -0,0 +1,68 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Converts VFI configuration files between the YAML and the compiled binary (.vfib) formats.
+#   The format of each file is selected from its extension.
+#
+#   Usage: ./vfib_converter config_file.yaml config_file.vfib
+#          ./vfib_converter config_file.vfib config_file.yaml
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_yaml.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_binary.hpp>
+#include <filesystem>
+#include <iostream>
+using namespace DQ_robotics_extensions;
+
+namespace
+{
+
+std::shared_ptr<VFIConfigurationFile> make_configuration_file(const std::string& config_file)
+{
+    const std::string extension = std::filesystem::path(config_file).extension().string();
+    if (extension == ".vfib")
+        return std::make_shared<VFIConfigurationFileBinary>();
+    if (extension == ".yaml" || extension == ".yml") {
+        auto yaml_file = std::make_shared<VFIConfigurationFileYaml>();
+        yaml_file->set_load_mode(VFIConfigurationFileYaml::LOAD_MODE::PARALLEL);
+        return yaml_file;
+    }
+    throw std::runtime_error("Unknown format for " + config_file + ". Use .yaml, .yml or .vfib");
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " input_file output_file" << std::endl;
+        return 1;
+    }
+    try {
+        auto input = make_configuration_file(argv[1]);
+        auto output = make_configuration_file(argv[2]);
+        input->load_data(argv[1]);
+        output->save_data(input->get_data(), input->get_vfi_file_version(), input->is_zero_indexed(), argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
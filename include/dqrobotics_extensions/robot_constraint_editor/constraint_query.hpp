@@ -0,0 +1,79 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_field_table.hpp>
+
+namespace DQ_robotics_extensions
+{
+/**
+ * @brief The ConstraintQuery class is a compiled filter and update over VFI constraints. Each
+ *        condition and each update is resolved, when it is added, to a function that reads or
+ *        writes the member of the field directly, one per VFI type. A condition on a field that a
+ *        VFI type does not have rejects the constraints of that type. Example:
+ *
+ *        ConstraintQuery query;
+ *        query.where(FIELD::VFI_TYPE, ConstraintQuery::COMPARISON::EQUAL, "ROBOT_TO_ROBOT")
+ *             .where(FIELD::JOINT_INDEX_ONE, ConstraintQuery::COMPARISON::GREATER_EQUAL, 5)
+ *             .scale(FIELD::VFI_GAIN, 1.5);
+ *        editor.apply_query(query);
+ *
+ *        query = ConstraintQuery();
+ *        query.where(FIELD::CS_ENTITY_ROBOT, ConstraintQuery::COMPARISON::CONTAINS, "Sphere_*")
+ *             .set(FIELD::SAFE_DISTANCE, 0.02);
+ *        editor.apply_query(query);
+ */
+class ConstraintQuery
+{
+public:
+    enum class COMPARISON{
+        EQUAL,         // Numeric or string fields
+        NOT_EQUAL,     // Numeric or string fields
+        LESS,          // Numeric fields only
+        LESS_EQUAL,    // Numeric fields only
+        GREATER,       // Numeric fields only
+        GREATER_EQUAL, // Numeric fields only
+        MATCH,         // String fields only: the value is a pattern, where '*' matches any text and '?' any character
+        CONTAINS       // Entity lists only: an entity matches the pattern, as in MATCH
+    };
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_;
+public:
+    ConstraintQuery();
+
+    ConstraintQuery& where(const FIELD& field, const COMPARISON& comparison, const double& value);
+    ConstraintQuery& where(const FIELD& field, const COMPARISON& comparison, const std::string& value);
+    ConstraintQuery& where(const FIELD& field, const COMPARISON& comparison, const char* value);
+    ConstraintQuery& set(const FIELD& field, const double& value);
+    ConstraintQuery& set(const FIELD& field, const std::string& value);
+    ConstraintQuery& set(const FIELD& field, const char* value);
+    ConstraintQuery& scale(const FIELD& field, const double& factor);
+
+    bool matches(const VFIConfigurationFile::Data& data) const;
+    bool update(VFIConfigurationFile::Data& data) const;
+    const std::vector<FIELD>& get_updated_fields() const;
+};
+}
@@ -0,0 +1,131 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+
+namespace DQ_robotics_extensions
+{
+/**
+ * @brief The ConstraintTable class is a columnar view of VFI constraints. The numeric fields of
+ *        each VFI type are stored in contiguous arrays (one per field), so scans and bulk updates
+ *        run over plain arrays instead of map nodes. Example:
+ *
+ *        auto table = editor.get_constraint_table();
+ *        auto rows = table.select(ConstraintTable::TYPE::ROBOT_TO_ROBOT);
+ *        table.filter(rows, ConstraintTable::COLUMN::ROBOT_INDEX_ONE, ConstraintTable::COMPARISON::EQUAL, 2);
+ *        table.filter(rows, ConstraintTable::COLUMN::SAFE_DISTANCE, ConstraintTable::COMPARISON::LESS, 0.05);
+ *        table.set(rows, ConstraintTable::COLUMN::SAFE_DISTANCE, 0.05);
+ *        editor.apply_constraint_table(table);
+ */
+class ConstraintTable
+{
+public:
+    enum class TYPE{
+        ENVIRONMENT_TO_ROBOT,
+        ROBOT_TO_ROBOT
+    };
+
+    enum class COLUMN{
+        SAFE_DISTANCE,
+        VFI_GAIN,
+        ROBOT_INDEX,     // ENVIRONMENT_TO_ROBOT only
+        JOINT_INDEX,     // ENVIRONMENT_TO_ROBOT only
+        ROBOT_INDEX_ONE, // ROBOT_TO_ROBOT only
+        ROBOT_INDEX_TWO, // ROBOT_TO_ROBOT only
+        JOINT_INDEX_ONE, // ROBOT_TO_ROBOT only
+        JOINT_INDEX_TWO  // ROBOT_TO_ROBOT only
+    };
+
+    enum class COMPARISON{
+        EQUAL,
+        NOT_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL
+    };
+
+    /**
+     * @brief The ENVIRONMENT_TO_ROBOT_COLUMNS struct holds the ENVIRONMENT_TO_ROBOT rows.
+     *        The modified column flags the rows changed by set() or scale().
+     */
+    struct ENVIRONMENT_TO_ROBOT_COLUMNS{
+        std::vector<std::string> tag;
+        std::vector<double> safe_distance;
+        std::vector<double> vfi_gain;
+        std::vector<int> robot_index;
+        std::vector<int> joint_index;
+        std::vector<std::uint8_t> modified;
+    };
+
+    /**
+     * @brief The ROBOT_TO_ROBOT_COLUMNS struct holds the ROBOT_TO_ROBOT rows.
+     *        The modified column flags the rows changed by set() or scale().
+     */
+    struct ROBOT_TO_ROBOT_COLUMNS{
+        std::vector<std::string> tag;
+        std::vector<double> safe_distance;
+        std::vector<double> vfi_gain;
+        std::vector<int> robot_index_one;
+        std::vector<int> robot_index_two;
+        std::vector<int> joint_index_one;
+        std::vector<int> joint_index_two;
+        std::vector<std::uint8_t> modified;
+    };
+
+    /**
+     * @brief The SELECTION struct is a set of rows of one VFI type. mask[i] is 1 if the row i
+     *        is selected, and 0 otherwise.
+     */
+    struct SELECTION{
+        TYPE type;
+        std::vector<std::uint8_t> mask;
+    };
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_;
+public:
+    ConstraintTable();
+    explicit ConstraintTable(const std::vector<VFIConfigurationFile::Data>& data);
+
+    void add(const VFIConfigurationFile::Data& data);
+    std::size_t size(const TYPE& type) const;
+    const ENVIRONMENT_TO_ROBOT_COLUMNS& get_environment_to_robot_columns() const;
+    const ROBOT_TO_ROBOT_COLUMNS& get_robot_to_robot_columns() const;
+
+    SELECTION select(const TYPE& type) const;
+    void filter(SELECTION& selection, const COLUMN& column, const COMPARISON& comparison, const double& value) const;
+    std::size_t count(const SELECTION& selection) const;
+    std::vector<std::string> get_tags(const SELECTION& selection) const;
+
+    void set(const SELECTION& selection, const COLUMN& column, const double& value);
+    void scale(const SELECTION& selection, const COLUMN& column, const double& factor);
+};
+}
@@ -0,0 +1,95 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+
+namespace DQ_robotics_extensions
+{
+/**
+ * @brief The ConstraintValidator class checks the consistency of VFI constraints with a set of
+ *        rules. The constraints are split in chunks, which are checked on several threads, and
+ *        the diagnostics are returned in the order of the constraints. The built-in rules are:
+ *
+ *        "indices":       the robot and joint indices are not below the first index given
+ *                         zero_indexed, nor above the limits set by set_number_of_joints.
+ *        "entity_lists":  each cs_entity_* list has the length its primitive type needs (one
+ *                         entity, or a line and its two endpoints for LINESEGMENT).
+ *        "types":         vfi_type matches the configuration, and direction is known.
+ *        "gains":         safe_distance and vfi_gain are positive.
+ *
+ *        Example:
+ *
+ *        ConstraintValidator validator(zero_indexed);
+ *        validator.add_rule("small_distance", [](const VFIConfigurationFile::Data& data, const auto& report) {
+ *            if (std::visit([](auto&& arg) { return arg.safe_distance < 0.001; }, data))
+ *                report(ConstraintValidator::SEVERITY::WARNING, "safe_distance is below 1 mm");
+ *        });
+ *        for (const auto& diagnostic : validator.validate(data))
+ *            std::cerr << diagnostic.tag << ": " << diagnostic.message << std::endl;
+ */
+class ConstraintValidator
+{
+public:
+    enum class SEVERITY{
+        WARNING,
+        ERROR
+    };
+
+    /**
+     * @brief The DIAGNOSTIC struct is a problem found by a rule in a constraint.
+     */
+    struct DIAGNOSTIC{
+        std::size_t index; // The position of the constraint in the validated data
+        std::string tag;
+        std::string rule;
+        SEVERITY severity;
+        std::string message;
+    };
+
+    // A rule reports each problem it finds in a constraint. It is called from several threads.
+    using REPORT = std::function<void(const SEVERITY& severity, const std::string& message)>;
+    using CHECK = std::function<void(const VFIConfigurationFile::Data& data, const REPORT& report)>;
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_;
+public:
+    explicit ConstraintValidator(const bool& zero_indexed);
+
+    void set_number_of_joints(const std::vector<int>& number_of_joints);
+    void set_number_of_threads(const int& number_of_threads);
+    void add_rule(const std::string& name, const CHECK& check);
+    void remove_rule(const std::string& name);
+    std::vector<std::string> get_rule_names() const;
+
+    std::vector<DIAGNOSTIC> validate(const std::vector<VFIConfigurationFile::Data>& data) const;
+    std::vector<DIAGNOSTIC> validate(const std::vector<const VFIConfigurationFile::Data*>& data) const;
+    std::vector<DIAGNOSTIC> validate(const std::vector<const VFIConfigurationFile::Data*>& data,
+                                     const bool& zero_indexed) const;
+
+    static bool has_errors(const std::vector<DIAGNOSTIC>& diagnostics);
+};
+}
@@ -0,0 +1,56 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+
+namespace DQ_robotics_extensions
+{
+/**
+ * @brief The DuplicateDetector class finds the constraints that constrain the same entities in the
+ *        same way under different tags. Two constraints are duplicates if they are equal once the
+ *        tag, safe_distance and vfi_gain are ignored, and the two sides of a ROBOT_TO_ROBOT
+ *        constraint (entities, primitive type, robot and joint indices) are taken in any order.
+ *        The constraints are grouped by the hash of this canonical form, in O(n).
+ */
+class DuplicateDetector
+{
+public:
+    /**
+     * @brief The GROUP struct is a set of duplicate constraints.
+     */
+    struct GROUP{
+        std::vector<std::size_t> indices; // The positions of the constraints, in order. A merge keeps the first one.
+        std::vector<std::string> tags;
+        double safe_distance;             // The strictest safe_distance of the group (see strictest_safe_distance)
+        bool conflicting;                 // True if the safe_distance or the vfi_gain values differ
+    };
+
+    static std::size_t canonical_hash(const VFIConfigurationFile::Data& data);
+    static bool is_duplicate(const VFIConfigurationFile::Data& data, const VFIConfigurationFile::Data& other);
+    static double strictest_safe_distance(const VFIConfigurationFile::Data& data, const VFIConfigurationFile::Data& other);
+
+    static std::vector<GROUP> find_duplicates(const std::vector<VFIConfigurationFile::Data>& data);
+    static std::vector<GROUP> find_duplicates(const std::vector<const VFIConfigurationFile::Data*>& data);
+};
+}
@@ -0,0 +1,485 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The OrderedHashMap class is a hash map that keeps its elements in insertion order.
+ *        The elements are stored in a dense vector, and an open-addressing table (linear probing,
+ *        backward-shift deletion) maps the keys to their positions in the vector. Lookups are O(1)
+ *        on average, and the iteration walks the vector in insertion order.
+ *        An erased element leaves a hole in the vector, so the order of the other elements is
+ *        kept. The holes are removed when they outnumber the elements.
+ *        Each element has an order key, which increases with the insertion order and survives the
+ *        removal of the holes, so an erased element can be inserted back at its place.
+ *        The keys must only be modified with rename(). Inserting or erasing elements invalidates
+ *        the iterators and the references to the elements.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class OrderedHashMap
+{
+public:
+    using value_type = std::pair<Key, Value>;
+
+private:
+    static constexpr std::uint32_t empty_slot_ = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t minimum_capacity_ = 16;
+
+    /**
+     * @brief The SLOT struct is an element of the open-addressing table. It stores the position
+     *        of the element in the vector, and a fragment of its hash to skip most key comparisons.
+     */
+    struct SLOT{
+        std::uint32_t index = empty_slot_;
+        std::uint32_t hash = 0;
+    };
+
+    struct NODE{
+        std::uint32_t hash;
+        std::uint64_t order; // Increases along the vector
+        std::optional<value_type> value; // Empty for an erased element
+    };
+
+    std::vector<NODE> nodes_;
+    std::vector<SLOT> slots_;
+    std::size_t size_ = 0;
+    std::size_t compactions_ = 0;
+    std::uint64_t next_order_ = 0;
+    Hash hasher_;
+    KeyEqual key_equal_;
+
+    std::uint32_t _hash(const Key& key) const
+    {
+        const std::uint64_t hash = hasher_(key);
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    std::size_t _mask() const
+    {
+        return slots_.size() - 1;
+    }
+
+    /**
+     * @brief _find_slot finds the slot of a key.
+     * @return The position of the slot in the table, or the size of the table if the key is not found.
+     */
+    std::size_t _find_slot(const Key& key, const std::uint32_t& hash) const
+    {
+        if (slots_.empty())
+            return 0;
+        for (std::size_t i = hash & _mask();; i = (i + 1) & _mask())
+        {
+            const SLOT& slot = slots_[i];
+            if (slot.index == empty_slot_)
+                return slots_.size();
+            if (slot.hash == hash && key_equal_(nodes_[slot.index].value->first, key))
+                return i;
+        }
+    }
+
+    void _insert_slot(const std::uint32_t& index, const std::uint32_t& hash)
+    {
+        std::size_t i = hash & _mask();
+        while (slots_[i].index != empty_slot_)
+            i = (i + 1) & _mask();
+        slots_[i] = SLOT{index, hash};
+    }
+
+    /**
+     * @brief _erase_slot empties a slot, and moves the following slots of the probe sequence back,
+     *        so that the lookups never need tombstones.
+     */
+    void _erase_slot(std::size_t i)
+    {
+        for (std::size_t j = (i + 1) & _mask();; j = (j + 1) & _mask())
+        {
+            if (slots_[j].index == empty_slot_)
+                break;
+            const std::size_t home = slots_[j].hash & _mask();
+            if (((j - home) & _mask()) >= ((j - i) & _mask()))
+            {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = SLOT{};
+    }
+
+    /**
+     * @brief _rebuild removes the holes of the vector and rebuilds the table with the requested capacity.
+     */
+    void _rebuild(const std::size_t& capacity)
+    {
+        if (nodes_.size() != size_)
+        {
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < nodes_.size(); ++i)
+            {
+                if (!nodes_[i].value)
+                    continue;
+                if (i != next)
+                {
+                    nodes_[next].hash = nodes_[i].hash;
+                    nodes_[next].order = nodes_[i].order;
+                    nodes_[next].value = std::move(nodes_[i].value);
+                }
+                ++next;
+            }
+            nodes_.resize(next);
+            ++compactions_;
+        }
+        slots_.assign(capacity, SLOT{});
+        for (std::size_t i = 0; i < nodes_.size(); ++i)
+            _insert_slot(static_cast<std::uint32_t>(i), nodes_[i].hash);
+    }
+
+    /**
+     * @brief _emplace_node constructs an element in a node of the vector and adds it to the table.
+     *        The node is inserted at the position, unless it is a hole with the order key of the
+     *        element. Inserting before the end moves the following elements, which counts as a
+     *        compaction.
+     * @return The position of the element.
+     */
+    template<typename... Args>
+    std::size_t _emplace_node(const std::size_t& position, const std::uint32_t& hash, const std::uint64_t& order,
+                              const Key& key, Args&&... args)
+    {
+        const bool hole = position < nodes_.size() && nodes_[position].order == order && !nodes_[position].value;
+        if (!hole)
+        {
+            if (nodes_.size() >= empty_slot_)
+                throw std::length_error("OrderedHashMap: too many elements");
+            nodes_.insert(nodes_.begin() + position, NODE{hash, order, std::nullopt});
+            if (position + 1 < nodes_.size())
+            {
+                for (SLOT& slot : slots_)
+                    if (slot.index != empty_slot_ && slot.index >= position)
+                        ++slot.index;
+                ++compactions_;
+            }
+        }
+        nodes_[position].hash = hash;
+        nodes_[position].value.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                       std::forward_as_tuple(std::forward<Args>(args)...));
+        _insert_slot(static_cast<std::uint32_t>(position), hash);
+        ++size_;
+        return position;
+    }
+
+    /**
+     * @brief _capacity_for gets the smallest power of two that holds the elements with a load
+     *        factor of at most 3/4.
+     */
+    static std::size_t _capacity_for(const std::size_t& size)
+    {
+        std::size_t capacity = minimum_capacity_;
+        while (capacity - capacity / 4 < size)
+            capacity *= 2;
+        return capacity;
+    }
+
+    template<typename NodePointer, typename Reference>
+    class Iterator
+    {
+        friend class OrderedHashMap;
+        NodePointer node_;
+        NodePointer end_;
+
+        void _skip_holes()
+        {
+            while (node_ != end_ && !node_->value)
+                ++node_;
+        }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = OrderedHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::remove_reference_t<Reference>*;
+        using reference = Reference;
+
+        Iterator() = default;
+        Iterator(NodePointer node, NodePointer end)
+            : node_(node), end_(end)
+        {
+            _skip_holes();
+        }
+
+        template<typename OtherNodePointer, typename OtherReference>
+        Iterator(const Iterator<OtherNodePointer, OtherReference>& other)
+            : node_(other.node_), end_(other.end_)
+        {
+        }
+
+        reference operator*() const { return *node_->value; }
+        pointer operator->() const { return &*node_->value; }
+
+        Iterator& operator++()
+        {
+            ++node_;
+            _skip_holes();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const Iterator& other) const { return node_ == other.node_; }
+        bool operator!=(const Iterator& other) const { return node_ != other.node_; }
+
+        template<typename, typename>
+        friend class Iterator;
+    };
+
+public:
+    using iterator = Iterator<NODE*, value_type&>;
+    using const_iterator = Iterator<const NODE*, const value_type&>;
+
+    OrderedHashMap() = default;
+
+    iterator begin() { return iterator(nodes_.data(), nodes_.data() + nodes_.size()); }
+    iterator end() { return iterator(nodes_.data() + nodes_.size(), nodes_.data() + nodes_.size()); }
+    const_iterator begin() const { return const_iterator(nodes_.data(), nodes_.data() + nodes_.size()); }
+    const_iterator end() const { return const_iterator(nodes_.data() + nodes_.size(), nodes_.data() + nodes_.size()); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief position_end gets one past the last position of the dense vector. The positions
+     *        follow the insertion order, and are valid until the next compaction.
+     * @return The desired position.
+     */
+    std::size_t position_end() const { return nodes_.size(); }
+
+    /**
+     * @brief compactions counts the times the holes of the dense vector were removed, which
+     *        moves the elements to other positions.
+     * @return The number of compactions.
+     */
+    std::size_t compactions() const { return compactions_; }
+
+    /**
+     * @brief order_at gets the order key of the element at a position of the dense vector. The key
+     *        stays valid after the compactions, and until the map is cleared.
+     * @param position The position, which must be smaller than position_end().
+     * @return The desired order key.
+     */
+    std::uint64_t order_at(const std::size_t& position) const { return nodes_[position].order; }
+
+    /**
+     * @brief at_position gets the element at a position of the dense vector.
+     * @param position The position, which must be smaller than position_end().
+     * @return A pointer to the element, or nullptr if the element at the position was erased.
+     */
+    value_type* at_position(const std::size_t& position)
+    {
+        auto& value = nodes_[position].value;
+        return value ? &*value : nullptr;
+    }
+
+    const value_type* at_position(const std::size_t& position) const
+    {
+        const auto& value = nodes_[position].value;
+        return value ? &*value : nullptr;
+    }
+
+    /**
+     * @brief reserve allocates the memory for the requested number of elements.
+     * @param size The number of elements.
+     */
+    void reserve(const std::size_t& size)
+    {
+        nodes_.reserve(size);
+        if (_capacity_for(size) > slots_.size())
+            _rebuild(_capacity_for(size));
+    }
+
+    void clear()
+    {
+        if (!nodes_.empty())
+            ++compactions_;
+        nodes_.clear();
+        slots_.clear();
+        size_ = 0;
+    }
+
+    iterator find(const Key& key)
+    {
+        const std::size_t slot = _find_slot(key, _hash(key));
+        if (slot >= slots_.size())
+            return end();
+        return iterator(nodes_.data() + slots_[slot].index, nodes_.data() + nodes_.size());
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        const std::size_t slot = _find_slot(key, _hash(key));
+        if (slot >= slots_.size())
+            return end();
+        return const_iterator(nodes_.data() + slots_[slot].index, nodes_.data() + nodes_.size());
+    }
+
+    bool contains(const Key& key) const
+    {
+        return _find_slot(key, _hash(key)) < slots_.size();
+    }
+
+    Value& at(const Key& key)
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("OrderedHashMap::at: key not found");
+        return it->second;
+    }
+
+    const Value& at(const Key& key) const
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("OrderedHashMap::at: key not found");
+        return it->second;
+    }
+
+    /**
+     * @brief try_emplace inserts an element at the end of the map, if the key is not in the map.
+     * @param key The key.
+     * @param args The arguments to construct the value.
+     * @return An iterator to the element with the key, and true if the element was inserted.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const std::uint32_t hash = _hash(key);
+        const std::size_t slot = _find_slot(key, hash);
+        if (slot < slots_.size())
+            return {iterator(nodes_.data() + slots_[slot].index, nodes_.data() + nodes_.size()), false};
+
+        if (_capacity_for(size_ + 1) > slots_.size())
+            _rebuild(_capacity_for(size_ + 1));
+        const std::size_t index = _emplace_node(nodes_.size(), hash, next_order_++, key, std::forward<Args>(args)...);
+        return {iterator(nodes_.data() + index, nodes_.data() + nodes_.size()), true};
+    }
+
+    /**
+     * @brief try_emplace_ordered inserts an element at the place of an order key, so an erased
+     *        element takes its place in the order back. The element fills its hole if the hole was
+     *        not removed. Otherwise, it is inserted between the elements with the closest keys,
+     *        which is O(n) and counts as a compaction.
+     * @param order The order key, given by order_at() before the element was erased.
+     * @param key The key.
+     * @param args The arguments to construct the value.
+     * @return The position of the element with the key, and true if the element was inserted.
+     */
+    template<typename... Args>
+    std::pair<std::size_t, bool> try_emplace_ordered(const std::uint64_t& order, const Key& key, Args&&... args)
+    {
+        const std::uint32_t hash = _hash(key);
+        const std::size_t slot = _find_slot(key, hash);
+        if (slot < slots_.size())
+            return {slots_[slot].index, false};
+        if (order >= next_order_)
+            throw std::out_of_range("OrderedHashMap::try_emplace_ordered: order key not given by the map");
+        if (_capacity_for(size_ + 1) > slots_.size())
+            _rebuild(_capacity_for(size_ + 1));
+        const auto node = std::lower_bound(nodes_.begin(), nodes_.end(), order,
+                                           [](const NODE& node, const std::uint64_t& order) { return node.order < order; });
+        return {_emplace_node(static_cast<std::size_t>(node - nodes_.begin()), hash, order, key, std::forward<Args>(args)...), true};
+    }
+
+    /**
+     * @brief insert_or_assign assigns the value of an element, or inserts the element at the end
+     *        of the map if the key is not in the map. An assigned element keeps its position.
+     * @param key The key.
+     * @param value The value.
+     * @return An iterator to the element, and true if the element was inserted.
+     */
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+    {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second)
+            result.first->second = std::forward<V>(value);
+        return result;
+    }
+
+    /**
+     * @brief erase removes an element. The order of the other elements is kept.
+     * @param key The key of the element.
+     * @return The number of elements removed (zero or one).
+     */
+    std::size_t erase(const Key& key)
+    {
+        const std::size_t slot = _find_slot(key, _hash(key));
+        if (slot >= slots_.size())
+            return 0;
+        nodes_[slots_[slot].index].value.reset();
+        _erase_slot(slot);
+        --size_;
+        if (size_ == 0)
+            clear();
+        else if (nodes_.size() - size_ > size_ && nodes_.size() > minimum_capacity_)
+            _rebuild(_capacity_for(size_));
+        return 1;
+    }
+
+    /**
+     * @brief rename changes the key of an element. The element keeps its position and its address.
+     * @param key The current key.
+     * @param new_key The new key.
+     * @return True if the element was renamed. False if the key is not in the map, or the new key
+     *         is used by another element.
+     */
+    bool rename(const Key& key, const Key& new_key)
+    {
+        const std::size_t slot = _find_slot(key, _hash(key));
+        if (slot >= slots_.size())
+            return false;
+        if (key_equal_(key, new_key))
+            return true;
+        const std::uint32_t new_hash = _hash(new_key);
+        if (_find_slot(new_key, new_hash) < slots_.size())
+            return false;
+        const std::uint32_t index = slots_[slot].index;
+        _erase_slot(slot);
+        nodes_[index].hash = new_hash;
+        nodes_[index].value->first = new_key;
+        _insert_slot(index, new_hash);
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,397 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The PersistentHashMap class is a hash map whose copies share their elements. It is a
+ *        hash array mapped trie: each node uses 5 bits of the hash of the keys, and stores the
+ *        elements and the child nodes of its 32 fragments in two compact arrays. Copying a
+ *        PersistentHashMap is O(1), and modifying it copies only the path to the modified
+ *        element, so the copies are never affected. The nodes are immutable, and a
+ *        PersistentHashMap can be read from several threads while a copy of it is modified.
+ *        The iteration order depends on the hashes of the keys.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class PersistentHashMap
+{
+public:
+    using value_type = std::pair<Key, Value>;
+
+private:
+    static constexpr std::size_t bits_ = 5;
+    static constexpr std::size_t hash_bits_ = std::numeric_limits<std::size_t>::digits;
+
+    /**
+     * @brief The NODE struct is a node of the trie. The nodes below the last bits of the hash are
+     *        collision nodes, which only store the elements whose keys have the same hash.
+     */
+    struct NODE{
+        std::uint32_t data_map = 0; // The fragments of the elements
+        std::uint32_t node_map = 0; // The fragments of the child nodes
+        std::vector<value_type> data; // In fragment order
+        std::vector<std::shared_ptr<const NODE>> nodes; // In fragment order
+    };
+
+    /**
+     * @brief The ITEM struct is an element with its hash, used to build the trie at once.
+     */
+    struct ITEM{
+        std::size_t hash;
+        value_type value;
+    };
+
+    std::shared_ptr<const NODE> root_;
+    std::size_t size_ = 0;
+    Hash hasher_;
+    KeyEqual key_equal_;
+
+    static std::uint32_t _bit(const std::size_t& hash, const std::size_t& shift)
+    {
+        return std::uint32_t(1) << ((hash >> shift) & 31);
+    }
+
+    static std::size_t _index(const std::uint32_t& map, const std::uint32_t& bit)
+    {
+        return std::bitset<32>(map & (bit - 1)).count();
+    }
+
+    /**
+     * @brief _merge makes the node that holds two elements whose hashes have the same fragments
+     *        above the shift.
+     */
+    static std::shared_ptr<const NODE> _merge(value_type&& a, const std::size_t& hash_a,
+                                              value_type&& b, const std::size_t& hash_b, const std::size_t& shift)
+    {
+        auto node = std::make_shared<NODE>();
+        if (shift >= hash_bits_)
+        {
+            node->data.push_back(std::move(a));
+            node->data.push_back(std::move(b));
+            return node;
+        }
+        const std::uint32_t bit_a = _bit(hash_a, shift);
+        const std::uint32_t bit_b = _bit(hash_b, shift);
+        if (bit_a == bit_b)
+        {
+            node->node_map = bit_a;
+            node->nodes.push_back(_merge(std::move(a), hash_a, std::move(b), hash_b, shift + bits_));
+            return node;
+        }
+        node->data_map = bit_a | bit_b;
+        node->data.push_back(std::move(bit_a < bit_b ? a : b));
+        node->data.push_back(std::move(bit_a < bit_b ? b : a));
+        return node;
+    }
+
+    std::shared_ptr<const NODE> _insert(const std::shared_ptr<const NODE>& node, const std::size_t& hash,
+                                        const std::size_t& shift, const Key& key, Value&& value, bool& inserted) const
+    {
+        auto copy = node ? std::make_shared<NODE>(*node) : std::make_shared<NODE>();
+        if (shift >= hash_bits_)
+        {
+            for (auto& element : copy->data)
+            {
+                if (key_equal_(element.first, key))
+                {
+                    element.second = std::move(value);
+                    return copy;
+                }
+            }
+            copy->data.emplace_back(key, std::move(value));
+            inserted = true;
+            return copy;
+        }
+        const std::uint32_t bit = _bit(hash, shift);
+        if (copy->data_map & bit)
+        {
+            const std::size_t index = _index(copy->data_map, bit);
+            auto& element = copy->data[index];
+            if (key_equal_(element.first, key))
+            {
+                element.second = std::move(value);
+                return copy;
+            }
+            const std::size_t element_hash = hasher_(element.first);
+            auto child = _merge(std::move(element), element_hash, value_type(key, std::move(value)), hash, shift + bits_);
+            copy->data.erase(copy->data.begin() + index);
+            copy->data_map ^= bit;
+            copy->nodes.insert(copy->nodes.begin() + _index(copy->node_map, bit), std::move(child));
+            copy->node_map |= bit;
+            inserted = true;
+        }
+        else if (copy->node_map & bit)
+        {
+            auto& child = copy->nodes[_index(copy->node_map, bit)];
+            child = _insert(child, hash, shift + bits_, key, std::move(value), inserted);
+        }
+        else
+        {
+            copy->data.insert(copy->data.begin() + _index(copy->data_map, bit), value_type(key, std::move(value)));
+            copy->data_map |= bit;
+            inserted = true;
+        }
+        return copy;
+    }
+
+    /**
+     * @brief _erase copies the path to an element without the element. A child node left with a
+     *        single element is merged into its parent, so the trie stays as shallow as possible.
+     * @return The copy of the node, nullptr if it is empty, or the node itself if the key is not found.
+     */
+    std::shared_ptr<const NODE> _erase(const std::shared_ptr<const NODE>& node, const std::size_t& hash,
+                                       const std::size_t& shift, const Key& key, bool& erased) const
+    {
+        if (!node)
+            return node;
+        std::shared_ptr<NODE> copy;
+        if (shift >= hash_bits_)
+        {
+            const auto it = std::find_if(node->data.begin(), node->data.end(),
+                                         [&](const value_type& element) { return key_equal_(element.first, key); });
+            if (it == node->data.end())
+                return node;
+            copy = std::make_shared<NODE>(*node);
+            copy->data.erase(copy->data.begin() + (it - node->data.begin()));
+        }
+        else
+        {
+            const std::uint32_t bit = _bit(hash, shift);
+            if (node->data_map & bit)
+            {
+                const std::size_t index = _index(node->data_map, bit);
+                if (!key_equal_(node->data[index].first, key))
+                    return node;
+                copy = std::make_shared<NODE>(*node);
+                copy->data.erase(copy->data.begin() + index);
+                copy->data_map ^= bit;
+            }
+            else if (node->node_map & bit)
+            {
+                const std::size_t index = _index(node->node_map, bit);
+                auto child = _erase(node->nodes[index], hash, shift + bits_, key, erased);
+                if (!erased)
+                    return node;
+                copy = std::make_shared<NODE>(*node);
+                if (child && (!child->nodes.empty() || child->data.size() > 1))
+                {
+                    copy->nodes[index] = std::move(child);
+                    return copy;
+                }
+                copy->nodes.erase(copy->nodes.begin() + index);
+                copy->node_map ^= bit;
+                if (child)
+                {
+                    copy->data.insert(copy->data.begin() + _index(copy->data_map, bit), child->data.front());
+                    copy->data_map |= bit;
+                }
+                return copy;
+            }
+            else
+                return node;
+        }
+        erased = true;
+        if (copy->data.empty() && copy->nodes.empty())
+            return nullptr;
+        return copy;
+    }
+
+    /**
+     * @brief _build builds the node of the elements whose hashes have the same fragments above the
+     *        shift. The elements are sorted by their fragments at each level.
+     */
+    std::shared_ptr<const NODE> _build(typename std::vector<ITEM>::iterator first, typename std::vector<ITEM>::iterator last,
+                                       const std::size_t& shift)
+    {
+        auto node = std::make_shared<NODE>();
+        if (shift >= hash_bits_)
+        {
+            for (auto it = first; it != last; ++it)
+            {
+                const auto same_key = std::find_if(node->data.begin(), node->data.end(),
+                                                   [&](const value_type& element) { return key_equal_(element.first, it->value.first); });
+                if (same_key != node->data.end())
+                    same_key->second = std::move(it->value.second);
+                else
+                {
+                    node->data.push_back(std::move(it->value));
+                    ++size_;
+                }
+            }
+            return node;
+        }
+        const auto fragment = [&shift](const ITEM& item) { return (item.hash >> shift) & 31; };
+        std::stable_sort(first, last, [&fragment](const ITEM& a, const ITEM& b) { return fragment(a) < fragment(b); });
+        while (first != last)
+        {
+            const auto group_end = std::find_if(first, last, [&](const ITEM& item) { return fragment(item) != fragment(*first); });
+            const std::uint32_t bit = _bit(first->hash, shift);
+            auto child = (group_end - first == 1) ? nullptr : _build(first, group_end, shift + bits_);
+            if (child && (!child->nodes.empty() || child->data.size() > 1))
+            {
+                node->nodes.push_back(std::move(child));
+                node->node_map |= bit;
+            }
+            else
+            {
+                if (child)
+                    node->data.push_back(child->data.front());
+                else
+                {
+                    node->data.push_back(std::move(first->value));
+                    ++size_;
+                }
+                node->data_map |= bit;
+            }
+            first = group_end;
+        }
+        return node;
+    }
+
+    template<typename Function>
+    static void _for_each(const NODE& node, Function& function)
+    {
+        for (const auto& element : node.data)
+            function(element);
+        for (const auto& child : node.nodes)
+            _for_each(*child, function);
+    }
+
+public:
+    PersistentHashMap() = default;
+
+    /**
+     * @brief PersistentHashMap builds the trie of a set of elements at once, without copying the
+     *        paths. The last element of a repeated key is kept.
+     * @param values The elements.
+     */
+    explicit PersistentHashMap(std::vector<value_type>&& values)
+    {
+        std::vector<ITEM> items;
+        items.reserve(values.size());
+        for (auto& value : values)
+        {
+            const std::size_t hash = hasher_(value.first);
+            items.push_back(ITEM{hash, std::move(value)});
+        }
+        if (!items.empty())
+            root_ = _build(items.begin(), items.end(), 0);
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief find finds the value of a key.
+     * @param key The key.
+     * @return A pointer to the value, valid while this PersistentHashMap, or a copy of it, is not
+     *         destroyed or modified. nullptr if the key is not found.
+     */
+    const Value* find(const Key& key) const
+    {
+        const std::size_t hash = hasher_(key);
+        const NODE* node = root_.get();
+        for (std::size_t shift = 0; node; shift += bits_)
+        {
+            if (shift >= hash_bits_)
+            {
+                for (const auto& element : node->data)
+                    if (key_equal_(element.first, key))
+                        return &element.second;
+                return nullptr;
+            }
+            const std::uint32_t bit = _bit(hash, shift);
+            if (node->data_map & bit)
+            {
+                const auto& element = node->data[_index(node->data_map, bit)];
+                return key_equal_(element.first, key) ? &element.second : nullptr;
+            }
+            if (!(node->node_map & bit))
+                return nullptr;
+            node = node->nodes[_index(node->node_map, bit)].get();
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief insert_or_assign assigns the value of a key, or inserts the key. Only the path to the
+     *        element is copied.
+     * @param key The key.
+     * @param value The value.
+     * @return True if the key was inserted.
+     */
+    bool insert_or_assign(const Key& key, Value value)
+    {
+        bool inserted = false;
+        root_ = _insert(root_, hasher_(key), 0, key, std::move(value), inserted);
+        size_ += inserted ? 1 : 0;
+        return inserted;
+    }
+
+    /**
+     * @brief erase removes a key. Only the path to the element is copied.
+     * @param key The key.
+     * @return The number of elements removed (zero or one).
+     */
+    std::size_t erase(const Key& key)
+    {
+        bool erased = false;
+        root_ = _erase(root_, hasher_(key), 0, key, erased);
+        size_ -= erased ? 1 : 0;
+        return erased ? 1 : 0;
+    }
+
+    /**
+     * @brief for_each calls a function with each element.
+     * @param function The function, called as function(element).
+     */
+    template<typename Function>
+    void for_each(Function&& function) const
+    {
+        if (root_)
+            _for_each(*root_, function);
+    }
+};
+
+}
@@ -0,0 +1,197 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The PersistentVector class is a vector whose copies share their elements. The elements
+ *        are stored in the leaves of a trie with 32 children per node. Copying a PersistentVector
+ *        is O(1), and modifying it copies only the path to the modified element, so the copies
+ *        are never affected. The nodes are immutable, and a PersistentVector can be read from
+ *        several threads while a copy of it is modified.
+ *        The elements that were never set have the value T{}.
+ */
+template<typename T>
+class PersistentVector
+{
+private:
+    static constexpr std::size_t bits_ = 5;
+    static constexpr std::size_t width_ = std::size_t(1) << bits_;
+    static constexpr std::size_t mask_ = width_ - 1;
+
+    struct LEAF{
+        std::array<T, width_> values{};
+    };
+
+    struct BRANCH{
+        std::array<std::shared_ptr<const void>, width_> children{};
+    };
+
+    std::shared_ptr<const void> root_; // A LEAF if shift_ is zero, a BRANCH otherwise
+    std::size_t size_ = 0;
+    std::size_t shift_ = 0; // The bits of the index used by the levels below the root
+
+    /**
+     * @brief _set copies the path to an element, and sets the element in the copy.
+     * @return The copy of the node.
+     */
+    static std::shared_ptr<const void> _set(const std::shared_ptr<const void>& node, const std::size_t& shift,
+                                            const std::size_t& index, T&& value)
+    {
+        if (shift == 0)
+        {
+            auto leaf = node ? std::make_shared<LEAF>(*static_cast<const LEAF*>(node.get()))
+                             : std::make_shared<LEAF>();
+            leaf->values[index & mask_] = std::move(value);
+            return leaf;
+        }
+        auto branch = node ? std::make_shared<BRANCH>(*static_cast<const BRANCH*>(node.get()))
+                           : std::make_shared<BRANCH>();
+        auto& child = branch->children[(index >> shift) & mask_];
+        child = _set(child, shift - bits_, index, std::move(value));
+        return branch;
+    }
+
+    template<typename Function>
+    static void _for_each(const void* node, const std::size_t& shift, std::size_t first,
+                          const std::size_t& size, Function& function)
+    {
+        const std::size_t span = std::size_t(1) << shift;
+        for (std::size_t i = 0; i < width_ && first < size; ++i, first += span)
+        {
+            if (shift == 0)
+                function(node ? static_cast<const LEAF*>(node)->values[i] : _empty());
+            else
+                _for_each(node ? static_cast<const BRANCH*>(node)->children[i].get() : nullptr,
+                          shift - bits_, first, size, function);
+        }
+    }
+
+    static const T& _empty()
+    {
+        static const T empty{};
+        return empty;
+    }
+
+public:
+    PersistentVector() = default;
+
+    /**
+     * @brief PersistentVector builds the trie of a vector at once, without copying the paths.
+     * @param values The elements.
+     */
+    explicit PersistentVector(std::vector<T>&& values)
+        : size_(values.size())
+    {
+        std::vector<std::shared_ptr<const void>> level;
+        for (std::size_t i = 0; i < values.size(); i += width_)
+        {
+            auto leaf = std::make_shared<LEAF>();
+            for (std::size_t j = 0; j < width_ && i + j < values.size(); ++j)
+                leaf->values[j] = std::move(values[i + j]);
+            level.push_back(std::move(leaf));
+        }
+        while (level.size() > 1)
+        {
+            std::vector<std::shared_ptr<const void>> parents;
+            for (std::size_t i = 0; i < level.size(); i += width_)
+            {
+                auto branch = std::make_shared<BRANCH>();
+                for (std::size_t j = 0; j < width_ && i + j < level.size(); ++j)
+                    branch->children[j] = std::move(level[i + j]);
+                parents.push_back(std::move(branch));
+            }
+            level = std::move(parents);
+            shift_ += bits_;
+        }
+        if (!level.empty())
+            root_ = std::move(level.front());
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief get gets an element.
+     * @param index The index of the element, which must be smaller than size().
+     * @return A reference to the element, valid while this PersistentVector, or a copy of it,
+     *         is not destroyed or modified.
+     */
+    const T& get(const std::size_t& index) const
+    {
+        if (index >= size_)
+            throw std::out_of_range("PersistentVector::get: index out of range");
+        const void* node = root_.get();
+        for (std::size_t shift = shift_; shift > 0 && node; shift -= bits_)
+            node = static_cast<const BRANCH*>(node)->children[(index >> shift) & mask_].get();
+        return node ? static_cast<const LEAF*>(node)->values[index & mask_] : _empty();
+    }
+
+    /**
+     * @brief set sets an element. The vector grows if the index is not smaller than size().
+     *        Only the path to the element is copied.
+     * @param index The index of the element.
+     * @param value The value.
+     */
+    void set(const std::size_t& index, T value)
+    {
+        while (index >= (width_ << shift_))
+        {
+            if (root_)
+            {
+                auto branch = std::make_shared<BRANCH>();
+                branch->children[0] = std::move(root_);
+                root_ = std::move(branch);
+            }
+            shift_ += bits_;
+        }
+        root_ = _set(root_, shift_, index, std::move(value));
+        if (index >= size_)
+            size_ = index + 1;
+    }
+
+    /**
+     * @brief for_each calls a function with each element, in index order.
+     * @param function The function, called as function(element).
+     */
+    template<typename Function>
+    void for_each(Function&& function) const
+    {
+        _for_each(root_.get(), shift_, 0, size_, function);
+    }
+};
+
+}
@@ -22,37 +22,303 @@
 */
 
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 #include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_table.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_query.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_validator.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/duplicate_detector.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/tag_view.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_field_table.hpp>
 
 
 namespace DQ_robotics_extensions
 {
 
+/**
+ * @brief The ConstraintId class is a handle to a constraint of a RobotConstraintEditor. It is
+ *        resolved without any string lookup, and stays valid when the constraint is renamed or
+ *        the other constraints are modified. It becomes invalid when the constraint is removed.
+ */
+class ConstraintId
+{
+private:
+    friend class RobotConstraintEditor;
+    std::uint32_t index_ = 0;
+    std::uint32_t generation_ = 0; // Zero for the default (invalid) handle
+
+    ConstraintId(const std::uint32_t& index, const std::uint32_t& generation)
+        : index_(index), generation_(generation)
+    {
+    }
+public:
+    ConstraintId() = default;
+
+    bool operator==(const ConstraintId& other) const
+    {
+        return index_ == other.index_ && generation_ == other.generation_;
+    }
+
+    bool operator!=(const ConstraintId& other) const
+    {
+        return !(*this == other);
+    }
+};
+
 class RobotConstraintEditor
 {
 private:
     class Impl;
     std::shared_ptr<Impl> impl_;
 
+    VFIConfigurationFile::Data& _begin_edit(const ConstraintId& id, const FIELD& field);
+    void _end_edit(const ConstraintId& id, const bool& modified, const FIELD& field);
+    bool _replay(const bool& redo);
+    void _revert_pending(const bool& undo_mode);
+    void _set_field(const ConstraintId& id, const FIELD& field, const FIELD_VALUE& value);
+
 public:
+    /**
+     * @brief The DataView class is a read-only range over the constraints of the editor, in file
+     *        order. The constraints are not copied, and the lazy entries are decoded when they are
+     *        reached. The view is invalidated by the next modification of the editor.
+     */
+    class DataView
+    {
+    public:
+        class const_iterator
+        {
+            friend class DataView;
+            Impl* impl_ = nullptr;
+            std::size_t position_ = 0;
+            const_iterator(Impl* impl, const std::size_t& position);
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = VFIConfigurationFile::Data;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const VFIConfigurationFile::Data*;
+            using reference = const VFIConfigurationFile::Data&;
+
+            const_iterator() = default;
+            reference operator*() const;
+            pointer operator->() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            bool operator==(const const_iterator& other) const { return position_ == other.position_; }
+            bool operator!=(const const_iterator& other) const { return position_ != other.position_; }
+        };
+
+    private:
+        friend class RobotConstraintEditor;
+        Impl* impl_;
+        explicit DataView(Impl* impl);
+    public:
+        const_iterator begin() const;
+        const_iterator end() const;
+        std::size_t size() const;
+        bool empty() const;
+    };
+
+    /**
+     * @brief The Snapshot class is an immutable version of the constraints of the editor (see
+     *        get_snapshot). A snapshot can be read from any thread, and does not change when the
+     *        editor is modified. Copying a snapshot is O(1).
+     */
+    class Snapshot
+    {
+    public:
+        struct State;
+    private:
+        friend class RobotConstraintEditor;
+        std::shared_ptr<const State> state_;
+        explicit Snapshot(const std::shared_ptr<const State>& state);
+        void _for_each(const std::function<void(const VFIConfigurationFile::Data&)>& function) const;
+    public:
+        Snapshot() = default;
+
+        std::size_t size() const;
+        bool empty() const;
+        bool contains(const std::string& tag) const;
+        const VFIConfigurationFile::Data* find(const std::string& tag) const;
+        const VFIConfigurationFile::Data& get_data(const std::string& tag) const;
+        std::vector<VFIConfigurationFile::Data> get_data() const;
+
+        /**
+         * @brief for_each calls a visitor with each constraint of the snapshot, in file order.
+         * @param visitor The visitor, called as in std::visit.
+         */
+        template<typename Visitor>
+        void for_each(Visitor&& visitor) const
+        {
+            _for_each([&visitor](const VFIConfigurationFile::Data& data) { std::visit(visitor, data); });
+        }
+    };
+
+    /**
+     * @brief The Transaction class stages modifications of the editor, which commit() validates
+     *        together and then applies as a single modification: either all of them are applied,
+     *        or none is. A transaction is obtained with begin(), and must not outlive its editor.
+     */
+    class Transaction
+    {
+    public:
+        /**
+         * @brief The OPERATION struct is a staged modification. The errors found while staging
+         *        it are reported by commit().
+         */
+        struct OPERATION{
+            enum class TYPE{
+                ADD,
+                REMOVE,
+                EDIT
+            };
+            TYPE type;
+            std::string tag; // The tag of the removed or edited constraint
+            std::optional<VFIConfigurationFile::Data> data = std::nullopt; // The added constraint
+            std::optional<FIELD> field = std::nullopt;
+            FIELD_VALUE value;
+            std::string error;
+        };
+
+    private:
+        friend class RobotConstraintEditor;
+        RobotConstraintEditor* editor_;
+        std::vector<OPERATION> operations_;
+        explicit Transaction(RobotConstraintEditor* editor);
+    public:
+        void add_data(const VFIConfigurationFile::Data& data);
+        void add_data(VFIConfigurationFile::Data&& data);
+        void remove_data(const std::string& tag);
+        void replace_data(const std::string& tag, const VFIConfigurationFile::Data& data);
+        template<typename T>
+        void edit_data(const std::string& tag, const std::string& key, const T& value);
+
+        /**
+         * @brief edit stages the modification of a field, e.g. edit<FIELD::SAFE_DISTANCE>(tag, 0.1).
+         * @param tag The tag of the constraint, as it is when the previous operations are applied.
+         * @param value The new value of the field.
+         */
+        template<FIELD Field>
+        void edit(const std::string& tag, const field_type_t<Field>& value)
+        {
+            operations_.push_back(OPERATION{OPERATION::TYPE::EDIT, tag, std::nullopt, Field, FIELD_VALUE(value), {}});
+        }
+
+        std::size_t size() const;
+        bool empty() const;
+        void commit();
+        void rollback();
+    };
+
     RobotConstraintEditor(const std::shared_ptr<VFIConfigurationFile>& interface);
 
+    void set_lazy_loading(const bool& lazy_loading);
+    void set_journal_mode(const bool& journal_mode);
+    void set_journal_compaction_threshold(const std::size_t& threshold);
+    void set_arena_mode(const VFIConfigurationFile::ARENA_MODE& arena_mode);
+    void set_concurrent_mode(const bool& concurrent_mode);
+    Snapshot get_snapshot() const;
+    void set_undo_mode(const bool& undo_mode);
+    void set_undo_memory_limit(const std::size_t& bytes);
+    void set_undo_coalescing_window(const std::chrono::milliseconds& window);
+    bool undo();
+    bool redo();
+    bool can_undo() const;
+    bool can_redo() const;
+    void clear_undo_history();
+    Transaction begin();
     void load_data(const std::string& config_file);
     void add_data(const std::vector<VFIConfigurationFile::Data>& vector_data);
-    void add_data(const VFIConfigurationFile::Data& data);
+    ConstraintId add_data(const VFIConfigurationFile::Data& data);
+    ConstraintId add_data(VFIConfigurationFile::Data&& data);
     void remove_data(const std::string& tag);
+    void remove_data(const ConstraintId& id);
     void replace_data(const std::string& tag, const VFIConfigurationFile::Data& data);
-    void save_data(const std::string& path_config_file,
+    bool save_data(const std::string& path_config_file,
                    const int& vfi_file_version,
                    const bool& zero_indexed);
+    void set_validator(const std::shared_ptr<ConstraintValidator>& validator);
+    std::vector<ConstraintValidator::DIAGNOSTIC> validate(const ConstraintValidator& validator);
+    std::vector<DuplicateDetector::GROUP> find_duplicates();
+    std::size_t merge_duplicates();
 
 
     template<typename T>
     void edit_data(const std::string& tag, const std::string& key, const T& value);
+    template<typename T>
+    void edit_data(const ConstraintId& id, const std::string& key, const T& value);
+
+    /**
+     * @brief edit modifies a field of the specified data. The field and its type are resolved at
+     *        compile time, e.g. edit<FIELD::SAFE_DISTANCE>(id, 0.1).
+     * @param id The handle of the data to be edited.
+     * @param value The new value of the field.
+     */
+    template<FIELD Field>
+    void edit(const ConstraintId& id, const field_type_t<Field>& value)
+    {
+        if constexpr (Field == FIELD::TAG)
+        {
+            edit_data(id, std::string(field_names[static_cast<std::size_t>(Field)]), value);
+        }
+        else
+        {
+            bool modified = false;
+            std::visit([&](auto&& arg) {
+                using DataType = std::decay_t<decltype(arg)>;
+                if constexpr (has_field_v<DataType, Field>)
+                {
+                    arg.*field_descriptor_t<DataType, Field>::member = value;
+                    modified = true;
+                }
+            }, _begin_edit(id, Field));
+            _end_edit(id, modified, Field);
+        }
+    }
+
+    template<FIELD Field>
+    void edit(const std::string& tag, const field_type_t<Field>& value)
+    {
+        edit<Field>(get_id(tag), value);
+    }
+
+    ConstraintId get_id(const std::string& tag) const;
+    bool is_valid(const ConstraintId& id) const;
 
 
     std::vector<VFIConfigurationFile::Data> get_data();
+    const VFIConfigurationFile::Data& get_data(const std::string& tag);
+    const VFIConfigurationFile::Data& get_data(const ConstraintId& id);
+    DataView get_data_view();
+
+    /**
+     * @brief for_each calls a visitor with each constraint, in file order, without copying it.
+     *        The visitor is called with a const ENVIRONMENT_TO_ROBOT_DATA& or a const
+     *        ROBOT_TO_ROBOT_DATA&, as in std::visit.
+     * @param visitor The visitor.
+     */
+    template<typename Visitor>
+    void for_each(Visitor&& visitor)
+    {
+        for (const auto& data : get_data_view())
+            std::visit(visitor, data);
+    }
+    ConstraintTable get_constraint_table();
+    void apply_constraint_table(const ConstraintTable& table);
+    void set_number_of_query_threads(const int& number_of_threads);
+    std::vector<std::string> select_tags(const ConstraintQuery& query);
+    std::size_t apply_query(const ConstraintQuery& query);
+
+    TagView get_tags_by_robot(const int& robot_index);
+    TagView get_tags_by_joint(const int& robot_index, const int& joint_index);
+    TagView get_tags_by_entity(const std::string& entity);
 };
 }
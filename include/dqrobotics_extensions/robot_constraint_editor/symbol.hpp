@@ -0,0 +1,141 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The VFI_TYPE enum encodes the values of vfi_type. Each value is the Symbol::id() of
+ *        the corresponding string.
+ */
+enum class VFI_TYPE : std::uint32_t{
+    ENVIRONMENT_TO_ROBOT = 1,
+    ROBOT_TO_ROBOT = 2
+};
+
+/**
+ * @brief The DIRECTION enum encodes the values of direction. Each value is the Symbol::id() of
+ *        the corresponding string.
+ */
+enum class DIRECTION : std::uint32_t{
+    SAFE_ZONE = 3,
+    RESTRICTED_ZONE = 4
+};
+
+/**
+ * @brief The PRIMITIVE_TYPE enum encodes the values of the entity primitive types. Each value is
+ *        the Symbol::id() of the corresponding string.
+ */
+enum class PRIMITIVE_TYPE : std::uint32_t{
+    POINT = 5,
+    LINE = 6,
+    PLANE = 7,
+    LINESEGMENT = 8
+};
+
+/**
+ * @brief The Symbol class is an interned string. Equal strings share a single copy in a
+ *        process-wide pool, so a Symbol costs one pointer, and two Symbols are compared by
+ *        address. Symbols convert implicitly from and to std::string, so they are only spelled
+ *        out at the I/O boundary. The strings of the VFI_TYPE, DIRECTION and PRIMITIVE_TYPE
+ *        enums are interned first, with the enum values as ids. Interned strings are never
+ *        released, so Symbols are meant for values that repeat, such as types and entity names.
+ */
+class Symbol
+{
+public:
+    struct ENTRY;
+private:
+    const ENTRY* entry_;
+    explicit Symbol(const ENTRY* entry);
+public:
+    Symbol();
+    Symbol(const std::string& value);
+    Symbol(const char* value);
+    explicit Symbol(const std::string_view& value);
+    Symbol(const VFI_TYPE& value);
+    Symbol(const DIRECTION& value);
+    Symbol(const PRIMITIVE_TYPE& value);
+
+    static std::optional<Symbol> find(const std::string_view& value);
+
+    const std::string& str() const;
+    operator const std::string&() const;
+    std::uint32_t id() const;
+    bool empty() const;
+
+    bool operator==(const Symbol& other) const
+    {
+        return entry_ == other.entry_;
+    }
+
+    bool operator!=(const Symbol& other) const
+    {
+        return entry_ != other.entry_;
+    }
+
+    bool operator<(const Symbol& other) const
+    {
+        return str() < other.str();
+    }
+
+    std::size_t hash() const
+    {
+        return std::hash<const void*>()(entry_);
+    }
+};
+
+// Comparisons with strings do not intern the string
+inline bool operator==(const Symbol& symbol, const std::string& value) { return symbol.str() == value; }
+inline bool operator==(const std::string& value, const Symbol& symbol) { return symbol.str() == value; }
+inline bool operator==(const Symbol& symbol, const char* value) { return symbol.str() == value; }
+inline bool operator==(const char* value, const Symbol& symbol) { return symbol.str() == value; }
+inline bool operator!=(const Symbol& symbol, const std::string& value) { return !(symbol == value); }
+inline bool operator!=(const std::string& value, const Symbol& symbol) { return !(symbol == value); }
+inline bool operator!=(const Symbol& symbol, const char* value) { return !(symbol == value); }
+inline bool operator!=(const char* value, const Symbol& symbol) { return !(symbol == value); }
+
+inline std::ostream& operator<<(std::ostream& os, const Symbol& symbol)
+{
+    return os << symbol.str();
+}
+
+}
+
+template<>
+struct std::hash<DQ_robotics_extensions::Symbol>
+{
+    std::size_t operator()(const DQ_robotics_extensions::Symbol& symbol) const
+    {
+        return symbol.hash();
+    }
+};
@@ -0,0 +1,101 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <dqrobotics_extensions/robot_constraint_editor/ordered_hash_map.hpp>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The TagView class is a read-only view of a set of tags, such as the result of a query of
+ *        the RobotConstraintEditor indexes. The tags are not copied, so the view is invalidated
+ *        by the next modification of the editor.
+ */
+class TagView
+{
+public:
+    /**
+     * @brief TagSet maps each tag to the number of times it was added to the set.
+     */
+    using TagSet = OrderedHashMap<std::string, std::size_t>;
+
+    class const_iterator
+    {
+        TagSet::const_iterator it_;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        const_iterator() = default;
+        explicit const_iterator(const TagSet::const_iterator& it)
+            : it_(it)
+        {
+        }
+
+        reference operator*() const { return it_->first; }
+        pointer operator->() const { return &it_->first; }
+
+        const_iterator& operator++()
+        {
+            ++it_;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+            ++it_;
+            return it;
+        }
+
+        bool operator==(const const_iterator& other) const { return it_ == other.it_; }
+        bool operator!=(const const_iterator& other) const { return it_ != other.it_; }
+    };
+
+private:
+    const TagSet* tags_;
+
+    const TagSet& _tags() const
+    {
+        static const TagSet empty_tags;
+        return tags_ ? *tags_ : empty_tags;
+    }
+
+public:
+    explicit TagView(const TagSet* tags = nullptr)
+        : tags_(tags)
+    {
+    }
+
+    const_iterator begin() const { return const_iterator(_tags().begin()); }
+    const_iterator end() const { return const_iterator(_tags().end()); }
+    std::size_t size() const { return _tags().size(); }
+    bool empty() const { return _tags().empty(); }
+    bool contains(const std::string& tag) const { return _tags().contains(tag); }
+};
+
+}
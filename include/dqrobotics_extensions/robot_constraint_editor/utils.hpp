@@ -9,6 +9,29 @@ namespace DQ_robotics_extensions {
 
 std::string bool2string(const bool& flag);
 std::string join_vector(const std::vector<std::string>& vec, const std::string& delimiter = ", ");
+std::string join_vector(const VFIConfigurationFile::EntityList& vec, const std::string& delimiter = ", ");
+void write_file_atomically(const std::string& file_name, const std::string& contents);
+
+/**
+ * @brief The AtomicFile class writes a file through a uniquely named temporary file next to it,
+ *        which is flushed to the disk and renamed over the file by commit(). If the AtomicFile is
+ *        destroyed before commit(), the temporary file is removed and the file is unchanged.
+ */
+class AtomicFile
+{
+private:
+    std::string file_name_;
+    std::string temporary_file_;
+    int fd_;
+public:
+    explicit AtomicFile(const std::string& file_name);
+    ~AtomicFile();
+    AtomicFile(const AtomicFile&) = delete;
+    AtomicFile& operator=(const AtomicFile&) = delete;
+
+    void write(const char* data, const std::size_t& size);
+    void commit();
+};
 
 namespace  VFIConfigurationFileData {
     void show_data(const std::vector<DQ_robotics_extensions::VFIConfigurationFile::Data>& data,
@@ -22,9 +22,14 @@
 */
 
 #pragma once
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <variant>
+#include <dqrobotics_extensions/robot_constraint_editor/symbol.hpp>
 
 namespace DQ_robotics_extensions
 {
@@ -33,39 +38,148 @@ class VFIConfigurationFile
 {
 public:
 
+    /**
+     * @brief The ARENA_MODE enum selects where a document allocates the entity lists of its data.
+     *        HEAP allocates each list separately.
+     *        MONOTONIC allocates them from a std::pmr::monotonic_buffer_resource owned by the
+     *        document, which only releases its memory when the data is discarded.
+     *        POOL allocates them from a std::pmr::unsynchronized_pool_resource owned by the
+     *        document, which also reuses the memory of the lists modified or removed.
+     *        The data copied out of a document is allocated from the default memory resource.
+     */
+    enum class ARENA_MODE{
+        HEAP,
+        MONOTONIC,
+        POOL
+    };
+
+    // The entity lists can be allocated from a memory resource (see ARENA_MODE)
+    using EntityList = std::pmr::vector<Symbol>;
+
+    // The repeated string fields are interned (see Symbol)
     struct BASE_DATA{
-        std::string vfi_type;
+        Symbol vfi_type;
         double safe_distance;
         double vfi_gain;
-        std::string direction;
+        Symbol direction;
         std::string tag;
 
     };
     struct ENVIRONMENT_TO_ROBOT_DATA : BASE_DATA{
-        std::vector<std::string> cs_entity_environment;
-        std::vector<std::string> cs_entity_robot;
-        std::string entity_environment_primitive_type;
-        std::string entity_robot_primitive_type;
+        EntityList cs_entity_environment;
+        EntityList cs_entity_robot;
+        Symbol entity_environment_primitive_type;
+        Symbol entity_robot_primitive_type;
         int robot_index;
         int joint_index;
 
+        ENVIRONMENT_TO_ROBOT_DATA() = default;
+        explicit ENVIRONMENT_TO_ROBOT_DATA(std::pmr::memory_resource* resource)
+            : cs_entity_environment(resource), cs_entity_robot(resource)
+        {
+        }
     };
     struct ROBOT_TO_ROBOT_DATA : BASE_DATA{
-        std::vector<std::string> cs_entity_one;
-        std::vector<std::string> cs_entity_two;
-        std::string entity_one_primitive_type;
-        std::string entity_two_primitive_type;
+        EntityList cs_entity_one;
+        EntityList cs_entity_two;
+        Symbol entity_one_primitive_type;
+        Symbol entity_two_primitive_type;
         int robot_index_one;
         int robot_index_two;
         int joint_index_one;
         int joint_index_two;
+
+        ROBOT_TO_ROBOT_DATA() = default;
+        explicit ROBOT_TO_ROBOT_DATA(std::pmr::memory_resource* resource)
+            : cs_entity_one(resource), cs_entity_two(resource)
+        {
+        }
     };
 
     using Data = std::variant<ENVIRONMENT_TO_ROBOT_DATA, ROBOT_TO_ROBOT_DATA>;
 
+    /**
+     * @brief The LAZY_ENTRY struct locates an entry of a configuration file that was indexed
+     *        but not decoded. It shares the contents of the file, so it remains valid after the
+     *        file is loaded again. The meaning of first and last is up to the file format: a
+     *        VFIConfigurationFileBinary stores record indices instead of byte offsets.
+     */
+    struct LAZY_ENTRY{
+        std::string tag;
+        std::shared_ptr<const std::string> source;
+        std::size_t first;     // First byte of the entry in source
+        std::size_t last;      // One past the last byte of the entry in source
+        int first_line_number; // Zero-based line of the first byte, used in the diagnostics
+    };
+
+    using Entry = std::variant<Data, LAZY_ENTRY>;
+
+    /**
+     * @brief The Writer class writes a configuration file one entry at a time. The file is
+     *        complete after close(). A Writer destroyed before close() leaves the file unchanged.
+     */
+    class Writer
+    {
+    public:
+        virtual ~Writer() = default;
+
+        /**
+         * @brief write writes an entry.
+         * @param data The VFI configuration.
+         */
+        virtual void write(const Data& data) = 0;
+
+        /**
+         * @brief write writes an entry indexed by index_data.
+         * @param entry The indexed entry.
+         */
+        virtual void write(const LAZY_ENTRY& entry) = 0;
+
+        /**
+         * @brief close completes the file.
+         */
+        virtual void close() = 0;
+    };
+
 protected:
     VFIConfigurationFile() = default;
 
+    /**
+     * @brief The BufferingWriter class is the default Writer. It collects the entries and calls
+     *        save_data on close(), for file formats that cannot be written incrementally.
+     */
+    class BufferingWriter: public Writer
+    {
+    private:
+        VFIConfigurationFile& file_;
+        std::string config_file_;
+        int vfi_file_version_;
+        bool zero_indexed_;
+        std::vector<Data> data_;
+    public:
+        BufferingWriter(VFIConfigurationFile& file, const std::string& config_file,
+                        const int& vfi_file_version, const bool& zero_indexed)
+            : file_(file), config_file_(config_file), vfi_file_version_(vfi_file_version),
+              zero_indexed_(zero_indexed)
+        {
+        }
+
+        void write(const Data& data) override
+        {
+            data_.push_back(data);
+        }
+
+        void write(const LAZY_ENTRY& entry) override
+        {
+            data_.push_back(file_.decode_entry(entry));
+        }
+
+        void close() override
+        {
+            file_.save_data(data_, vfi_file_version_, zero_indexed_, config_file_);
+        }
+    };
+
 public:
     virtual ~VFIConfigurationFile() = default;
 
@@ -81,6 +195,28 @@ public:
      */
     virtual std::vector<Data>  get_data() const = 0;
 
+    /**
+     * @brief take_data moves the VFI configurations out of the configuration file, so the caller
+     *        gets them without a copy. The data must be loaded again before the next get_data.
+     *        The default implementation returns get_data().
+     * @return The desired data vector.
+     */
+    virtual std::vector<Data> take_data()
+    {
+        return get_data();
+    }
+
+    /**
+     * @brief for_each_data calls a function with each VFI configuration, in file order, without
+     *        copying the data. The default implementation iterates over get_data().
+     * @param function The function.
+     */
+    virtual void for_each_data(const std::function<void(const Data&)>& function) const
+    {
+        for (const auto& data : get_data())
+            function(data);
+    }
+
     /**
      * @brief get_vfi_file_version gets the configuration file version.
      * @return The desired file version.
@@ -106,6 +242,78 @@ public:
                            const bool& zero_indexed,
                            const std::string& config_file) = 0;
 
+    /**
+     * @brief index_data indexes a configuration file without decoding its entries. The
+     *        entries are decoded later with decode_entry. The default implementation does not
+     *        support indexing.
+     * @param config_file The name of the file including its path and format.
+     * @param entries The indexed entries, in file order.
+     * @return True if the file was indexed. False if the file must be read with load_data.
+     */
+    virtual bool index_data(const std::string& config_file, std::vector<LAZY_ENTRY>& entries)
+    {
+        (void)config_file;
+        (void)entries;
+        return false;
+    }
+
+    /**
+     * @brief decode_entry decodes an entry indexed by index_data.
+     * @param entry The indexed entry.
+     * @return The decoded data.
+     */
+    virtual Data decode_entry(const LAZY_ENTRY& entry) const
+    {
+        throw std::runtime_error("Entry '" + entry.tag + "' cannot be decoded by this configuration file!");
+    }
+
+    /**
+     * @brief serialize_entries serializes data into entries that save_entries writes verbatim.
+     *        The default implementation does not support serialization.
+     * @param data The data to serialize.
+     * @param entries The serialized entries, in the same order as data.
+     * @return True if the data was serialized. False otherwise.
+     */
+    virtual bool serialize_entries(const std::vector<const Data*>& data, std::vector<LAZY_ENTRY>& entries) const
+    {
+        (void)data;
+        (void)entries;
+        return false;
+    }
+
+    /**
+     * @brief open_writer opens a configuration file to write its entries one at a time. The
+     *        default implementation collects the entries and calls save_data on close().
+     * @param config_file The desired name of the file including its path and format.
+     * @param vfi_file_version The desired format version
+     * @param zero_indexed To define if the data uses a zero-indexed convention.
+     * @return The writer of the file.
+     */
+    virtual std::unique_ptr<Writer> open_writer(const std::string& config_file,
+                                                const int& vfi_file_version,
+                                                const bool& zero_indexed)
+    {
+        return std::make_unique<BufferingWriter>(*this, config_file, vfi_file_version, zero_indexed);
+    }
+
+    /**
+     * @brief save_entries saves a configuration file that mixes decoded data and indexed entries.
+     * @param entries the vector that contains the VFI configurations
+     * @param vfi_file_version The desired format version
+     * @param zero_indexed To define if the data uses a zero-indexed convention.
+     * @param config_file The desired name of the file including its path and format.
+     */
+    void save_entries(const std::vector<Entry>& entries,
+                      const int& vfi_file_version,
+                      const bool& zero_indexed,
+                      const std::string& config_file)
+    {
+        auto writer = open_writer(config_file, vfi_file_version, zero_indexed);
+        for (const auto& entry : entries)
+            std::visit([&writer](auto&& arg) { writer->write(arg); }, entry);
+        writer->close();
+    }
+
 };
 
 
@@ -0,0 +1,74 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+#pragma once
+#include <memory>
+#include <vector>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+
+namespace DQ_robotics_extensions
+{
+/**
+ * @brief The VFIConfigurationFileBinary class reads and writes compiled VFI configuration
+ *        files (.vfib). The format is little-endian and versioned:
+ *
+ *        [header][record table][entity table][string pool]
+ *
+ *        Each record of the record table has a fixed width, and refers to its strings
+ *        through (offset, length) pairs in the string pool. The cs_entity_* lists are
+ *        ranges of the entity table, which holds string references as well.
+ *        load_data maps the file in memory and only validates the header. The records are
+ *        decoded when they are requested. With lazy loading, the RobotConstraintEditor
+ *        indexes the records through index_data and decodes each one on its first access.
+ */
+class VFIConfigurationFileBinary: public VFIConfigurationFile
+{
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_;
+public:
+    ~VFIConfigurationFileBinary() = default;
+    explicit VFIConfigurationFileBinary();
+
+    // Override from VFIConfigurationFile
+    void load_data(const std::string& config_file) override;
+    std::vector<VFIConfigurationFile::Data> get_data() const override;
+    void for_each_data(const std::function<void(const Data&)>& function) const override;
+    int get_vfi_file_version() const override;
+    bool is_zero_indexed() const override;
+    void save_data(const std::vector<Data>& data,
+                   const int& vfi_file_version,
+                   const bool& zero_indexed,
+                   const std::string& config_file) override;
+    bool index_data(const std::string& config_file, std::vector<LAZY_ENTRY>& entries) override;
+    Data decode_entry(const LAZY_ENTRY& entry) const override;
+
+    void write_data(const std::vector<Data>& data,
+                    const int& vfi_file_version,
+                    const bool& zero_indexed,
+                    const std::string& config_file);
+
+    std::size_t get_number_of_records() const;
+    VFIConfigurationFile::Data get_record(const std::size_t& index) const;
+};
+}
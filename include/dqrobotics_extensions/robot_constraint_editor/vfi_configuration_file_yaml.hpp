@@ -34,18 +34,50 @@ private:
     class Impl;
     std::shared_ptr<Impl> impl_;
 public:
+    /**
+     * @brief The LOAD_MODE enum selects how load_data reads the YAML file.
+     *        DOM builds the whole YAML::Node tree before extracting the VFI data.
+     *        STREAMING fills the VFI data directly from the yaml-cpp parser events.
+     *        SCANNER reads the dialect written by save_data with a dedicated scanner, and uses
+     *        the STREAMING mode for files written in any other way.
+     *        PARALLEL splits the vfi_array of those files into chunks that are read by the
+     *        SCANNER on several threads (see set_number_of_load_threads).
+     *        All modes produce the same data and diagnostics.
+     */
+    enum class LOAD_MODE{
+        DOM,
+        STREAMING,
+        SCANNER,
+        PARALLEL
+    };
+
     ~VFIConfigurationFileYaml() = default;
     explicit VFIConfigurationFileYaml();
 
+    void set_load_mode(const LOAD_MODE& load_mode);
+    LOAD_MODE get_load_mode() const;
+    void set_number_of_load_threads(const int& number_of_threads);
+    void set_cache_directory(const std::string& cache_directory);
+    void set_arena_mode(const ARENA_MODE& arena_mode);
+    ARENA_MODE get_arena_mode() const;
+
     // Override from VFIConfigurationFile
     void load_data(const std::string& config_file) override;
     std::vector<VFIConfigurationFile::Data> get_data() const override;
+    std::vector<VFIConfigurationFile::Data> take_data() override;
+    void for_each_data(const std::function<void(const Data&)>& function) const override;
     int get_vfi_file_version() const override;
     bool is_zero_indexed() const override;
     void save_data(const std::vector<Data>& data,
                    const int& vfi_file_version,
                    const bool& zero_indexed,
                    const std::string& config_file) override;
+    bool index_data(const std::string& config_file, std::vector<LAZY_ENTRY>& entries) override;
+    Data decode_entry(const LAZY_ENTRY& entry) const override;
+    bool serialize_entries(const std::vector<const Data*>& data, std::vector<LAZY_ENTRY>& entries) const override;
+    std::unique_ptr<Writer> open_writer(const std::string& config_file,
+                                        const int& vfi_file_version,
+                                        const bool& zero_indexed) override;
 
 };
 }
@@ -0,0 +1,298 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file.hpp>
+
+namespace DQ_robotics_extensions
+{
+
+/**
+ * @brief The FIELD enum identifies the fields of the VFI configurations. The name of each field
+ *        is its key in the configuration files (see field_names).
+ */
+enum class FIELD : std::uint8_t{
+    VFI_TYPE,
+    CS_ENTITY_ENVIRONMENT,
+    CS_ENTITY_ROBOT,
+    ENTITY_ENVIRONMENT_PRIMITIVE_TYPE,
+    ENTITY_ROBOT_PRIMITIVE_TYPE,
+    ROBOT_INDEX,
+    JOINT_INDEX,
+    CS_ENTITY_ONE,
+    CS_ENTITY_TWO,
+    ENTITY_ONE_PRIMITIVE_TYPE,
+    ENTITY_TWO_PRIMITIVE_TYPE,
+    ROBOT_INDEX_ONE,
+    ROBOT_INDEX_TWO,
+    JOINT_INDEX_ONE,
+    JOINT_INDEX_TWO,
+    SAFE_DISTANCE,
+    VFI_GAIN,
+    DIRECTION,
+    TAG
+};
+
+inline constexpr std::size_t number_of_fields = static_cast<std::size_t>(FIELD::TAG) + 1;
+
+inline constexpr std::array<std::string_view, number_of_fields> field_names = {
+    "vfi_type",
+    "cs_entity_environment",
+    "cs_entity_robot",
+    "entity_environment_primitive_type",
+    "entity_robot_primitive_type",
+    "robot_index",
+    "joint_index",
+    "cs_entity_one",
+    "cs_entity_two",
+    "entity_one_primitive_type",
+    "entity_two_primitive_type",
+    "robot_index_one",
+    "robot_index_two",
+    "joint_index_one",
+    "joint_index_two",
+    "safe_distance",
+    "vfi_gain",
+    "direction",
+    "tag"
+};
+
+template<typename MemberPointer>
+struct MEMBER_POINTER_TRAITS;
+
+template<typename Struct, typename Type>
+struct MEMBER_POINTER_TRAITS<Type Struct::*>
+{
+    using struct_type = Struct;
+    using type = Type;
+};
+
+/**
+ * @brief The FIELD_DESCRIPTOR struct describes a field of a VFI configuration: its FIELD, its
+ *        name, its type and the member that stores it.
+ */
+template<FIELD Field, auto Member>
+struct FIELD_DESCRIPTOR
+{
+    static constexpr FIELD field = Field;
+    static constexpr auto member = Member;
+    static constexpr std::string_view name = field_names[static_cast<std::size_t>(Field)];
+    using type = typename MEMBER_POINTER_TRAITS<decltype(Member)>::type;
+};
+
+/**
+ * @brief The DATA_FIELDS struct lists the fields of each VFI configuration, in the order they are
+ *        read, written and displayed. Adding a field to a configuration only needs a new FIELD and
+ *        a new entry in this table.
+ */
+template<typename Data>
+struct DATA_FIELDS;
+
+template<>
+struct DATA_FIELDS<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>
+{
+    using T = VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA;
+    using type = std::tuple<
+        FIELD_DESCRIPTOR<FIELD::VFI_TYPE, &T::vfi_type>,
+        FIELD_DESCRIPTOR<FIELD::CS_ENTITY_ENVIRONMENT, &T::cs_entity_environment>,
+        FIELD_DESCRIPTOR<FIELD::CS_ENTITY_ROBOT, &T::cs_entity_robot>,
+        FIELD_DESCRIPTOR<FIELD::ENTITY_ENVIRONMENT_PRIMITIVE_TYPE, &T::entity_environment_primitive_type>,
+        FIELD_DESCRIPTOR<FIELD::ENTITY_ROBOT_PRIMITIVE_TYPE, &T::entity_robot_primitive_type>,
+        FIELD_DESCRIPTOR<FIELD::ROBOT_INDEX, &T::robot_index>,
+        FIELD_DESCRIPTOR<FIELD::JOINT_INDEX, &T::joint_index>,
+        FIELD_DESCRIPTOR<FIELD::SAFE_DISTANCE, &T::safe_distance>,
+        FIELD_DESCRIPTOR<FIELD::VFI_GAIN, &T::vfi_gain>,
+        FIELD_DESCRIPTOR<FIELD::DIRECTION, &T::direction>,
+        FIELD_DESCRIPTOR<FIELD::TAG, &T::tag>
+    >;
+};
+
+template<>
+struct DATA_FIELDS<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>
+{
+    using T = VFIConfigurationFile::ROBOT_TO_ROBOT_DATA;
+    using type = std::tuple<
+        FIELD_DESCRIPTOR<FIELD::VFI_TYPE, &T::vfi_type>,
+        FIELD_DESCRIPTOR<FIELD::CS_ENTITY_ONE, &T::cs_entity_one>,
+        FIELD_DESCRIPTOR<FIELD::CS_ENTITY_TWO, &T::cs_entity_two>,
+        FIELD_DESCRIPTOR<FIELD::ENTITY_ONE_PRIMITIVE_TYPE, &T::entity_one_primitive_type>,
+        FIELD_DESCRIPTOR<FIELD::ENTITY_TWO_PRIMITIVE_TYPE, &T::entity_two_primitive_type>,
+        FIELD_DESCRIPTOR<FIELD::ROBOT_INDEX_ONE, &T::robot_index_one>,
+        FIELD_DESCRIPTOR<FIELD::ROBOT_INDEX_TWO, &T::robot_index_two>,
+        FIELD_DESCRIPTOR<FIELD::JOINT_INDEX_ONE, &T::joint_index_one>,
+        FIELD_DESCRIPTOR<FIELD::JOINT_INDEX_TWO, &T::joint_index_two>,
+        FIELD_DESCRIPTOR<FIELD::SAFE_DISTANCE, &T::safe_distance>,
+        FIELD_DESCRIPTOR<FIELD::VFI_GAIN, &T::vfi_gain>,
+        FIELD_DESCRIPTOR<FIELD::DIRECTION, &T::direction>,
+        FIELD_DESCRIPTOR<FIELD::TAG, &T::tag>
+    >;
+};
+
+template<typename Data>
+using data_fields_t = typename DATA_FIELDS<Data>::type;
+
+/**
+ * @brief field_position gets the position of a field in the list of fields of a configuration.
+ * @return The desired position, or the number of fields if the configuration has no such field.
+ */
+template<typename Data, FIELD Field, std::size_t I = 0>
+constexpr std::size_t field_position()
+{
+    if constexpr (I == std::tuple_size_v<data_fields_t<Data>>)
+        return I;
+    else if constexpr (std::tuple_element_t<I, data_fields_t<Data>>::field == Field)
+        return I;
+    else
+        return field_position<Data, Field, I + 1>();
+}
+
+template<typename Data, FIELD Field>
+inline constexpr bool has_field_v = field_position<Data, Field>() < std::tuple_size_v<data_fields_t<Data>>;
+
+template<typename Data, FIELD Field>
+using field_descriptor_t = std::tuple_element_t<field_position<Data, Field>(), data_fields_t<Data>>;
+
+/**
+ * @brief field_type_t is the type of a field. A field has the same type in all the configurations.
+ */
+template<FIELD Field>
+constexpr auto field_type_tag()
+{
+    if constexpr (has_field_v<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA, Field>)
+        return field_descriptor_t<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA, Field>{};
+    else
+        return field_descriptor_t<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA, Field>{};
+}
+
+template<FIELD Field>
+using field_type_t = typename decltype(field_type_tag<Field>())::type;
+
+/**
+ * @brief FIELD_VALUE holds the value of any field.
+ */
+using FIELD_VALUE = std::variant<int, double, Symbol, std::string, VFIConfigurationFile::EntityList>;
+
+/**
+ * @brief for_each_field calls a function with the descriptor and the value of each field of a
+ *        configuration, in the order of DATA_FIELDS.
+ * @param data The configuration.
+ * @param function The function, called as function(descriptor, value).
+ */
+template<typename Data, typename Function>
+void for_each_field(Data& data, Function&& function)
+{
+    std::apply([&](auto... descriptors) {
+        (function(descriptors, data.*decltype(descriptors)::member), ...);
+    }, data_fields_t<std::remove_const_t<Data>>{});
+}
+
+/**
+ * @brief allocate_data copies or moves a configuration into a memory resource: the entity lists of
+ *        the result are allocated from the resource. The lists are moved without copying when
+ *        the source lists already use the resource.
+ * @param data The configuration.
+ * @param resource The memory resource.
+ * @return The desired configuration.
+ */
+template<typename Source>
+VFIConfigurationFile::Data allocate_data(Source&& data, std::pmr::memory_resource* resource)
+{
+    return std::visit([resource](auto&& arg) -> VFIConfigurationFile::Data {
+        using DataType = std::decay_t<decltype(arg)>;
+        DataType result(resource);
+        std::apply([&](auto... descriptors) {
+            ((result.*decltype(descriptors)::member =
+                  std::forward<decltype(arg)>(arg).*decltype(descriptors)::member), ...);
+        }, data_fields_t<DataType>{});
+        return result;
+    }, std::forward<Source>(data));
+}
+
+/**
+ * @brief field_name_hash is the hash of the perfect hash table of the field names (FNV-1a).
+ */
+constexpr std::uint32_t field_name_hash(const std::string_view& name, const std::uint32_t& seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (const char& c : name)
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    return hash;
+}
+
+inline constexpr std::size_t field_hash_table_size = 64;
+
+/**
+ * @brief find_field_hash_seed finds the first seed that maps every field name to its own slot.
+ */
+constexpr std::uint32_t find_field_hash_seed()
+{
+    for (std::uint32_t seed = 0;; ++seed)
+    {
+        std::array<bool, field_hash_table_size> used{};
+        bool collision = false;
+        for (const auto& name : field_names)
+        {
+            const std::size_t slot = field_name_hash(name, seed) % field_hash_table_size;
+            collision = collision || used[slot];
+            used[slot] = true;
+        }
+        if (!collision)
+            return seed;
+    }
+}
+
+inline constexpr std::uint32_t field_hash_seed = find_field_hash_seed();
+
+inline constexpr std::array<std::uint8_t, field_hash_table_size> field_hash_table = []() {
+    std::array<std::uint8_t, field_hash_table_size> table{};
+    for (auto& slot : table)
+        slot = static_cast<std::uint8_t>(number_of_fields);
+    for (std::size_t i = 0; i < number_of_fields; ++i)
+        table[field_name_hash(field_names[i], field_hash_seed) % field_hash_table_size] = static_cast<std::uint8_t>(i);
+    return table;
+}();
+
+/**
+ * @brief find_field finds a field from its name with a perfect hash table: one hash and one string
+ *        comparison.
+ * @param name The name of the field.
+ * @return The desired field, or std::nullopt if no field has that name.
+ */
+constexpr std::optional<FIELD> find_field(const std::string_view& name)
+{
+    const std::uint8_t index = field_hash_table[field_name_hash(name, field_hash_seed) % field_hash_table_size];
+    if (index < number_of_fields && field_names[index] == name)
+        return static_cast<FIELD>(index);
+    return std::nullopt;
+}
+
+static_assert(find_field("safe_distance") == FIELD::SAFE_DISTANCE && !find_field("safe"),
+              "The perfect hash table of the field names is inconsistent");
+
+}
@@ -0,0 +1,405 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_query.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace DQ_robotics_extensions
+{
+
+namespace
+{
+
+std::string field_name(const FIELD& field)
+{
+    return std::string(field_names[static_cast<std::size_t>(field)]);
+}
+
+bool has_wildcards(const std::string& pattern)
+{
+    return pattern.find_first_of("*?") != std::string::npos;
+}
+
+/**
+ * @brief match_pattern matches a text with a pattern, where '*' matches any text and '?' any
+ *        character. The last '*' is backtracked only, so the cost is O(text * pattern) at worst.
+ */
+bool match_pattern(const std::string_view& text, const std::string_view& pattern)
+{
+    std::size_t t = 0;
+    std::size_t p = 0;
+    std::size_t star = std::string_view::npos;
+    std::size_t star_text = 0;
+    while (t < text.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++t;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_text = t;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            t = ++star_text;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+/**
+ * @brief compile_field calls make with the descriptor of a field of a VFI type.
+ * @return True if the VFI type has the field. False otherwise.
+ */
+template<typename DataType, typename Make>
+bool compile_field(const FIELD& field, Make&& make)
+{
+    bool found = false;
+    std::apply([&](auto... descriptors) {
+        ((descriptors.field == field ? (make(descriptors), found = true) : false), ...);
+    }, data_fields_t<DataType>{});
+    return found;
+}
+
+/**
+ * @brief compile_comparison gets a function that compares a field with a value. The comparison
+ *        is resolved here, so the function only reads the member and compares it.
+ */
+template<typename DataType, typename Descriptor, typename Value>
+std::function<bool(const DataType&)> compile_comparison(const ConstraintQuery::COMPARISON& comparison, const Value& value)
+{
+    switch (comparison) {
+    case ConstraintQuery::COMPARISON::EQUAL:
+        return [value](const DataType& data) { return data.*Descriptor::member == value; };
+    case ConstraintQuery::COMPARISON::NOT_EQUAL:
+        return [value](const DataType& data) { return data.*Descriptor::member != value; };
+    case ConstraintQuery::COMPARISON::LESS:
+        return [value](const DataType& data) { return data.*Descriptor::member < value; };
+    case ConstraintQuery::COMPARISON::LESS_EQUAL:
+        return [value](const DataType& data) { return !(value < data.*Descriptor::member); };
+    case ConstraintQuery::COMPARISON::GREATER:
+        return [value](const DataType& data) { return value < data.*Descriptor::member; };
+    case ConstraintQuery::COMPARISON::GREATER_EQUAL:
+        return [value](const DataType& data) { return !(data.*Descriptor::member < value); };
+    default:
+        throw std::runtime_error("The comparison is not supported by the field '" + field_name(Descriptor::field) + "'!");
+    }
+}
+
+}
+
+/**
+ * @brief The ConstraintQuery::Impl class stores the compiled conditions and updates of each
+ *        VFI type.
+ */
+class ConstraintQuery::Impl
+{
+public:
+    template<typename DataType>
+    struct FUNCTIONS{
+        using data_type = DataType;
+        std::vector<std::function<bool(const DataType&)>> conditions;
+        std::vector<std::function<bool(DataType&)>> updates;
+        bool rejected = false; // A condition is on a field that the VFI type does not have
+    };
+
+    FUNCTIONS<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA> environment_to_robot_;
+    FUNCTIONS<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA> robot_to_robot_;
+    std::vector<FIELD> updated_fields_;
+
+    template<typename Function>
+    void for_each_type(Function&& function)
+    {
+        function(environment_to_robot_);
+        function(robot_to_robot_);
+    }
+
+    FUNCTIONS<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>& functions(const VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA&)
+    {
+        return environment_to_robot_;
+    }
+
+    FUNCTIONS<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>& functions(const VFIConfigurationFile::ROBOT_TO_ROBOT_DATA&)
+    {
+        return robot_to_robot_;
+    }
+
+    /**
+     * @brief _where adds a condition to each VFI type. A VFI type without the field rejects all
+     *        its constraints.
+     * @param make The function that compiles the condition, called as make(DataType*, descriptor)
+     *        with a null pointer that only carries the VFI type.
+     */
+    template<typename Make>
+    void _where(const FIELD& field, Make&& make)
+    {
+        for_each_type([&](auto& functions) {
+            using DataType = typename std::decay_t<decltype(functions)>::data_type;
+            if (!compile_field<DataType>(field, [&](auto descriptor) {
+                    functions.conditions.push_back(make(static_cast<DataType*>(nullptr), descriptor));
+                }))
+                functions.rejected = true;
+        });
+    }
+
+    /**
+     * @brief _update adds an update to each VFI type that has the field.
+     * @param make The function that compiles the update, called as in _where.
+     */
+    template<typename Make>
+    void _update(const FIELD& field, Make&& make)
+    {
+        if (field == FIELD::TAG || field == FIELD::VFI_TYPE)
+            throw std::runtime_error("The field '" + field_name(field) + "' cannot be updated by a ConstraintQuery!");
+        for_each_type([&](auto& functions) {
+            using DataType = typename std::decay_t<decltype(functions)>::data_type;
+            compile_field<DataType>(field, [&](auto descriptor) {
+                functions.updates.push_back(make(static_cast<DataType*>(nullptr), descriptor));
+            });
+        });
+        if (std::find(updated_fields_.begin(), updated_fields_.end(), field) == updated_fields_.end())
+            updated_fields_.push_back(field);
+    }
+};
+
+ConstraintQuery::ConstraintQuery()
+{
+    impl_ = std::make_shared<ConstraintQuery::Impl>();
+}
+
+/**
+ * @brief ConstraintQuery::where adds a condition on a numeric field.
+ * @param field The field.
+ * @param comparison The comparison, from EQUAL to GREATER_EQUAL.
+ * @param value The value the field is compared with.
+ * @return The query.
+ */
+ConstraintQuery& ConstraintQuery::where(const FIELD& field, const COMPARISON& comparison, const double& value)
+{
+    impl_->_where(field, [&](auto data, auto descriptor) -> std::function<bool(const std::remove_pointer_t<decltype(data)>&)> {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+        using Descriptor = decltype(descriptor);
+        if constexpr (std::is_arithmetic_v<typename Descriptor::type>)
+            return compile_comparison<DataType, Descriptor>(comparison, value);
+        else
+            throw std::runtime_error("The field '" + field_name(field) + "' is not numeric!");
+    });
+    return *this;
+}
+
+/**
+ * @brief ConstraintQuery::where adds a condition on a string field or an entity list.
+ * @param field The field.
+ * @param comparison EQUAL, NOT_EQUAL or MATCH for a string field, CONTAINS for an entity list.
+ * @param value The value or the pattern the field is compared with.
+ * @return The query.
+ */
+ConstraintQuery& ConstraintQuery::where(const FIELD& field, const COMPARISON& comparison, const std::string& value)
+{
+    // A pattern without wildcards is an equality, which compares the Symbols by address
+    const bool pattern = has_wildcards(value);
+    impl_->_where(field, [&](auto data, auto descriptor) -> std::function<bool(const std::remove_pointer_t<decltype(data)>&)> {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+        using Descriptor = decltype(descriptor);
+        using FieldType = typename Descriptor::type;
+        if constexpr (std::is_same_v<FieldType, Symbol> || std::is_same_v<FieldType, std::string>) {
+            if (comparison == COMPARISON::MATCH && pattern)
+                return [value](const DataType& data) {
+                    return match_pattern(static_cast<const std::string&>(data.*Descriptor::member), value);
+                };
+            const COMPARISON equality = (comparison == COMPARISON::MATCH) ? COMPARISON::EQUAL : comparison;
+            if (equality == COMPARISON::EQUAL || equality == COMPARISON::NOT_EQUAL) {
+                // A string that is not interned is compared as a string, so the query does not intern it
+                if constexpr (std::is_same_v<FieldType, Symbol>) {
+                    if (const auto symbol = Symbol::find(value))
+                        return compile_comparison<DataType, Descriptor>(equality, *symbol);
+                    const bool equal = (equality == COMPARISON::EQUAL);
+                    return [value, equal](const DataType& data) { return (data.*Descriptor::member == value) == equal; };
+                } else {
+                    return compile_comparison<DataType, Descriptor>(equality, value);
+                }
+            }
+        } else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList>) {
+            if (comparison == COMPARISON::CONTAINS && pattern)
+                return [value](const DataType& data) {
+                    const auto& entities = data.*Descriptor::member;
+                    return std::any_of(entities.begin(), entities.end(), [&value](const Symbol& entity) {
+                        return match_pattern(entity.str(), value);
+                    });
+                };
+            if (comparison == COMPARISON::CONTAINS) {
+                if (const auto entity = Symbol::find(value))
+                    return [entity = *entity](const DataType& data) {
+                        const auto& entities = data.*Descriptor::member;
+                        return std::find(entities.begin(), entities.end(), entity) != entities.end();
+                    };
+                return [value](const DataType& data) {
+                    const auto& entities = data.*Descriptor::member;
+                    return std::find(entities.begin(), entities.end(), value) != entities.end();
+                };
+            }
+        }
+        throw std::runtime_error("The comparison is not supported by the field '" + field_name(field) + "'!");
+    });
+    return *this;
+}
+
+ConstraintQuery& ConstraintQuery::where(const FIELD& field, const COMPARISON& comparison, const char* value)
+{
+    return where(field, comparison, std::string(value));
+}
+
+/**
+ * @brief ConstraintQuery::set adds an update that sets a numeric field. The value is converted
+ *        to the type of the field. An integer field requires an integer value.
+ * @param field The field.
+ * @param value The new value.
+ * @return The query.
+ */
+ConstraintQuery& ConstraintQuery::set(const FIELD& field, const double& value)
+{
+    impl_->_update(field, [&](auto data, auto descriptor) -> std::function<bool(std::remove_pointer_t<decltype(data)>&)> {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+        using Descriptor = decltype(descriptor);
+        using FieldType = typename Descriptor::type;
+        if constexpr (std::is_integral_v<FieldType>) {
+            if (value != std::trunc(value) || std::abs(value) > 2147483647.0)
+                throw std::runtime_error("The field '" + field_name(field) + "' requires an integer value!");
+        }
+        if constexpr (std::is_arithmetic_v<FieldType>)
+            return [value = static_cast<FieldType>(value)](DataType& data) {
+                if (data.*Descriptor::member == value)
+                    return false;
+                data.*Descriptor::member = value;
+                return true;
+            };
+        else
+            throw std::runtime_error("The field '" + field_name(field) + "' is not numeric!");
+    });
+    return *this;
+}
+
+/**
+ * @brief ConstraintQuery::set adds an update that sets a string field (direction or a primitive type).
+ * @param field The field.
+ * @param value The new value.
+ * @return The query.
+ */
+ConstraintQuery& ConstraintQuery::set(const FIELD& field, const std::string& value)
+{
+    impl_->_update(field, [&](auto data, auto descriptor) -> std::function<bool(std::remove_pointer_t<decltype(data)>&)> {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+        using Descriptor = decltype(descriptor);
+        if constexpr (std::is_same_v<typename Descriptor::type, Symbol>)
+            return [value = Symbol(value)](DataType& data) {
+                if (data.*Descriptor::member == value)
+                    return false;
+                data.*Descriptor::member = value;
+                return true;
+            };
+        else
+            throw std::runtime_error("The field '" + field_name(field) + "' is not a string!");
+    });
+    return *this;
+}
+
+ConstraintQuery& ConstraintQuery::set(const FIELD& field, const char* value)
+{
+    return set(field, std::string(value));
+}
+
+/**
+ * @brief ConstraintQuery::scale adds an update that multiplies a floating-point field
+ *        (safe_distance or vfi_gain) by a factor.
+ * @param field The field.
+ * @param factor The factor.
+ * @return The query.
+ */
+ConstraintQuery& ConstraintQuery::scale(const FIELD& field, const double& factor)
+{
+    impl_->_update(field, [&](auto data, auto descriptor) -> std::function<bool(std::remove_pointer_t<decltype(data)>&)> {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+        using Descriptor = decltype(descriptor);
+        if constexpr (std::is_floating_point_v<typename Descriptor::type>)
+            return [factor](DataType& data) {
+                const auto value = data.*Descriptor::member * factor;
+                if (data.*Descriptor::member == value)
+                    return false;
+                data.*Descriptor::member = value;
+                return true;
+            };
+        else
+            throw std::runtime_error("The field '" + field_name(field) + "' cannot be scaled!");
+    });
+    return *this;
+}
+
+/**
+ * @brief ConstraintQuery::matches checks if a constraint satisfies all the conditions.
+ * @param data The constraint.
+ * @return True if the constraint satisfies the conditions. False otherwise.
+ */
+bool ConstraintQuery::matches(const VFIConfigurationFile::Data& data) const
+{
+    return std::visit([this](auto&& arg) {
+        const auto& functions = impl_->functions(arg);
+        if (functions.rejected)
+            return false;
+        for (const auto& condition : functions.conditions)
+            if (!condition(arg))
+                return false;
+        return true;
+    }, data);
+}
+
+/**
+ * @brief ConstraintQuery::update applies the updates to a constraint, whether it matches the
+ *        conditions or not.
+ * @param data The constraint.
+ * @return True if a field of the constraint changed. False otherwise.
+ */
+bool ConstraintQuery::update(VFIConfigurationFile::Data& data) const
+{
+    return std::visit([this](auto&& arg) {
+        bool modified = false;
+        for (const auto& update : impl_->functions(arg).updates)
+            modified = update(arg) || modified;
+        return modified;
+    }, data);
+}
+
+/**
+ * @brief ConstraintQuery::get_updated_fields gets the fields modified by the updates.
+ * @return The desired fields, in the order the updates were added.
+ */
+const std::vector<FIELD>& ConstraintQuery::get_updated_fields() const
+{
+    return impl_->updated_fields_;
+}
+
+}
@@ -0,0 +1,357 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_table.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace DQ_robotics_extensions
+{
+
+namespace
+{
+
+std::string column_name(const ConstraintTable::COLUMN& column)
+{
+    switch (column) {
+    case ConstraintTable::COLUMN::SAFE_DISTANCE: return "safe_distance";
+    case ConstraintTable::COLUMN::VFI_GAIN: return "vfi_gain";
+    case ConstraintTable::COLUMN::ROBOT_INDEX: return "robot_index";
+    case ConstraintTable::COLUMN::JOINT_INDEX: return "joint_index";
+    case ConstraintTable::COLUMN::ROBOT_INDEX_ONE: return "robot_index_one";
+    case ConstraintTable::COLUMN::ROBOT_INDEX_TWO: return "robot_index_two";
+    case ConstraintTable::COLUMN::JOINT_INDEX_ONE: return "joint_index_one";
+    case ConstraintTable::COLUMN::JOINT_INDEX_TWO: return "joint_index_two";
+    }
+    return "";
+}
+
+/**
+ * @brief filter_column clears the mask of the rows that do not satisfy the comparison. The loop
+ *        has no branches, so the compiler vectorizes it.
+ */
+template<typename T, typename COMPARE>
+void filter_column(std::uint8_t* mask, const T* column, const std::size_t& size, const double& value,
+                   const COMPARE& compare)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        mask[i] &= static_cast<std::uint8_t>(compare(static_cast<double>(column[i]), value));
+}
+
+template<typename T>
+void filter_column(std::uint8_t* mask, const T* column, const std::size_t& size,
+                   const ConstraintTable::COMPARISON& comparison, const double& value)
+{
+    switch (comparison) {
+    case ConstraintTable::COMPARISON::EQUAL:
+        filter_column(mask, column, size, value, std::equal_to<double>());
+        break;
+    case ConstraintTable::COMPARISON::NOT_EQUAL:
+        filter_column(mask, column, size, value, std::not_equal_to<double>());
+        break;
+    case ConstraintTable::COMPARISON::LESS:
+        filter_column(mask, column, size, value, std::less<double>());
+        break;
+    case ConstraintTable::COMPARISON::LESS_EQUAL:
+        filter_column(mask, column, size, value, std::less_equal<double>());
+        break;
+    case ConstraintTable::COMPARISON::GREATER:
+        filter_column(mask, column, size, value, std::greater<double>());
+        break;
+    case ConstraintTable::COMPARISON::GREATER_EQUAL:
+        filter_column(mask, column, size, value, std::greater_equal<double>());
+        break;
+    }
+}
+
+/**
+ * @brief set_column assigns a value to the selected rows, and flags them as modified.
+ */
+template<typename T>
+void set_column(T* column, std::uint8_t* modified, const std::uint8_t* mask, const std::size_t& size, const T& value)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        column[i] = mask[i] ? value : column[i];
+        modified[i] |= mask[i];
+    }
+}
+
+}
+
+class ConstraintTable::Impl
+{
+public:
+    ENVIRONMENT_TO_ROBOT_COLUMNS environment_to_robot_;
+    ROBOT_TO_ROBOT_COLUMNS robot_to_robot_;
+
+    Impl()
+    {
+
+    };
+
+    std::vector<std::uint8_t>& _modified(const TYPE& type)
+    {
+        return (type == TYPE::ENVIRONMENT_TO_ROBOT) ? environment_to_robot_.modified : robot_to_robot_.modified;
+    }
+
+    /**
+     * @brief _double_column gets a floating-point column.
+     * @return The desired column, or nullptr if the column holds integers.
+     */
+    std::vector<double>* _double_column(const TYPE& type, const COLUMN& column)
+    {
+        _check_column(type, column);
+        if (column == COLUMN::SAFE_DISTANCE)
+            return (type == TYPE::ENVIRONMENT_TO_ROBOT) ? &environment_to_robot_.safe_distance : &robot_to_robot_.safe_distance;
+        if (column == COLUMN::VFI_GAIN)
+            return (type == TYPE::ENVIRONMENT_TO_ROBOT) ? &environment_to_robot_.vfi_gain : &robot_to_robot_.vfi_gain;
+        return nullptr;
+    }
+
+    /**
+     * @brief _int_column gets an integer column.
+     * @return The desired column, or nullptr if the column holds floating-point values.
+     */
+    std::vector<int>* _int_column(const TYPE& type, const COLUMN& column)
+    {
+        _check_column(type, column);
+        switch (column) {
+        case COLUMN::ROBOT_INDEX: return &environment_to_robot_.robot_index;
+        case COLUMN::JOINT_INDEX: return &environment_to_robot_.joint_index;
+        case COLUMN::ROBOT_INDEX_ONE: return &robot_to_robot_.robot_index_one;
+        case COLUMN::ROBOT_INDEX_TWO: return &robot_to_robot_.robot_index_two;
+        case COLUMN::JOINT_INDEX_ONE: return &robot_to_robot_.joint_index_one;
+        case COLUMN::JOINT_INDEX_TWO: return &robot_to_robot_.joint_index_two;
+        default: return nullptr;
+        }
+    }
+
+    /**
+     * @brief _check_column throws an exception if the column does not belong to the VFI type.
+     */
+    void _check_column(const TYPE& type, const COLUMN& column) const
+    {
+        const bool environment_to_robot_column = (column == COLUMN::ROBOT_INDEX || column == COLUMN::JOINT_INDEX);
+        const bool robot_to_robot_column = (column != COLUMN::SAFE_DISTANCE && column != COLUMN::VFI_GAIN &&
+                                            !environment_to_robot_column);
+        if ((type == TYPE::ENVIRONMENT_TO_ROBOT && robot_to_robot_column) ||
+            (type == TYPE::ROBOT_TO_ROBOT && environment_to_robot_column))
+            throw std::runtime_error("The column '" + column_name(column) + "' does not belong to " +
+                                     (type == TYPE::ENVIRONMENT_TO_ROBOT ? "ENVIRONMENT_TO_ROBOT" : "ROBOT_TO_ROBOT"));
+    }
+
+    /**
+     * @brief _check_selection throws an exception if the selection does not match the rows of the table.
+     */
+    void _check_selection(const SELECTION& selection) const
+    {
+        const std::size_t size = (selection.type == TYPE::ENVIRONMENT_TO_ROBOT) ? environment_to_robot_.tag.size()
+                                                                                : robot_to_robot_.tag.size();
+        if (selection.mask.size() != size)
+            throw std::runtime_error("The selection does not match the rows of the ConstraintTable!");
+    }
+};
+
+/**
+ * @brief ConstraintTable::ConstraintTable ctor of an empty table.
+ */
+ConstraintTable::ConstraintTable()
+{
+    impl_ = std::make_shared<ConstraintTable::Impl>();
+}
+
+/**
+ * @brief ConstraintTable::ConstraintTable ctor of a table with the rows of a data vector.
+ * @param data The vector that contains the VFI configurations.
+ */
+ConstraintTable::ConstraintTable(const std::vector<VFIConfigurationFile::Data>& data)
+    : ConstraintTable()
+{
+    for (const auto& item : data)
+        add(item);
+}
+
+/**
+ * @brief ConstraintTable::add adds a row.
+ * @param data The VFI configuration.
+ */
+void ConstraintTable::add(const VFIConfigurationFile::Data& data)
+{
+    std::visit([this](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+            auto& columns = impl_->environment_to_robot_;
+            columns.tag.push_back(arg.tag);
+            columns.safe_distance.push_back(arg.safe_distance);
+            columns.vfi_gain.push_back(arg.vfi_gain);
+            columns.robot_index.push_back(arg.robot_index);
+            columns.joint_index.push_back(arg.joint_index);
+            columns.modified.push_back(0);
+        } else {
+            auto& columns = impl_->robot_to_robot_;
+            columns.tag.push_back(arg.tag);
+            columns.safe_distance.push_back(arg.safe_distance);
+            columns.vfi_gain.push_back(arg.vfi_gain);
+            columns.robot_index_one.push_back(arg.robot_index_one);
+            columns.robot_index_two.push_back(arg.robot_index_two);
+            columns.joint_index_one.push_back(arg.joint_index_one);
+            columns.joint_index_two.push_back(arg.joint_index_two);
+            columns.modified.push_back(0);
+        }
+    }, data);
+}
+
+/**
+ * @brief ConstraintTable::size gets the number of rows of a VFI type.
+ * @param type The VFI type.
+ * @return The desired number of rows.
+ */
+std::size_t ConstraintTable::size(const TYPE& type) const
+{
+    return impl_->_modified(type).size();
+}
+
+/**
+ * @brief ConstraintTable::get_environment_to_robot_columns gets the ENVIRONMENT_TO_ROBOT rows.
+ * @return The desired columns.
+ */
+const ConstraintTable::ENVIRONMENT_TO_ROBOT_COLUMNS& ConstraintTable::get_environment_to_robot_columns() const
+{
+    return impl_->environment_to_robot_;
+}
+
+/**
+ * @brief ConstraintTable::get_robot_to_robot_columns gets the ROBOT_TO_ROBOT rows.
+ * @return The desired columns.
+ */
+const ConstraintTable::ROBOT_TO_ROBOT_COLUMNS& ConstraintTable::get_robot_to_robot_columns() const
+{
+    return impl_->robot_to_robot_;
+}
+
+/**
+ * @brief ConstraintTable::select selects all the rows of a VFI type.
+ * @param type The VFI type.
+ * @return The desired selection.
+ */
+ConstraintTable::SELECTION ConstraintTable::select(const TYPE& type) const
+{
+    return SELECTION{type, std::vector<std::uint8_t>(size(type), 1)};
+}
+
+/**
+ * @brief ConstraintTable::filter removes from a selection the rows that do not satisfy
+ *        "column comparison value".
+ * @param selection The selection to filter.
+ * @param column The column to compare. It must belong to the VFI type of the selection.
+ * @param comparison The comparison.
+ * @param value The value to compare with.
+ */
+void ConstraintTable::filter(SELECTION& selection, const COLUMN& column, const COMPARISON& comparison,
+                             const double& value) const
+{
+    impl_->_check_selection(selection);
+    if (const auto double_column = impl_->_double_column(selection.type, column))
+        filter_column(selection.mask.data(), double_column->data(), selection.mask.size(), comparison, value);
+    else {
+        const auto int_column = impl_->_int_column(selection.type, column);
+        filter_column(selection.mask.data(), int_column->data(), selection.mask.size(), comparison, value);
+    }
+}
+
+/**
+ * @brief ConstraintTable::count gets the number of selected rows.
+ * @param selection The selection.
+ * @return The desired number of rows.
+ */
+std::size_t ConstraintTable::count(const SELECTION& selection) const
+{
+    std::size_t count = 0;
+    for (const auto& selected : selection.mask)
+        count += selected;
+    return count;
+}
+
+/**
+ * @brief ConstraintTable::get_tags gets the tags of the selected rows.
+ * @param selection The selection.
+ * @return The desired tags, in row order.
+ */
+std::vector<std::string> ConstraintTable::get_tags(const SELECTION& selection) const
+{
+    impl_->_check_selection(selection);
+    const auto& tags = (selection.type == TYPE::ENVIRONMENT_TO_ROBOT) ? impl_->environment_to_robot_.tag
+                                                                      : impl_->robot_to_robot_.tag;
+    std::vector<std::string> selected_tags;
+    selected_tags.reserve(count(selection));
+    for (std::size_t i = 0; i < selection.mask.size(); ++i)
+        if (selection.mask[i])
+            selected_tags.push_back(tags[i]);
+    return selected_tags;
+}
+
+/**
+ * @brief ConstraintTable::set assigns a value to a column of the selected rows.
+ * @param selection The selection.
+ * @param column The column to modify. It must belong to the VFI type of the selection.
+ * @param value The new value. Integer columns require an integer value.
+ */
+void ConstraintTable::set(const SELECTION& selection, const COLUMN& column, const double& value)
+{
+    impl_->_check_selection(selection);
+    auto& modified = impl_->_modified(selection.type);
+    if (const auto double_column = impl_->_double_column(selection.type, column))
+        set_column(double_column->data(), modified.data(), selection.mask.data(), modified.size(), value);
+    else {
+        if (value != std::trunc(value) || std::abs(value) > 2147483647.0)
+            throw std::runtime_error("The column '" + column_name(column) + "' requires an integer value!");
+        const auto int_column = impl_->_int_column(selection.type, column);
+        set_column(int_column->data(), modified.data(), selection.mask.data(), modified.size(), static_cast<int>(value));
+    }
+}
+
+/**
+ * @brief ConstraintTable::scale multiplies a floating-point column of the selected rows by a factor.
+ * @param selection The selection.
+ * @param column The column to modify. Either SAFE_DISTANCE or VFI_GAIN.
+ * @param factor The factor.
+ */
+void ConstraintTable::scale(const SELECTION& selection, const COLUMN& column, const double& factor)
+{
+    impl_->_check_selection(selection);
+    const auto double_column = impl_->_double_column(selection.type, column);
+    if (!double_column)
+        throw std::runtime_error("The column '" + column_name(column) + "' cannot be scaled!");
+    auto& modified = impl_->_modified(selection.type);
+    double* values = double_column->data();
+    const std::uint8_t* mask = selection.mask.data();
+    for (std::size_t i = 0; i < modified.size(); ++i) {
+        values[i] = mask[i] ? values[i] * factor : values[i];
+        modified[i] |= mask[i];
+    }
+}
+
+}
@@ -0,0 +1,320 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#include <dqrobotics_extensions/robot_constraint_editor/constraint_validator.hpp>
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace DQ_robotics_extensions
+{
+
+namespace
+{
+
+std::string to_string(const double& value)
+{
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+}
+
+/**
+ * @brief entity_count gets the number of entities a primitive type needs: a line and its two
+ *        endpoints for LINESEGMENT, and a single entity otherwise.
+ * @return The desired number, or zero if the primitive type is unknown.
+ */
+std::size_t entity_count(const Symbol& primitive_type)
+{
+    switch (static_cast<PRIMITIVE_TYPE>(primitive_type.id())) {
+    case PRIMITIVE_TYPE::POINT:
+    case PRIMITIVE_TYPE::LINE:
+    case PRIMITIVE_TYPE::PLANE:
+        return 1;
+    case PRIMITIVE_TYPE::LINESEGMENT:
+        return 3;
+    }
+    return 0;
+}
+
+}
+
+class ConstraintValidator::Impl
+{
+public:
+    bool zero_indexed_;
+    std::vector<int> number_of_joints_; // The number of joints of each robot. Empty if unknown.
+    int number_of_threads_ = 0; // default value: std::thread::hardware_concurrency()
+    // The rules also receive the index convention of the validation (see validate)
+    using RULE = std::function<void(const VFIConfigurationFile::Data& data, const bool& zero_indexed, const REPORT& report)>;
+    std::vector<std::pair<std::string, RULE>> rules_;
+
+    explicit Impl(const bool& zero_indexed)
+        : zero_indexed_(zero_indexed)
+    {
+    }
+
+    void _check_indices(const int& robot_index, const int& joint_index, const char* robot_field,
+                        const char* joint_field, const bool& zero_indexed, const REPORT& report) const
+    {
+        const int first = zero_indexed ? 0 : 1;
+        const int number_of_robots = static_cast<int>(number_of_joints_.size());
+        if (robot_index < first || (number_of_robots > 0 && robot_index >= first + number_of_robots))
+            report(SEVERITY::ERROR, std::string(robot_field) + " " + std::to_string(robot_index) + " is out of bounds");
+        else if (joint_index < first ||
+                 (number_of_robots > 0 && joint_index >= first + number_of_joints_[robot_index - first]))
+            report(SEVERITY::ERROR, std::string(joint_field) + " " + std::to_string(joint_index) + " is out of bounds");
+    }
+
+    static void _check_entities(const VFIConfigurationFile::EntityList& entities, const Symbol& primitive_type,
+                                const char* entities_field, const REPORT& report)
+    {
+        const std::size_t count = entity_count(primitive_type);
+        if (count == 0)
+            report(SEVERITY::ERROR, "Unknown primitive type '" + primitive_type.str() + "' for " + entities_field);
+        else if (entities.size() != count)
+            report(SEVERITY::ERROR, std::string(entities_field) + " has " + std::to_string(entities.size()) + " entities, but " +
+                                    primitive_type.str() + " needs " + std::to_string(count));
+    }
+
+    void _add_builtin_rules()
+    {
+        rules_.emplace_back("indices", [this](const VFIConfigurationFile::Data& data, const bool& zero_indexed, const REPORT& report) {
+            std::visit([&](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+                    _check_indices(arg.robot_index, arg.joint_index, "robot_index", "joint_index", zero_indexed, report);
+                } else {
+                    _check_indices(arg.robot_index_one, arg.joint_index_one, "robot_index_one", "joint_index_one", zero_indexed, report);
+                    _check_indices(arg.robot_index_two, arg.joint_index_two, "robot_index_two", "joint_index_two", zero_indexed, report);
+                }
+            }, data);
+        });
+        rules_.emplace_back("entity_lists", [](const VFIConfigurationFile::Data& data, const bool&, const REPORT& report) {
+            std::visit([&](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+                    _check_entities(arg.cs_entity_environment, arg.entity_environment_primitive_type, "cs_entity_environment", report);
+                    _check_entities(arg.cs_entity_robot, arg.entity_robot_primitive_type, "cs_entity_robot", report);
+                } else {
+                    _check_entities(arg.cs_entity_one, arg.entity_one_primitive_type, "cs_entity_one", report);
+                    _check_entities(arg.cs_entity_two, arg.entity_two_primitive_type, "cs_entity_two", report);
+                }
+            }, data);
+        });
+        rules_.emplace_back("types", [](const VFIConfigurationFile::Data& data, const bool&, const REPORT& report) {
+            std::visit([&](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                const VFI_TYPE vfi_type = std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA> ?
+                                              VFI_TYPE::ENVIRONMENT_TO_ROBOT : VFI_TYPE::ROBOT_TO_ROBOT;
+                if (static_cast<VFI_TYPE>(arg.vfi_type.id()) != vfi_type)
+                    report(SEVERITY::ERROR, "vfi_type '" + arg.vfi_type.str() + "' does not match the configuration");
+                const auto direction = static_cast<DIRECTION>(arg.direction.id());
+                if (direction != DIRECTION::SAFE_ZONE && direction != DIRECTION::RESTRICTED_ZONE)
+                    report(SEVERITY::ERROR, "Unknown direction '" + arg.direction.str() + "'");
+            }, data);
+        });
+        rules_.emplace_back("gains", [](const VFIConfigurationFile::Data& data, const bool&, const REPORT& report) {
+            std::visit([&](auto&& arg) {
+                // Written as negations, so NaN is rejected as well
+                if (!(arg.safe_distance > 0))
+                    report(SEVERITY::ERROR, "safe_distance " + to_string(arg.safe_distance) + " is not positive");
+                if (!(arg.vfi_gain > 0))
+                    report(SEVERITY::ERROR, "vfi_gain " + to_string(arg.vfi_gain) + " is not positive");
+            }, data);
+        });
+    }
+};
+
+/**
+ * @brief ConstraintValidator::ConstraintValidator creates a validator with the built-in rules.
+ * @param zero_indexed True if the robot and joint indices start at zero, as in the configuration file.
+ */
+ConstraintValidator::ConstraintValidator(const bool& zero_indexed)
+{
+    impl_ = std::make_shared<ConstraintValidator::Impl>(zero_indexed);
+    impl_->_add_builtin_rules();
+}
+
+/**
+ * @brief ConstraintValidator::set_number_of_joints sets the upper limits of the indices checked
+ *        by the "indices" rule. Without limits, only the lower limits are checked.
+ * @param number_of_joints The number of joints of each robot, in robot order.
+ */
+void ConstraintValidator::set_number_of_joints(const std::vector<int>& number_of_joints)
+{
+    impl_->number_of_joints_ = number_of_joints;
+}
+
+/**
+ * @brief ConstraintValidator::set_number_of_threads sets the number of threads used by validate.
+ *        The constraints are only split when there are enough of them for each thread. If zero,
+ *        std::thread::hardware_concurrency() is used. Default: 0.
+ * @param number_of_threads The desired number of threads.
+ */
+void ConstraintValidator::set_number_of_threads(const int& number_of_threads)
+{
+    impl_->number_of_threads_ = number_of_threads;
+}
+
+/**
+ * @brief ConstraintValidator::add_rule adds a rule, or replaces the rule with the same name.
+ * @param name The name of the rule, which is copied into its diagnostics.
+ * @param check The check of the rule. It is called from several threads, so it must not modify
+ *        shared state without synchronization.
+ */
+void ConstraintValidator::add_rule(const std::string& name, const CHECK& check)
+{
+    auto it = std::find_if(impl_->rules_.begin(), impl_->rules_.end(),
+                           [&name](const auto& rule) { return rule.first == name; });
+    auto rule = [check](const VFIConfigurationFile::Data& data, const bool&, const REPORT& report) { check(data, report); };
+    if (it != impl_->rules_.end())
+        it->second = rule;
+    else
+        impl_->rules_.emplace_back(name, rule);
+}
+
+/**
+ * @brief ConstraintValidator::remove_rule removes a rule, including a built-in one.
+ * @param name The name of the rule.
+ */
+void ConstraintValidator::remove_rule(const std::string& name)
+{
+    impl_->rules_.erase(std::remove_if(impl_->rules_.begin(), impl_->rules_.end(),
+                                       [&name](const auto& rule) { return rule.first == name; }),
+                        impl_->rules_.end());
+}
+
+std::vector<std::string> ConstraintValidator::get_rule_names() const
+{
+    std::vector<std::string> names;
+    for (const auto& rule : impl_->rules_)
+        names.push_back(rule.first);
+    return names;
+}
+
+/**
+ * @brief ConstraintValidator::validate checks constraints with all the rules.
+ * @param data The constraints.
+ * @return The diagnostics, in the order of the constraints and then of the rules.
+ */
+std::vector<ConstraintValidator::DIAGNOSTIC> ConstraintValidator::validate(const std::vector<VFIConfigurationFile::Data>& data) const
+{
+    std::vector<const VFIConfigurationFile::Data*> pointers;
+    pointers.reserve(data.size());
+    for (const auto& item : data)
+        pointers.push_back(&item);
+    return validate(pointers);
+}
+
+/**
+ * @brief ConstraintValidator::validate checks constraints with all the rules, without copying them.
+ * @param data The constraints.
+ * @return The diagnostics, in the order of the constraints and then of the rules.
+ */
+std::vector<ConstraintValidator::DIAGNOSTIC> ConstraintValidator::validate(const std::vector<const VFIConfigurationFile::Data*>& data) const
+{
+    return validate(data, impl_->zero_indexed_);
+}
+
+/**
+ * @brief ConstraintValidator::validate checks constraints with all the rules, without copying them,
+ *        for a file that uses another index convention than the one of the validator.
+ * @param data The constraints.
+ * @param zero_indexed True if the robot and joint indices start at zero in the file.
+ * @return The diagnostics, in the order of the constraints and then of the rules.
+ */
+std::vector<ConstraintValidator::DIAGNOSTIC> ConstraintValidator::validate(const std::vector<const VFIConfigurationFile::Data*>& data,
+                                                                           const bool& zero_indexed) const
+{
+    constexpr std::size_t minimum_chunk_size = 16384;
+    const std::size_t number_of_threads = (impl_->number_of_threads_ > 0) ?
+                                              static_cast<std::size_t>(impl_->number_of_threads_) :
+                                              std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t number_of_chunks = std::min(number_of_threads, std::max<std::size_t>(1, data.size() / minimum_chunk_size));
+    std::vector<std::vector<DIAGNOSTIC>> chunk_diagnostics(number_of_chunks);
+
+    auto validate_chunk = [&](const std::size_t& chunk) {
+        auto& diagnostics = chunk_diagnostics[chunk];
+        std::size_t index = 0;
+        const std::string* rule = nullptr;
+        // A single REPORT per chunk, which reads the constraint and the rule being checked
+        const REPORT report = [&](const SEVERITY& severity, const std::string& message) {
+            diagnostics.push_back(DIAGNOSTIC{index, std::visit([](auto&& arg) { return arg.tag; }, *data[index]),
+                                             *rule, severity, message});
+        };
+        const std::size_t end = data.size() * (chunk + 1) / number_of_chunks;
+        for (index = data.size() * chunk / number_of_chunks; index < end; ++index)
+        {
+            for (const auto& [name, check] : impl_->rules_)
+            {
+                rule = &name;
+                check(*data[index], zero_indexed, report);
+            }
+        }
+    };
+
+    if (number_of_chunks > 1)
+    {
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> exceptions(number_of_chunks);
+        for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk)
+        {
+            threads.emplace_back([&, chunk]() {
+                try {
+                    validate_chunk(chunk);
+                } catch (...) {
+                    exceptions[chunk] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& exception : exceptions)
+            if (exception)
+                std::rethrow_exception(exception);
+    }
+    else
+    {
+        validate_chunk(0);
+    }
+
+    std::vector<DIAGNOSTIC> diagnostics;
+    for (auto& chunk : chunk_diagnostics)
+        diagnostics.insert(diagnostics.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+    return diagnostics;
+}
+
+/**
+ * @brief ConstraintValidator::has_errors checks if any diagnostic is an error.
+ * @param diagnostics The diagnostics.
+ * @return True if a diagnostic has the ERROR severity. False otherwise.
+ */
+bool ConstraintValidator::has_errors(const std::vector<DIAGNOSTIC>& diagnostics)
+{
+    return std::any_of(diagnostics.begin(), diagnostics.end(),
+                       [](const DIAGNOSTIC& diagnostic) { return diagnostic.severity == SEVERITY::ERROR; });
+}
+
+}
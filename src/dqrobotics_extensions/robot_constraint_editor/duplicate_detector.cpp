@@ -0,0 +1,208 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+*/
+
+
+#include <dqrobotics_extensions/robot_constraint_editor/duplicate_detector.hpp>
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+
+namespace DQ_robotics_extensions
+{
+
+namespace
+{
+
+void hash_combine(std::size_t& seed, const std::size_t& hash)
+{
+    seed ^= hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * @brief hash_side hashes a side of a constraint: its entities, in order, their primitive type,
+ *        and the robot and joint indices.
+ */
+std::size_t hash_side(const VFIConfigurationFile::EntityList& entities, const Symbol& primitive_type,
+                      const int& robot_index, const int& joint_index)
+{
+    std::size_t seed = primitive_type.hash();
+    for (const auto& entity : entities)
+        hash_combine(seed, entity.hash());
+    hash_combine(seed, std::hash<int>()(robot_index));
+    hash_combine(seed, std::hash<int>()(joint_index));
+    return seed;
+}
+
+auto side_one(const VFIConfigurationFile::ROBOT_TO_ROBOT_DATA& data)
+{
+    return std::tie(data.cs_entity_one, data.entity_one_primitive_type, data.robot_index_one, data.joint_index_one);
+}
+
+auto side_two(const VFIConfigurationFile::ROBOT_TO_ROBOT_DATA& data)
+{
+    return std::tie(data.cs_entity_two, data.entity_two_primitive_type, data.robot_index_two, data.joint_index_two);
+}
+
+/**
+ * @brief stricter gets the stricter of two safe distances: the larger one keeps the robot farther
+ *        from a RESTRICTED_ZONE, and the smaller one keeps it deeper in a SAFE_ZONE.
+ */
+double stricter(const Symbol& direction, const double& safe_distance, const double& other)
+{
+    if (static_cast<DIRECTION>(direction.id()) == DIRECTION::SAFE_ZONE)
+        return std::min(safe_distance, other);
+    return std::max(safe_distance, other);
+}
+
+template<typename Function>
+auto visit_common(const VFIConfigurationFile::Data& data, Function&& function)
+{
+    return std::visit([&function](auto&& arg) { return function(arg); }, data);
+}
+
+}
+
+/**
+ * @brief DuplicateDetector::canonical_hash hashes the canonical form of a constraint, which
+ *        ignores the tag, safe_distance and vfi_gain, and the order of the sides of a
+ *        ROBOT_TO_ROBOT constraint.
+ * @param data The constraint.
+ * @return The desired hash. Duplicates have the same hash.
+ */
+std::size_t DuplicateDetector::canonical_hash(const VFIConfigurationFile::Data& data)
+{
+    return std::visit([](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+        std::size_t seed = arg.vfi_type.hash();
+        hash_combine(seed, arg.direction.hash());
+        if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+            hash_combine(seed, hash_side(arg.cs_entity_environment, arg.entity_environment_primitive_type, 0, 0));
+            hash_combine(seed, hash_side(arg.cs_entity_robot, arg.entity_robot_primitive_type, arg.robot_index, arg.joint_index));
+        } else {
+            const std::size_t one = hash_side(arg.cs_entity_one, arg.entity_one_primitive_type, arg.robot_index_one, arg.joint_index_one);
+            const std::size_t two = hash_side(arg.cs_entity_two, arg.entity_two_primitive_type, arg.robot_index_two, arg.joint_index_two);
+            hash_combine(seed, std::min(one, two));
+            hash_combine(seed, std::max(one, two));
+        }
+        return seed;
+    }, data);
+}
+
+/**
+ * @brief DuplicateDetector::is_duplicate checks if two constraints have the same canonical form.
+ * @param data The first constraint.
+ * @param other The second constraint.
+ * @return True if the constraints are duplicates. False otherwise.
+ */
+bool DuplicateDetector::is_duplicate(const VFIConfigurationFile::Data& data, const VFIConfigurationFile::Data& other)
+{
+    if (data.index() != other.index())
+        return false;
+    if (const auto environment_to_robot = std::get_if<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(&data)) {
+        const auto& a = *environment_to_robot;
+        const auto& b = std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(other);
+        return a.vfi_type == b.vfi_type && a.direction == b.direction &&
+               a.cs_entity_environment == b.cs_entity_environment &&
+               a.entity_environment_primitive_type == b.entity_environment_primitive_type &&
+               a.cs_entity_robot == b.cs_entity_robot && a.entity_robot_primitive_type == b.entity_robot_primitive_type &&
+               a.robot_index == b.robot_index && a.joint_index == b.joint_index;
+    }
+    const auto& a = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(data);
+    const auto& b = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(other);
+    return a.vfi_type == b.vfi_type && a.direction == b.direction &&
+           ((side_one(a) == side_one(b) && side_two(a) == side_two(b)) ||
+            (side_one(a) == side_two(b) && side_two(a) == side_one(b)));
+}
+
+/**
+ * @brief DuplicateDetector::strictest_safe_distance gets the stricter safe_distance of two
+ *        duplicates: the larger one for a RESTRICTED_ZONE, and the smaller one for a SAFE_ZONE.
+ * @param data The first constraint.
+ * @param other The second constraint.
+ * @return The desired safe_distance.
+ */
+double DuplicateDetector::strictest_safe_distance(const VFIConfigurationFile::Data& data, const VFIConfigurationFile::Data& other)
+{
+    return stricter(visit_common(data, [](auto&& arg) { return arg.direction; }),
+                    visit_common(data, [](auto&& arg) { return arg.safe_distance; }),
+                    visit_common(other, [](auto&& arg) { return arg.safe_distance; }));
+}
+
+/**
+ * @brief DuplicateDetector::find_duplicates groups the duplicate constraints.
+ * @param data The constraints.
+ * @return The groups of two or more constraints, ordered by their first constraint.
+ */
+std::vector<DuplicateDetector::GROUP> DuplicateDetector::find_duplicates(const std::vector<VFIConfigurationFile::Data>& data)
+{
+    std::vector<const VFIConfigurationFile::Data*> pointers;
+    pointers.reserve(data.size());
+    for (const auto& item : data)
+        pointers.push_back(&item);
+    return find_duplicates(pointers);
+}
+
+/**
+ * @brief DuplicateDetector::find_duplicates groups the duplicate constraints, without copying them.
+ * @param data The constraints.
+ * @return The groups of two or more constraints, ordered by their first constraint.
+ */
+std::vector<DuplicateDetector::GROUP> DuplicateDetector::find_duplicates(const std::vector<const VFIConfigurationFile::Data*>& data)
+{
+    auto get_tag = [](const VFIConfigurationFile::Data& item) { return visit_common(item, [](auto&& arg) { return arg.tag; }); };
+    auto get_safe_distance = [](const VFIConfigurationFile::Data& item) {
+        return visit_common(item, [](auto&& arg) { return arg.safe_distance; });
+    };
+    auto get_vfi_gain = [](const VFIConfigurationFile::Data& item) { return visit_common(item, [](auto&& arg) { return arg.vfi_gain; }); };
+
+    // The first constraint of each canonical form, by hash. Different forms may share a hash.
+    std::unordered_map<std::size_t, std::vector<std::size_t>> firsts;
+    firsts.reserve(data.size());
+    std::unordered_map<std::size_t, std::size_t> groups_by_first;
+    std::vector<GROUP> groups;
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        auto& candidates = firsts[canonical_hash(*data[i])];
+        const auto first = std::find_if(candidates.begin(), candidates.end(),
+                                        [&](const std::size_t& candidate) { return is_duplicate(*data[candidate], *data[i]); });
+        if (first == candidates.end()) {
+            candidates.push_back(i);
+            continue;
+        }
+
+        const auto& first_data = *data[*first];
+        const auto [it, inserted] = groups_by_first.try_emplace(*first, groups.size());
+        if (inserted)
+            groups.push_back(GROUP{{*first}, {get_tag(first_data)}, get_safe_distance(first_data), false});
+        auto& group = groups[it->second];
+        group.indices.push_back(i);
+        group.tags.push_back(get_tag(*data[i]));
+        group.conflicting = group.conflicting || get_safe_distance(*data[i]) != get_safe_distance(first_data) ||
+                            get_vfi_gain(*data[i]) != get_vfi_gain(first_data);
+        group.safe_distance = stricter(visit_common(first_data, [](auto&& arg) { return arg.direction; }),
+                                       group.safe_distance, get_safe_distance(*data[i]));
+    }
+    std::sort(groups.begin(), groups.end(),
+              [](const GROUP& group, const GROUP& other) { return group.indices.front() < other.indices.front(); });
+    return groups;
+}
+
+}
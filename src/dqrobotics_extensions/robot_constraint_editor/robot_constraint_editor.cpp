@@ -22,8 +22,26 @@
 */
 
 #include <dqrobotics_extensions/robot_constraint_editor/robot_constraint_editor.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/ordered_hash_map.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/persistent_hash_map.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/persistent_vector.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
-#include <map>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 
@@ -31,22 +49,1417 @@
 namespace DQ_robotics_extensions
 {
 
+namespace
+{
+
+/**
+ * The edit journal is a file of records that follow an 8-byte header ("VFIJ" and a u32 format
+ * version). Each record is [u32 payload size][u32 checksum of the payload][payload], and its
+ * payload is either
+ *
+ *   PUT:    u8 journal_put, u8 VFI type (0 = ENVIRONMENT_TO_ROBOT, 1 = ROBOT_TO_ROBOT), fields
+ *   ERASE:  u8 journal_erase, tag
+ *   RENAME: u8 journal_rename, previous tag, u8 VFI type, fields
+ *   GROUP:  u8 journal_group, u32 count, payloads (each a u32 size followed by the bytes)
+ *
+ * The fields follow the order of DATA_FIELDS, so a new field is journaled without changes here.
+ * Integers are little-endian, doubles are stored as their IEEE-754 bits, strings are a u32 size
+ * followed by the bytes, and entity lists are a u32 size followed by the strings. The records
+ * hold whole entries, so replaying a record that is already reflected in the configuration file
+ * is harmless. A RENAME is a PUT that keeps the position of the entry with the previous tag in
+ * the file. A GROUP holds the records of a Transaction under one checksum, so a crash keeps all of
+ * them or none. The format version 2 is version 3 without GROUP records.
+ */
+constexpr char journal_magic[4] = {'V', 'F', 'I', 'J'};
+constexpr std::uint32_t journal_format_version = 3;
+constexpr std::size_t journal_header_size = 8;
+constexpr std::uint8_t journal_put = 1;
+constexpr std::uint8_t journal_erase = 2;
+constexpr std::uint8_t journal_rename = 3;
+constexpr std::uint8_t journal_group = 4;
+
+std::uint32_t journal_checksum(const char* data, const std::size_t& size)
+{
+    std::uint32_t hash = 2166136261u; // FNV-1a
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class JournalWriter
+{
+public:
+    std::string bytes;
+
+    void u8(const std::uint8_t& value)
+    {
+        bytes += static_cast<char>(value);
+    }
+
+    void u32(const std::uint32_t& value)
+    {
+        for (int i = 0; i < 4; ++i)
+            bytes += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void u64(const std::uint64_t& value)
+    {
+        for (int i = 0; i < 8; ++i)
+            bytes += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void i32(const int& value)
+    {
+        u32(static_cast<std::uint32_t>(value));
+    }
+
+    void f64(const double& value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void string(const std::string& value)
+    {
+        u32(static_cast<std::uint32_t>(value.size()));
+        bytes += value;
+    }
+
+    void list(const VFIConfigurationFile::EntityList& values)
+    {
+        u32(static_cast<std::uint32_t>(values.size()));
+        for (const auto& value : values)
+            string(value);
+    }
+
+    template<typename T>
+    void field(const T& value)
+    {
+        if constexpr (std::is_same_v<T, VFIConfigurationFile::EntityList>)
+            list(value);
+        else if constexpr (std::is_same_v<T, Symbol> || std::is_same_v<T, std::string>)
+            string(value);
+        else if constexpr (std::is_same_v<T, int>)
+            i32(value);
+        else
+            f64(value);
+    }
+
+    void data(const VFIConfigurationFile::Data& data)
+    {
+        u8(static_cast<std::uint8_t>(data.index()));
+        std::visit([this](auto&& arg) {
+            for_each_field(arg, [this](auto, const auto& value) { field(value); });
+        }, data);
+    }
+
+    /**
+     * @brief record frames a payload as a journal record.
+     * @param payload The payload.
+     * @return The record.
+     */
+    static std::string record(const std::string& payload)
+    {
+        JournalWriter writer;
+        writer.u32(static_cast<std::uint32_t>(payload.size()));
+        writer.u32(journal_checksum(payload.data(), payload.size()));
+        writer.bytes += payload;
+        return writer.bytes;
+    }
+};
+
+/**
+ * @brief The JournalReader class reads the fields written by JournalWriter. Every read fails,
+ *        instead of reading past the end, if the input is too short.
+ */
+class JournalReader
+{
+    const char* p_;
+    const char* end_;
+public:
+    JournalReader(const char* first, const char* last)
+        : p_(first), end_(last)
+    {
+    }
+
+    bool at_end() const
+    {
+        return p_ == end_;
+    }
+
+    bool u8(std::uint8_t& value)
+    {
+        if (end_ - p_ < 1)
+            return false;
+        value = static_cast<std::uint8_t>(*p_++);
+        return true;
+    }
+
+    bool u32(std::uint32_t& value)
+    {
+        if (end_ - p_ < 4)
+            return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<std::uint32_t>(static_cast<unsigned char>(*p_++)) << (8 * i);
+        return true;
+    }
+
+    bool u64(std::uint64_t& value)
+    {
+        if (end_ - p_ < 8)
+            return false;
+        value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(*p_++)) << (8 * i);
+        return true;
+    }
+
+    bool i32(int& value)
+    {
+        std::uint32_t bits;
+        if (!u32(bits))
+            return false;
+        value = static_cast<int>(bits);
+        return true;
+    }
+
+    bool f64(double& value)
+    {
+        std::uint64_t bits;
+        if (!u64(bits))
+            return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool string(std::string& value)
+    {
+        std::uint32_t size;
+        if (!u32(size) || static_cast<std::size_t>(end_ - p_) < size)
+            return false;
+        value.assign(p_, size);
+        p_ += size;
+        return true;
+    }
+
+    bool string(Symbol& value)
+    {
+        std::string text;
+        if (!string(text))
+            return false;
+        value = text;
+        return true;
+    }
+
+    bool list(VFIConfigurationFile::EntityList& values)
+    {
+        std::uint32_t size;
+        if (!u32(size) || static_cast<std::size_t>(end_ - p_) < size)
+            return false;
+        values.resize(size);
+        for (auto& value : values)
+            if (!string(value))
+                return false;
+        return true;
+    }
+
+    template<typename T>
+    bool field(T& value)
+    {
+        if constexpr (std::is_same_v<T, VFIConfigurationFile::EntityList>)
+            return list(value);
+        else if constexpr (std::is_same_v<T, Symbol> || std::is_same_v<T, std::string>)
+            return string(value);
+        else if constexpr (std::is_same_v<T, int>)
+            return i32(value);
+        else
+            return f64(value);
+    }
+
+    bool data(VFIConfigurationFile::Data& data)
+    {
+        std::uint8_t type;
+        if (!u8(type) || type > 1)
+            return false;
+        if (type == 0)
+            data = VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA();
+        else
+            data = VFIConfigurationFile::ROBOT_TO_ROBOT_DATA();
+        return std::visit([this](auto&& arg) {
+            bool valid = true;
+            for_each_field(arg, [this, &valid](auto, auto& value) { valid = valid && field(value); });
+            return valid;
+        }, data);
+    }
+};
+
+/**
+ * @brief read_journal_record decodes the payload of a journal record.
+ * @param first The first byte of the payload.
+ * @param last One past the last byte of the payload.
+ * @param put Called with the previous tag, which is empty unless the record is a RENAME, and the
+ *        constraint of a PUT or a RENAME.
+ * @param erase Called with the tag of an ERASE.
+ * @return False if the payload is invalid. True otherwise. The records of an invalid GROUP are
+ *         checked before any of them is applied.
+ */
+template<typename Put, typename Erase>
+bool read_journal_record(const char* first, const char* last, Put&& put, Erase&& erase)
+{
+    JournalReader record(first, last);
+    std::uint8_t operation = 0;
+    std::string tag;
+    VFIConfigurationFile::Data data;
+    if (record.u8(operation) && (operation == journal_put || operation == journal_rename) &&
+        (operation == journal_put || record.string(tag)) && record.data(data) && record.at_end())
+        put(tag, std::move(data));
+    else if (operation == journal_erase && record.string(tag) && record.at_end())
+        erase(tag);
+    else if (operation == journal_group)
+    {
+        std::uint32_t count = 0;
+        if (!record.u32(count))
+            return false;
+        std::vector<std::string> payloads(std::min<std::size_t>(count, static_cast<std::size_t>(last - first)));
+        for (auto& payload : payloads)
+            if (!record.string(payload) || payload.empty() || static_cast<std::uint8_t>(payload[0]) == journal_group)
+                return false;
+        if (payloads.size() != count || !record.at_end())
+            return false;
+        for (const auto& payload : payloads)
+            if (!read_journal_record(payload.data(), payload.data() + payload.size(), put, erase))
+                return false;
+    }
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief append_to_file appends bytes to a file descriptor.
+ * @return True if all the bytes were written. False otherwise.
+ */
+bool append_to_file(const int& fd, const std::string& bytes)
+{
+    const char* data = bytes.data();
+    std::size_t remaining = bytes.size();
+    while (remaining > 0) {
+        const ssize_t written = ::write(fd, data, remaining);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+}
+
 // Explicit instantiations for all expected types
 template void RobotConstraintEditor::edit_data<int>(const std::string&, const std::string&, const int&);
 template void RobotConstraintEditor::edit_data<double>(const std::string&, const std::string&, const double&);
 template void RobotConstraintEditor::edit_data<std::string>(const std::string&, const std::string&, const std::string&);
 template void RobotConstraintEditor::edit_data<std::vector<std::string>>(const std::string&, const std::string&, const std::vector<std::string>&);
+template void RobotConstraintEditor::edit_data<int>(const ConstraintId&, const std::string&, const int&);
+template void RobotConstraintEditor::edit_data<double>(const ConstraintId&, const std::string&, const double&);
+template void RobotConstraintEditor::edit_data<std::string>(const ConstraintId&, const std::string&, const std::string&);
+template void RobotConstraintEditor::edit_data<std::vector<std::string>>(const ConstraintId&, const std::string&, const std::vector<std::string>&);
+template void RobotConstraintEditor::Transaction::edit_data<int>(const std::string&, const std::string&, const int&);
+template void RobotConstraintEditor::Transaction::edit_data<double>(const std::string&, const std::string&, const double&);
+template void RobotConstraintEditor::Transaction::edit_data<std::string>(const std::string&, const std::string&, const std::string&);
+template void RobotConstraintEditor::Transaction::edit_data<std::vector<std::string>>(const std::string&, const std::string&, const std::vector<std::string>&);
+
+
 
+/**
+ * @brief The State struct holds the contents of a snapshot: the constraints by their position in
+ *        the map of the editor (nullptr for the holes), and the positions by tag. Both are
+ *        persistent, so the snapshots share everything but the paths to the constraints that
+ *        changed between them.
+ */
+struct RobotConstraintEditor::Snapshot::State
+{
+    PersistentVector<std::shared_ptr<const VFIConfigurationFile::Data>> entries;
+    PersistentHashMap<std::string, std::size_t> positions;
+};
+
+class RobotConstraintEditor::Impl
+{
+public:
+    const int vfi_file_version_ = 2; // default value
+    bool zero_indexed_ = true; // default value
+    std::shared_ptr<VFIConfigurationFile> interface_;
+
+    bool lazy_loading_ = false; // default value
+
+    /**
+     * @brief The ENTRY struct stores a constraint of the editor. The entries loaded lazily keep
+     *        the text they were indexed from, and are decoded the first time they are accessed.
+     *        The text is dropped when the entry is modified (the entry is dirty), and save_data
+     *        serializes the dirty entries again. The other entries are saved verbatim.
+     */
+    struct ENTRY{
+        std::optional<VFIConfigurationFile::Data> data;
+        std::optional<VFIConfigurationFile::LAZY_ENTRY> lazy_entry;
+        std::uint32_t handle = 0; // The index of the entry in the handle table
+        std::shared_ptr<const VFIConfigurationFile::Data> published = nullptr; // The copy shared by the snapshots
+    };
+
+    // The arena of the entity lists. It is declared before the map, so it outlives the entries.
+    std::unique_ptr<std::pmr::memory_resource> arena_;
+
+    // The entries in file order. New entries are added at the end.
+    OrderedHashMap<std::string, ENTRY> yaml_raw_data_map_;
+
+    /**
+     * @brief The HANDLE struct is an element of the handle table, which maps the ConstraintIds to
+     *        the positions of the entries in the map. The generation changes when the entry is
+     *        removed, so the ConstraintIds of the removed entry become invalid.
+     */
+    struct HANDLE{
+        std::uint32_t generation;
+        std::size_t position;
+        bool in_use;
+    };
+
+    std::vector<HANDLE> handles_;
+    std::vector<std::uint32_t> free_handles_;
+    std::size_t handle_compactions_ = 0; // The map compactions reflected in the handle positions
+
+    /**
+     * @brief _insert_entry inserts an entry that is not in the map, and gives it a handle.
+     * @param tag The tag of the entry.
+     * @param entry The entry.
+     * @param order The order key of a removed entry, where the entry is inserted back (see
+     *        OrderedHashMap::try_emplace_ordered). Default: the end of the map.
+     * @return The inserted entry.
+     */
+    ENTRY& _insert_entry(const std::string& tag, ENTRY&& entry, const std::optional<std::uint64_t>& order = std::nullopt)
+    {
+        if (free_handles_.empty())
+        {
+            if (handles_.size() >= std::numeric_limits<std::uint32_t>::max())
+                throw std::runtime_error("Too many constraints in the RobotConstraintEditor!");
+            free_handles_.push_back(static_cast<std::uint32_t>(handles_.size()));
+            handles_.push_back(HANDLE{1, 0, false});
+        }
+        std::size_t inserted_position = yaml_raw_data_map_.position_end();
+        if (order)
+            inserted_position = yaml_raw_data_map_.try_emplace_ordered(*order, tag, std::move(entry)).first;
+        else
+            yaml_raw_data_map_.try_emplace(tag, std::move(entry));
+        auto& inserted = yaml_raw_data_map_.at_position(inserted_position)->second;
+        inserted.handle = free_handles_.back();
+        free_handles_.pop_back();
+        handles_[inserted.handle].position = inserted_position;
+        handles_[inserted.handle].in_use = true;
+        _version_insert(tag, inserted, inserted_position);
+        return inserted;
+    }
+
+    /**
+     * @brief _erase_entry removes an entry, if it is in the map, and invalidates its handle.
+     * @param tag The tag of the entry.
+     */
+    void _erase_entry(const std::string& tag)
+    {
+        const auto it = yaml_raw_data_map_.find(tag);
+        if (it == yaml_raw_data_map_.end())
+            return;
+        HANDLE& handle = handles_[it->second.handle];
+        handle.generation = (handle.generation == std::numeric_limits<std::uint32_t>::max()) ? 1 : handle.generation + 1;
+        handle.in_use = false;
+        free_handles_.push_back(it->second.handle);
+        _version_erase(tag);
+        yaml_raw_data_map_.erase(tag);
+    }
+
+    /**
+     * @brief _find_entry resolves a ConstraintId. The positions of the handles are updated first
+     *        if the map was compacted.
+     * @return The entry, or nullptr if the ConstraintId is invalid.
+     */
+    ENTRY* _find_entry(const std::uint32_t& index, const std::uint32_t& generation)
+    {
+        if (index >= handles_.size() || !handles_[index].in_use || handles_[index].generation != generation)
+            return nullptr;
+        if (handle_compactions_ != yaml_raw_data_map_.compactions())
+        {
+            for (std::size_t position = 0; position < yaml_raw_data_map_.position_end(); ++position)
+                if (const auto pair = yaml_raw_data_map_.at_position(position))
+                    handles_[pair->second.handle].position = position;
+            handle_compactions_ = yaml_raw_data_map_.compactions();
+        }
+        return &yaml_raw_data_map_.at_position(handles_[index].position)->second;
+    }
+
+    bool concurrent_mode_ = false; // default value
+    bool versioning_ = false; // True once a snapshot was requested
+    bool version_stale_ = true; // True if version_ must be rebuilt at the next snapshot
+    std::size_t version_compactions_ = 0; // The map compactions reflected in version_
+    std::vector<std::uint32_t> version_dirty_; // The handles of the entries modified since the last snapshot
+    Snapshot::State version_; // The current version of the constraints
+    std::shared_ptr<const Snapshot::State> version_snapshot_; // The snapshot of version_, if it was taken
+    std::size_t batch_depth_ = 0; // The nested BATCHes
+    mutable std::mutex snapshot_mutex_; // Guards the published snapshot pointer only
+    std::shared_ptr<const Snapshot::State> snapshot_;
 
+    /**
+     * @brief The BATCH struct groups the modifications made while it exists into a single snapshot
+     *        and a single undo step, which the _commit() call that follows it publishes.
+     */
+    struct BATCH{
+        Impl& impl;
+        explicit BATCH(Impl& impl_) : impl(impl_) { ++impl.batch_depth_; }
+        ~BATCH() { --impl.batch_depth_; }
+        BATCH(const BATCH&) = delete;
+        BATCH& operator=(const BATCH&) = delete;
+    };
+
+    /**
+     * @brief _version_current checks if the positions of version_ are those of the map. They are
+     *        not after a compaction of the map, which rebuilds version_ at the next snapshot.
+     */
+    bool _version_current() const
+    {
+        return versioning_ && !version_stale_ && version_compactions_ == yaml_raw_data_map_.compactions();
+    }
+
+    /**
+     * @brief _touch marks a modified entry, whose copy is replaced in the next snapshot.
+     * @param entry The entry.
+     */
+    void _touch(ENTRY& entry)
+    {
+        if (entry.published)
+        {
+            entry.published.reset();
+            version_dirty_.push_back(entry.handle);
+        }
+    }
+
+    void _version_insert(const std::string& tag, const ENTRY& entry, const std::size_t& position)
+    {
+        if (!_version_current())
+            return;
+        version_.positions.insert_or_assign(tag, position);
+        version_dirty_.push_back(entry.handle);
+        version_snapshot_.reset();
+        // Without snapshots, the handles of the replaced entries would pile up
+        if (version_dirty_.size() > 2 * yaml_raw_data_map_.size() + 64)
+            version_stale_ = true;
+    }
+
+    void _version_erase(const std::string& tag)
+    {
+        if (!_version_current())
+            return;
+        if (const auto position = version_.positions.find(tag))
+            version_.entries.set(*position, nullptr);
+        version_.positions.erase(tag);
+        version_snapshot_.reset();
+    }
+
+    void _version_rename(const std::string& tag, const std::string& new_tag)
+    {
+        if (!_version_current())
+            return;
+        const std::size_t position = *version_.positions.find(tag);
+        version_.positions.erase(tag);
+        version_.positions.insert_or_assign(new_tag, position);
+        version_snapshot_.reset();
+    }
+
+    /**
+     * @brief _snapshot gets the snapshot of the current version of the constraints. Taking the
+     *        snapshot of an unmodified editor is O(1). Each modified constraint is copied once,
+     *        and only the paths to it are copied in the persistent structures. The first snapshot,
+     *        and the first one after a compaction of the map, build the structures at once.
+     * @return The desired snapshot.
+     */
+    std::shared_ptr<const Snapshot::State> _snapshot()
+    {
+        versioning_ = true;
+        if (version_stale_ || version_compactions_ != yaml_raw_data_map_.compactions())
+        {
+            std::vector<std::shared_ptr<const VFIConfigurationFile::Data>> entries(yaml_raw_data_map_.position_end());
+            std::vector<std::pair<std::string, std::size_t>> positions;
+            positions.reserve(yaml_raw_data_map_.size());
+            for (std::size_t position = 0; position < yaml_raw_data_map_.position_end(); ++position)
+            {
+                if (const auto pair = yaml_raw_data_map_.at_position(position))
+                {
+                    auto& entry = pair->second;
+                    if (!entry.published)
+                        entry.published = std::make_shared<const VFIConfigurationFile::Data>(_materialize(entry));
+                    entries[position] = entry.published;
+                    positions.emplace_back(pair->first, position);
+                }
+            }
+            version_.entries = PersistentVector<std::shared_ptr<const VFIConfigurationFile::Data>>(std::move(entries));
+            version_.positions = PersistentHashMap<std::string, std::size_t>(std::move(positions));
+            version_compactions_ = yaml_raw_data_map_.compactions();
+            version_stale_ = false;
+            version_dirty_.clear();
+            version_snapshot_.reset();
+        }
+        for (const auto& handle : version_dirty_)
+        {
+            if (!handles_[handle].in_use)
+                continue;
+            auto& entry = *_find_entry(handle, handles_[handle].generation);
+            if (entry.published)
+                continue;
+            entry.published = std::make_shared<const VFIConfigurationFile::Data>(_materialize(entry));
+            version_.entries.set(handles_[handle].position, entry.published);
+            version_snapshot_.reset();
+        }
+        version_dirty_.clear();
+        if (!version_snapshot_)
+            version_snapshot_ = std::make_shared<const Snapshot::State>(version_);
+        return version_snapshot_;
+    }
+
+    /**
+     * @brief _stop_versioning drops the versions of the constraints. The snapshots that were
+     *        taken are not affected.
+     */
+    void _stop_versioning()
+    {
+        versioning_ = false;
+        version_stale_ = true;
+        version_ = Snapshot::State();
+        version_snapshot_.reset();
+        version_dirty_.clear();
+        for (auto& pair : yaml_raw_data_map_)
+            pair.second.published.reset();
+    }
+
+    /**
+     * @brief _publish publishes the snapshot of the current version in the concurrent mode. The
+     *        readers never wait for this work: they only copy the pointer to the last snapshot.
+     */
+    void _publish()
+    {
+        if (!concurrent_mode_ || batch_depth_ > 0)
+            return;
+        auto previous = _snapshot();
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            snapshot_.swap(previous);
+        }
+        // The previous snapshot is released outside the lock, by its last reader
+    }
+
+    /**
+     * @brief The PRESENCE_CHANGE struct records the addition or the removal of a constraint. It
+     *        holds the constraint while the constraint is out of the editor, and the order key
+     *        of the map where the constraint is restored, which survives the compactions.
+     */
+    struct PRESENCE_CHANGE{
+        std::string tag;
+        std::optional<VFIConfigurationFile::Data> data = std::nullopt;
+        std::uint64_t order = 0;
+    };
+
+    /**
+     * @brief The FIELD_CHANGE struct records the modification of a field of a constraint.
+     */
+    struct FIELD_CHANGE{
+        std::string tag; // The tag of the constraint after the modification
+        FIELD field;
+        FIELD_VALUE before;
+        FIELD_VALUE after;
+    };
+
+    using CHANGE = std::variant<PRESENCE_CHANGE, FIELD_CHANGE>;
+
+    /**
+     * @brief The STEP struct is an element of the undo and redo stacks: the changes made by a
+     *        modification of the editor, in the order they were made.
+     */
+    struct STEP{
+        std::vector<CHANGE> changes;
+        std::size_t bytes = 0;
+        std::chrono::steady_clock::time_point time;
+        bool coalescible = true; // False for the steps recorded by undo and redo
+    };
+
+    // Where the changes are recorded: the undo stack (a new modification), or the opposite stack
+    enum class RECORDING{
+        EDIT,
+        UNDO,
+        REDO
+    };
+
+    bool undo_mode_ = false; // default value
+    std::size_t undo_memory_limit_ = std::size_t(64) << 20; // default value
+    std::chrono::milliseconds undo_coalescing_window_{500}; // default value
+    RECORDING recording_ = RECORDING::EDIT;
+    std::deque<STEP> undo_;
+    std::deque<STEP> redo_;
+    std::size_t history_bytes_ = 0;
+    STEP pending_; // The changes of the modification in progress
+    std::optional<FIELD_VALUE> edit_before_; // The value of the field edited between _begin_edit and _end_edit
+
+    /**
+     * @brief _field_value gets the value of a field of a constraint.
+     * @return The desired value, or std::nullopt if the constraint has no such field.
+     */
+    static std::optional<FIELD_VALUE> _field_value(const VFIConfigurationFile::Data& data, const FIELD& field)
+    {
+        std::optional<FIELD_VALUE> value;
+        std::visit([&](auto&& arg) {
+            for_each_field(arg, [&](auto descriptor, const auto& field_value) {
+                if (descriptor.field == field)
+                    value.emplace(field_value);
+            });
+        }, data);
+        return value;
+    }
+
+    static std::size_t _bytes(const VFIConfigurationFile::EntityList& list)
+    {
+        return list.capacity() * sizeof(Symbol);
+    }
+
+    static std::size_t _bytes(const std::string& string)
+    {
+        return string.capacity();
+    }
+
+    template<typename T>
+    static std::size_t _bytes(const T&)
+    {
+        return 0;
+    }
+
+    /**
+     * @brief _bytes estimates the memory used by a change.
+     */
+    static std::size_t _bytes(const CHANGE& change)
+    {
+        std::size_t bytes = sizeof(CHANGE);
+        std::visit([&bytes](auto&& arg) {
+            using ChangeType = std::decay_t<decltype(arg)>;
+            bytes += arg.tag.capacity();
+            if constexpr (std::is_same_v<ChangeType, PRESENCE_CHANGE>)
+            {
+                if (arg.data)
+                    std::visit([&bytes](auto&& data) {
+                        for_each_field(data, [&bytes](auto, const auto& value) { bytes += _bytes(value); });
+                    }, *arg.data);
+            }
+            else
+            {
+                std::visit([&bytes](auto&& value) { bytes += _bytes(value); }, arg.before);
+                std::visit([&bytes](auto&& value) { bytes += _bytes(value); }, arg.after);
+            }
+        }, change);
+        return bytes;
+    }
+
+    /**
+     * @brief _record records a change of the modification in progress, in undo mode.
+     */
+    void _record(CHANGE&& change)
+    {
+        if (undo_mode_)
+            pending_.changes.push_back(std::move(change));
+    }
+
+    /**
+     * @brief _coalesce merges the pending step into the last undo step, if both modify the same
+     *        field of the same constraint within the coalescing window.
+     * @return True if the steps were merged.
+     */
+    bool _coalesce()
+    {
+        if (undo_coalescing_window_.count() == 0 || undo_.empty() || !undo_.back().coalescible || pending_.changes.size() != 1 ||
+            undo_.back().changes.size() != 1 || pending_.time - undo_.back().time > undo_coalescing_window_)
+            return false;
+        auto pending = std::get_if<FIELD_CHANGE>(&pending_.changes.front());
+        auto last = std::get_if<FIELD_CHANGE>(&undo_.back().changes.front());
+        if (!pending || !last || pending->field != last->field ||
+            (pending->field == FIELD::TAG ? std::get<std::string>(pending->before) != last->tag : pending->tag != last->tag))
+            return false;
+
+        STEP& step = undo_.back();
+        history_bytes_ -= step.bytes;
+        last->tag = std::move(pending->tag);
+        last->after = std::move(pending->after);
+        step.time = pending_.time;
+        pending_.changes.clear();
+        if (last->before == last->after)
+        {
+            undo_.pop_back();
+            return true;
+        }
+        step.bytes = sizeof(STEP) + _bytes(step.changes.front());
+        history_bytes_ += step.bytes;
+        return true;
+    }
+
+    /**
+     * @brief _trim_history drops the oldest undo steps, and then the farthest redo steps, until
+     *        the history fits in the memory limit.
+     */
+    void _trim_history()
+    {
+        while (history_bytes_ > undo_memory_limit_ && (!undo_.empty() || !redo_.empty()))
+        {
+            auto& stack = undo_.empty() ? redo_ : undo_;
+            history_bytes_ -= stack.front().bytes;
+            stack.pop_front();
+        }
+    }
+
+    /**
+     * @brief _commit_step pushes the pending changes into the undo stack, or into the opposite
+     *        stack when they were made by undo or redo. A new modification clears the redo stack.
+     */
+    void _commit_step()
+    {
+        if (pending_.changes.empty())
+            return;
+        pending_.time = std::chrono::steady_clock::now();
+        if (recording_ == RECORDING::EDIT)
+        {
+            for (const auto& step : redo_)
+                history_bytes_ -= step.bytes;
+            redo_.clear();
+            if (_coalesce())
+                return;
+        }
+        else
+            pending_.coalescible = false;
+        pending_.bytes = sizeof(STEP);
+        for (const auto& change : pending_.changes)
+            pending_.bytes += _bytes(change);
+        history_bytes_ += pending_.bytes;
+        (recording_ == RECORDING::UNDO ? redo_ : undo_).push_back(std::move(pending_));
+        pending_ = STEP();
+        _trim_history();
+    }
+
+    void _clear_history()
+    {
+        undo_.clear();
+        redo_.clear();
+        pending_ = STEP();
+        history_bytes_ = 0;
+    }
+
+    /**
+     * @brief _commit ends a modification of the editor: its changes become an undo step, and its
+     *        snapshot is published. Nothing is done while a BATCH is open.
+     */
+    void _commit()
+    {
+        if (batch_depth_ > 0)
+            return;
+        _commit_step();
+        _publish();
+    }
+
+    /**
+     * @brief The INDEXES struct stores the secondary indexes of the constraints: the tags by robot
+     *        index, by (robot index, joint index) and by entity name. The indexes are built by the
+     *        first query, and are updated by every modification after that.
+     */
+    struct INDEXES{
+        std::unordered_map<int, TagView::TagSet> robot;
+        std::unordered_map<std::uint64_t, TagView::TagSet> robot_joint;
+        std::unordered_map<Symbol, TagView::TagSet> entity;
+    };
+
+    std::optional<INDEXES> indexes_;
+    bool indexes_deferred_ = false; // True while a Transaction updates the indexes itself
+
+    static std::uint64_t _robot_joint_key(const int& robot_index, const int& joint_index)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(robot_index)) << 32) |
+               static_cast<std::uint32_t>(joint_index);
+    }
+
+    /**
+     * @brief _update_tag_set adds a tag to the set of a key, or removes it. A tag is removed
+     *        when it was removed as many times as it was added, and the empty sets are removed.
+     */
+    template<typename Key>
+    static void _update_tag_set(std::unordered_map<Key, TagView::TagSet>& index,
+                                const Key& key, const std::string& tag, const bool& add)
+    {
+        if (add)
+        {
+            ++index[key].try_emplace(tag, 0).first->second;
+            return;
+        }
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        auto tag_it = it->second.find(tag);
+        if (tag_it != it->second.end() && --tag_it->second == 0)
+        {
+            it->second.erase(tag);
+            if (it->second.empty())
+                index.erase(it);
+        }
+    }
+
+    /**
+     * @brief _update_indexes adds the keys of a constraint to the indexes, or removes them.
+     *        Nothing happens if the indexes are not built, or while their update is deferred.
+     * @param data The constraint.
+     * @param add True to add the keys. False to remove them.
+     */
+    void _update_indexes(const VFIConfigurationFile::Data& data, const bool& add)
+    {
+        if (!indexes_ || indexes_deferred_)
+            return;
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            auto update_robot = [&](const int& robot_index, const int& joint_index) {
+                _update_tag_set(indexes_->robot, robot_index, arg.tag, add);
+                _update_tag_set(indexes_->robot_joint, _robot_joint_key(robot_index, joint_index), arg.tag, add);
+            };
+            auto update_entities = [&](const VFIConfigurationFile::EntityList& entities) {
+                for (const auto& entity : entities)
+                    _update_tag_set(indexes_->entity, entity, arg.tag, add);
+            };
+            if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+                update_robot(arg.robot_index, arg.joint_index);
+                update_entities(arg.cs_entity_environment);
+                update_entities(arg.cs_entity_robot);
+            } else if constexpr (std::is_same_v<T, VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>) {
+                update_robot(arg.robot_index_one, arg.joint_index_one);
+                update_robot(arg.robot_index_two, arg.joint_index_two);
+                update_entities(arg.cs_entity_one);
+                update_entities(arg.cs_entity_two);
+            }
+        }, data);
+    }
+
+    /**
+     * @brief _get_indexes builds the indexes, if needed. The lazy entries are decoded.
+     * @return The indexes.
+     */
+    const INDEXES& _get_indexes()
+    {
+        if (!indexes_)
+        {
+            indexes_.emplace();
+            for (auto& pair : yaml_raw_data_map_)
+                _update_indexes(_materialize(pair.second), true);
+        }
+        return *indexes_;
+    }
+
+    /**
+     * @brief The SAVE_STATE struct describes the file written by the last save_data. It is
+     *        cleared when the data is modified.
+     */
+    struct SAVE_STATE{
+        std::string path_config_file;
+        int vfi_file_version;
+        bool zero_indexed;
+        std::filesystem::file_time_type write_time;
+        std::uintmax_t file_size;
+    };
+
+    std::optional<SAVE_STATE> last_save_;
+
+    /**
+     * @brief _is_saved checks if the data is already saved in a file with the same parameters,
+     *        and the file was not modified since then.
+     * @return True if the file is up to date. False otherwise.
+     */
+    bool _is_saved(const std::string& path_config_file, const int& vfi_file_version, const bool& zero_indexed) const
+    {
+        if (!last_save_ || last_save_->path_config_file != path_config_file ||
+            last_save_->vfi_file_version != vfi_file_version || last_save_->zero_indexed != zero_indexed)
+            return false;
+        std::error_code error;
+        const auto write_time = std::filesystem::last_write_time(path_config_file, error);
+        if (error || write_time != last_save_->write_time)
+            return false;
+        const auto file_size = std::filesystem::file_size(path_config_file, error);
+        return !error && file_size == last_save_->file_size;
+    }
+
+    /**
+     * @brief _record_save stores the state of a file written by save_data.
+     */
+    void _record_save(const std::string& path_config_file, const int& vfi_file_version, const bool& zero_indexed)
+    {
+        std::error_code error;
+        const auto write_time = std::filesystem::last_write_time(path_config_file, error);
+        const auto file_size = std::filesystem::file_size(path_config_file, error);
+        if (error)
+            last_save_.reset();
+        else
+            last_save_ = SAVE_STATE{path_config_file, vfi_file_version, zero_indexed, write_time, file_size};
+    }
+
+    /**
+     * @brief _serialize_dirty_entries serializes the dirty entries, so that they are saved verbatim
+     *        until they are modified again. Nothing happens if the VFIConfigurationFile does not
+     *        support serialization.
+     */
+    void _serialize_dirty_entries()
+    {
+        std::vector<const VFIConfigurationFile::Data*> data;
+        std::vector<ENTRY*> dirty_entries;
+        for (auto& pair : yaml_raw_data_map_)
+        {
+            if (!pair.second.lazy_entry)
+            {
+                data.push_back(&*pair.second.data);
+                dirty_entries.push_back(&pair.second);
+            }
+        }
+        std::vector<VFIConfigurationFile::LAZY_ENTRY> fragments;
+        if (data.empty() || !interface_->serialize_entries(data, fragments))
+            return;
+        for (std::size_t i = 0; i < dirty_entries.size(); ++i)
+            dirty_entries[i]->lazy_entry = std::move(fragments[i]);
+    }
+
+    /**
+     * @brief _get_entries gets the entries to be saved, in file order.
+     * @return The entries. The indexed entries are saved verbatim.
+     */
+    std::vector<VFIConfigurationFile::Entry> _get_entries() const
+    {
+        std::vector<VFIConfigurationFile::Entry> entries;
+        entries.reserve(yaml_raw_data_map_.size());
+        for (auto& pair : yaml_raw_data_map_)
+        {
+            if (pair.second.lazy_entry)
+                entries.emplace_back(*pair.second.lazy_entry);
+            else
+                entries.emplace_back(*pair.second.data);
+        }
+        return entries;
+    }
+
+    bool journal_mode_ = false; // default value
+    std::size_t journal_compaction_threshold_ = 4 * 1024 * 1024; // default value, in bytes
+    std::string journal_config_file_; // The configuration file of the open journal
+    int journal_vfi_file_version_ = 2;
+    bool journal_zero_indexed_ = true;
+    int journal_fd_ = -1;
+    std::size_t journal_size_ = 0;
+    std::thread compaction_thread_;
+    std::atomic<bool> compacting_{false}; // True while the compaction thread runs
+    std::exception_ptr compaction_error_;
+    std::size_t failed_compaction_size_ = 0; // The journal size when the last compaction could not start
+    // The entries of the configuration file as the compactions write it, which only the compaction
+    // thread modifies while it runs, and the payloads of the records it has not applied yet
+    OrderedHashMap<std::string, VFIConfigurationFile::Entry> compacted_entries_;
+    std::vector<std::string> compaction_records_;
+    bool journal_grouping_ = false; // True while the records are held for a record group
+    std::vector<std::string> journal_group_; // The payloads of the record group
+
+    std::string _journal_file() const
+    {
+        return journal_config_file_ + ".journal";
+    }
+
+    std::string _compacting_journal_file() const
+    {
+        return journal_config_file_ + ".journal.compacting";
+    }
+
+    /**
+     * @brief _replay_journal applies the records of a journal file. A torn record at the end of
+     *        the file (an append interrupted by a crash) is discarded.
+     * @param journal_file The journal file.
+     * @return The size of the valid part of the file, or zero if the file does not exist.
+     */
+    std::size_t _replay_journal(const std::string& journal_file)
+    {
+        std::ifstream fin(journal_file, std::ios::binary);
+        if (!fin)
+            return 0;
+        const std::string text((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+        if (text.empty())
+            return 0;
+
+        JournalReader header(text.data(), text.data() + std::min(text.size(), journal_header_size));
+        std::uint32_t magic, format_version;
+        if (!header.u32(magic) || std::memcmp(text.data(), journal_magic, sizeof(journal_magic)) != 0 ||
+            !header.u32(format_version) || format_version < 2 || format_version > journal_format_version)
+            throw std::runtime_error("The file " + journal_file + " is not a VFI journal!");
+
+        std::size_t offset = journal_header_size;
+        while (offset < text.size())
+        {
+            JournalReader frame(text.data() + offset, text.data() + text.size());
+            std::uint32_t size, checksum;
+            if (!frame.u32(size) || !frame.u32(checksum) || text.size() - offset - 8 < size ||
+                journal_checksum(text.data() + offset + 8, size) != checksum)
+            {
+                std::cerr << "Warning: discarding a torn record at the end of " << journal_file << std::endl;
+                break;
+            }
+
+            const bool valid = read_journal_record(text.data() + offset + 8, text.data() + offset + 8 + size,
+                                                   [this](const std::string& previous_tag, VFIConfigurationFile::Data&& data) {
+                // The renamed entry keeps its position. The new tag may already be in the
+                // configuration file if the record was reflected in it.
+                const std::string tag = _extract_tag(data);
+                if (!previous_tag.empty() && yaml_raw_data_map_.rename(previous_tag, tag))
+                    _version_rename(previous_tag, tag);
+                auto it = yaml_raw_data_map_.find(tag);
+                if (it == yaml_raw_data_map_.end())
+                    _insert_entry(tag, ENTRY{_adopt(std::move(data)), std::nullopt});
+                else
+                {
+                    it->second.data = _adopt(std::move(data));
+                    it->second.lazy_entry.reset();
+                    _touch(it->second);
+                }
+            }, [this](const std::string& tag) { _erase_entry(tag); });
+            if (!valid)
+                throw std::runtime_error("Invalid record in the journal " + journal_file);
+            offset += 8 + size;
+        }
+        return offset;
+    }
+
+    /**
+     * @brief _open_journal replays the journal of a configuration file, and opens it to append
+     *        the next records.
+     * @param config_file The configuration file.
+     */
+    void _open_journal(const std::string& config_file)
+    {
+        journal_config_file_ = config_file;
+        journal_vfi_file_version_ = interface_->get_vfi_file_version();
+        journal_zero_indexed_ = interface_->is_zero_indexed();
+
+        // A journal that is being compacted holds the records older than the current journal
+        _replay_journal(_compacting_journal_file());
+        journal_size_ = _replay_journal(_journal_file());
+
+        journal_fd_ = ::open(_journal_file().c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (journal_fd_ < 0)
+            throw std::runtime_error("Cannot open the journal " + _journal_file() + ": " + std::strerror(errno));
+        if (journal_size_ == 0)
+        {
+            JournalWriter header;
+            header.bytes.assign(journal_magic, sizeof(journal_magic));
+            header.u32(journal_format_version);
+            journal_size_ = header.bytes.size();
+            if (::ftruncate(journal_fd_, 0) != 0 || !append_to_file(journal_fd_, header.bytes))
+                throw std::runtime_error("Cannot write the journal " + _journal_file());
+        }
+        else if (::ftruncate(journal_fd_, static_cast<off_t>(journal_size_)) != 0 ||
+                 ::lseek(journal_fd_, 0, SEEK_END) < 0)
+            throw std::runtime_error("Cannot write the journal " + _journal_file());
+        _reset_compacted_entries();
+    }
+
+    /**
+     * @brief _reset_compacted_entries sets the entries that the compactions write to those of the
+     *        editor. The lazy entries share their source with the editor, and the decoded
+     *        constraints are copied.
+     */
+    void _reset_compacted_entries()
+    {
+        compacted_entries_.clear();
+        compacted_entries_.reserve(yaml_raw_data_map_.size());
+        for (auto& pair : yaml_raw_data_map_)
+        {
+            if (pair.second.lazy_entry)
+                compacted_entries_.try_emplace(pair.first, *pair.second.lazy_entry);
+            else
+                compacted_entries_.try_emplace(pair.first, *pair.second.data);
+        }
+        compaction_records_.clear();
+        failed_compaction_size_ = 0;
+    }
+
+    /**
+     * @brief _close_journal waits for the compaction and closes the journal.
+     */
+    void _close_journal()
+    {
+        _wait_for_compaction();
+        if (journal_fd_ >= 0)
+            ::close(journal_fd_);
+        journal_fd_ = -1;
+        compacted_entries_.clear();
+        compaction_records_.clear();
+    }
+
+    /**
+     * @brief _append_journal appends a record to the journal, if any, and compacts the journal
+     *        when its size exceeds the threshold.
+     * @param payload The payload of the record.
+     */
+    void _append_journal(const std::string& payload)
+    {
+        if (journal_fd_ < 0)
+            return;
+        if (journal_grouping_)
+        {
+            journal_group_.push_back(payload);
+            return;
+        }
+        const std::string record = JournalWriter::record(payload);
+        if (!append_to_file(journal_fd_, record))
+        {
+            const std::string error = std::strerror(errno);
+            // A partial record would hide the next ones from the replay
+            if (::ftruncate(journal_fd_, static_cast<off_t>(journal_size_)) == 0)
+                ::lseek(journal_fd_, static_cast<off_t>(journal_size_), SEEK_SET);
+            throw std::runtime_error("Cannot write the journal " + _journal_file() + ": " + error);
+        }
+        journal_size_ += record.size();
+        compaction_records_.push_back(payload);
+        if (journal_size_ > journal_compaction_threshold_ + failed_compaction_size_)
+            _compact_journal();
+    }
+
+    /**
+     * @brief _begin_journal_group holds the next records, which _end_journal_group appends as
+     *        a single record group.
+     */
+    void _begin_journal_group()
+    {
+        journal_grouping_ = true;
+        journal_group_.clear();
+    }
+
+    /**
+     * @brief _end_journal_group appends the held records as a record group.
+     * @param discard True to drop the held records instead.
+     */
+    void _end_journal_group(const bool& discard = false)
+    {
+        journal_grouping_ = false;
+        std::vector<std::string> payloads = std::move(journal_group_);
+        journal_group_.clear();
+        if (discard || payloads.empty())
+            return;
+        if (payloads.size() == 1)
+        {
+            _append_journal(payloads.front());
+            return;
+        }
+        JournalWriter group;
+        group.u8(journal_group);
+        group.u32(static_cast<std::uint32_t>(payloads.size()));
+        for (const auto& payload : payloads)
+            group.string(payload);
+        _append_journal(group.bytes);
+    }
+
+    void _journal_put(const VFIConfigurationFile::Data& data)
+    {
+        if (journal_fd_ < 0)
+            return;
+        JournalWriter payload;
+        payload.u8(journal_put);
+        payload.data(data);
+        _append_journal(payload.bytes);
+    }
+
+    void _journal_rename(const std::string& tag, const VFIConfigurationFile::Data& data)
+    {
+        if (journal_fd_ < 0)
+            return;
+        JournalWriter payload;
+        payload.u8(journal_rename);
+        payload.string(tag);
+        payload.data(data);
+        _append_journal(payload.bytes);
+    }
+
+    void _journal_erase(const std::string& tag)
+    {
+        if (journal_fd_ < 0)
+            return;
+        JournalWriter payload;
+        payload.u8(journal_erase);
+        payload.string(tag);
+        _append_journal(payload.bytes);
+    }
+
+    /**
+     * @brief _reset_journal empties the journal after the whole data was saved in its
+     *        configuration file.
+     */
+    void _reset_journal()
+    {
+        _wait_for_compaction();
+        std::filesystem::remove(_compacting_journal_file());
+        _truncate_journal();
+        _reset_compacted_entries();
+    }
+
+    /**
+     * @brief _truncate_journal removes the records of the journal, and moves the offset of the
+     *        descriptor back to the end of the header so that the next records follow it.
+     */
+    void _truncate_journal()
+    {
+        journal_size_ = journal_header_size;
+        if (::ftruncate(journal_fd_, static_cast<off_t>(journal_size_)) != 0 ||
+            ::lseek(journal_fd_, static_cast<off_t>(journal_size_), SEEK_SET) < 0)
+            throw std::runtime_error("Cannot write the journal " + _journal_file());
+    }
+
+    /**
+     * @brief _compact_journal writes the data into the configuration file of the journal on a
+     *        background thread, and the new records go to an empty journal. The thread applies the
+     *        records appended since the previous compaction to compacted_entries_ and writes them,
+     *        so the modification that triggers the compaction only moves the journal aside. The
+     *        compaction is postponed while the previous one runs. A compaction that cannot start
+     *        is reported, its records stay in the journal, and it is tried again after another
+     *        threshold of records.
+     */
+    void _compact_journal()
+    {
+        if (compacting_)
+            return;
+        try {
+            _wait_for_compaction();
+            _rotate_journal();
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: the journal compaction failed: " << e.what() << std::endl;
+            failed_compaction_size_ = journal_size_;
+            return;
+        }
+        failed_compaction_size_ = 0;
+
+        compacting_ = true;
+        compaction_thread_ = std::thread([this, records = std::move(compaction_records_),
+                                          interface = interface_,
+                                          config_file = journal_config_file_,
+                                          compacting_file = _compacting_journal_file(),
+                                          vfi_file_version = journal_vfi_file_version_,
+                                          zero_indexed = journal_zero_indexed_]() {
+            try {
+                for (const auto& payload : records)
+                    read_journal_record(payload.data(), payload.data() + payload.size(),
+                                        [this](const std::string& previous_tag, VFIConfigurationFile::Data&& data) {
+                        const std::string tag = std::visit([](auto&& arg) -> std::string { return arg.tag; }, data);
+                        if (!previous_tag.empty())
+                            compacted_entries_.rename(previous_tag, tag);
+                        compacted_entries_.insert_or_assign(tag, VFIConfigurationFile::Entry(std::move(data)));
+                    }, [this](const std::string& tag) { compacted_entries_.erase(tag); });
+                auto writer = interface->open_writer(config_file, vfi_file_version, zero_indexed);
+                for (const auto& pair : compacted_entries_)
+                    std::visit([&writer](auto&& arg) { writer->write(arg); }, pair.second);
+                writer->close();
+                std::filesystem::remove(compacting_file);
+            } catch (...) {
+                compaction_error_ = std::current_exception();
+            }
+            compacting_ = false;
+        });
+        compaction_records_.clear();
+    }
+
+    /**
+     * @brief _rotate_journal moves the records of the journal to the compacting journal, and
+     *        empties the journal. The journal is renamed, unless a previous compaction failed: the
+     *        compacting journal still holds older records then, so the records are appended to it.
+     *        The journal is left as it was if the records cannot be moved.
+     */
+    void _rotate_journal()
+    {
+        std::error_code error;
+        if (std::filesystem::exists(_compacting_journal_file(), error))
+        {
+            std::ifstream fin(_journal_file(), std::ios::binary);
+            if (!fin)
+                throw std::runtime_error("Cannot read the journal " + _journal_file());
+            fin.seekg(static_cast<std::streamoff>(journal_header_size));
+            std::ofstream fout(_compacting_journal_file(), std::ios::binary | std::ios::app);
+            fout << fin.rdbuf();
+            fout.close();
+            if (!fout)
+                throw std::runtime_error("Cannot write the journal " + _compacting_journal_file());
+            _truncate_journal();
+            return;
+        }
+
+        JournalWriter header;
+        header.bytes.assign(journal_magic, sizeof(journal_magic));
+        header.u32(journal_format_version);
+        std::filesystem::rename(_journal_file(), _compacting_journal_file());
+        const int fd = ::open(_journal_file().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0 || !append_to_file(fd, header.bytes))
+        {
+            if (fd >= 0)
+                ::close(fd);
+            std::filesystem::remove(_journal_file(), error);
+            std::filesystem::rename(_compacting_journal_file(), _journal_file(), error);
+            throw std::runtime_error("Cannot write the journal " + _journal_file());
+        }
+        ::close(journal_fd_);
+        journal_fd_ = fd;
+        journal_size_ = header.bytes.size();
+    }
+
+    /**
+     * @brief _wait_for_compaction waits for the compaction in progress, if any. A failed
+     *        compaction is reported, and its records are kept in the compacting journal.
+     */
+    void _wait_for_compaction()
+    {
+        if (compaction_thread_.joinable())
+            compaction_thread_.join();
+        if (compaction_error_)
+        {
+            try {
+                std::rethrow_exception(compaction_error_);
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: the journal compaction failed: " << e.what() << std::endl;
+            }
+            compaction_error_ = nullptr;
+        }
+    }
+
+    ~Impl()
+    {
+        _close_journal();
+    }
 
-class RobotConstraintEditor::Impl
-{
-public:
-    const int vfi_file_version_ = 2; // default value
-    bool zero_indexed_ = true; // default value
-    std::shared_ptr<VFIConfigurationFile> interface_;
+    /**
+     * @brief _materialize decodes an entry, if needed.
+     * @param entry The entry.
+     * @return The decoded data of the entry.
+     */
+    VFIConfigurationFile::Data& _materialize(ENTRY& entry)
+    {
+        if (!entry.data)
+            entry.data = _adopt(interface_->decode_entry(*entry.lazy_entry));
+        return *entry.data;
+    }
 
-    std::map<std::string, VFIConfigurationFile::Data> yaml_raw_data_map_;
+    /**
+     * @brief _adopt moves or copies a constraint into the arena of the editor, if there is one.
+     * @param data The constraint.
+     * @return The constraint, allocated from the arena.
+     */
+    template<typename Source>
+    VFIConfigurationFile::Data _adopt(Source&& data)
+    {
+        if (arena_)
+            return allocate_data(std::forward<Source>(data), arena_.get());
+        return VFIConfigurationFile::Data(std::forward<Source>(data));
+    }
 
     /**
      * @brief _is_the_same_type checks if two RawData structures have the same type.
@@ -70,6 +1483,131 @@ public:
         }, raw_data);
     }
 
+    /**
+     * @brief _add_data adds a constraint.
+     * @param data The constraint, which is moved into the editor.
+     * @param order The order key where the constraint is inserted (see _insert_entry). Default:
+     *        the end of the map.
+     * @return The entry of the constraint.
+     */
+    const ENTRY& _add_data(VFIConfigurationFile::Data&& data, const std::optional<std::uint64_t>& order = std::nullopt)
+    {
+        const std::string tag = _extract_tag(data);
+        if (is_tag_in_map(tag))
+            throw std::runtime_error("Tag '" + tag + "' is being used!");
+        const auto& entry = _insert_entry(tag, ENTRY{_adopt(std::move(data)), std::nullopt}, order);
+        _update_indexes(*entry.data, true);
+        last_save_.reset();
+        _journal_put(*entry.data);
+        return entry;
+    }
+
+    /**
+     * @brief _next_position gets the first position of the map, starting from a given one, that
+     *        holds an entry.
+     */
+    std::size_t _next_position(std::size_t position) const
+    {
+        while (position < yaml_raw_data_map_.position_end() && !yaml_raw_data_map_.at_position(position))
+            ++position;
+        return position;
+    }
+
+    std::shared_ptr<ConstraintValidator> validator_ = nullptr; // Checks the constraints before each save
+    // The index convention that validator_ checked the serialized entries with, if it checked all of them
+    std::optional<bool> validated_zero_indexed_;
+
+    /**
+     * @brief _validate_for_save checks the constraints with validator_ before a save. The entries
+     *        serialized by a previous validated save with the same convention are not checked again,
+     *        so a save only checks the entries modified since then. The lazy entries that must be
+     *        checked are decoded in small batches, which are not kept.
+     * @param zero_indexed The index convention of the saved file.
+     * @return The diagnostics.
+     */
+    std::vector<ConstraintValidator::DIAGNOSTIC> _validate_for_save(const bool& zero_indexed)
+    {
+        constexpr std::size_t batch_size = 4096;
+        const bool dirty_only = validated_zero_indexed_ == zero_indexed;
+        std::vector<ConstraintValidator::DIAGNOSTIC> diagnostics;
+        std::vector<const VFIConfigurationFile::Data*> data;
+        std::vector<VFIConfigurationFile::Data> decoded;
+        decoded.reserve(batch_size);
+        auto flush = [&]() {
+            auto batch_diagnostics = validator_->validate(data, zero_indexed);
+            diagnostics.insert(diagnostics.end(), std::make_move_iterator(batch_diagnostics.begin()),
+                               std::make_move_iterator(batch_diagnostics.end()));
+            data.clear();
+            decoded.clear();
+        };
+        for (auto& pair : yaml_raw_data_map_)
+        {
+            const ENTRY& entry = pair.second;
+            if (dirty_only && entry.lazy_entry)
+                continue;
+            if (entry.data)
+                data.push_back(&*entry.data);
+            else
+            {
+                if (decoded.size() == batch_size)
+                    flush();
+                decoded.push_back(interface_->decode_entry(*entry.lazy_entry));
+                data.push_back(&decoded.back());
+            }
+        }
+        flush();
+        return diagnostics;
+    }
+
+    int number_of_query_threads_ = 1; // default value
+
+    /**
+     * @brief _match finds the entries that satisfy the conditions of a query, in one pass over the
+     *        map. Large maps are split in chunks, which are matched on several threads (see
+     *        set_number_of_query_threads).
+     * @param query The query.
+     * @return The positions of the matched entries, in file order.
+     */
+    std::vector<std::size_t> _match(const ConstraintQuery& query)
+    {
+        constexpr std::size_t minimum_chunk_size = 4096;
+        const std::size_t end = yaml_raw_data_map_.position_end();
+        const std::size_t number_of_threads = (number_of_query_threads_ > 0) ?
+                                                  static_cast<std::size_t>(number_of_query_threads_) :
+                                                  std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t number_of_chunks = std::min(number_of_threads, std::max<std::size_t>(1, end / minimum_chunk_size));
+        std::vector<std::uint8_t> mask(end, 0);
+        if (number_of_chunks > 1)
+        {
+            // The lazy entries are decoded first, since decoding modifies them
+            for (auto& pair : yaml_raw_data_map_)
+                _materialize(pair.second);
+            std::vector<std::thread> threads;
+            for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk)
+            {
+                threads.emplace_back([&, chunk]() {
+                    const std::size_t chunk_end = end * (chunk + 1) / number_of_chunks;
+                    for (std::size_t position = end * chunk / number_of_chunks; position < chunk_end; ++position)
+                        if (const auto node = yaml_raw_data_map_.at_position(position))
+                            mask[position] = query.matches(*node->second.data);
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+        }
+        else
+        {
+            for (std::size_t position = 0; position < end; ++position)
+                if (const auto node = yaml_raw_data_map_.at_position(position))
+                    mask[position] = query.matches(_materialize(node->second));
+        }
+        std::vector<std::size_t> positions;
+        for (std::size_t position = 0; position < end; ++position)
+            if (mask[position])
+                positions.push_back(position);
+        return positions;
+    }
+
     /**
      * @brief is_tag_in_map checks if a tag is in the map
      * @param tag The tag to check
@@ -77,7 +1615,7 @@ public:
      */
     bool is_tag_in_map(const std::string& tag)
     {
-        return (yaml_raw_data_map_.find(tag) == yaml_raw_data_map_.end()) ? false : true;
+        return yaml_raw_data_map_.contains(tag);
     }
 
     Impl()
@@ -87,75 +1625,708 @@ public:
 };
 
 /**
- * @brief RobotConstraintEditor::RobotConstraintEditor ctor of the class
+ * @brief RobotConstraintEditor::RobotConstraintEditor ctor of the class
+ */
+RobotConstraintEditor::RobotConstraintEditor(const std::shared_ptr<VFIConfigurationFile> &interface) {
+    impl_ = std::make_shared<RobotConstraintEditor::Impl>();
+    impl_->interface_ = interface;
+}
+
+/**
+ * @brief RobotConstraintEditor::load_data
+ * @param config_file
+ */
+void RobotConstraintEditor::load_data(const std::string& config_file)
+{
+    if (impl_->interface_)
+    {
+        impl_->_close_journal();
+        impl_->last_save_.reset();
+        impl_->indexes_.reset();
+        impl_->validated_zero_indexed_.reset();
+        std::vector<VFIConfigurationFile::LAZY_ENTRY> entries;
+        if (impl_->lazy_loading_ && impl_->interface_->index_data(config_file, entries))
+        {
+            for (auto& entry : entries)
+            {
+                if (impl_->is_tag_in_map(entry.tag))
+                    throw std::runtime_error("Tag '" + entry.tag + "' is being used!");
+                const std::string tag = entry.tag;
+                impl_->_insert_entry(tag, Impl::ENTRY{std::nullopt, std::move(entry)});
+            }
+        }
+        else
+        {
+            impl_->interface_->load_data(config_file);
+            if (impl_->arena_)
+            {
+                // Copied straight into the arena of the editor
+                impl_->interface_->for_each_data([this](const VFIConfigurationFile::Data& data) {
+                    impl_->_add_data(impl_->_adopt(data));
+                });
+            }
+            else
+            {
+                for (auto& data : impl_->interface_->take_data())
+                    impl_->_add_data(std::move(data));
+            }
+        }
+        if (impl_->journal_mode_)
+            impl_->_open_journal(config_file);
+        impl_->_clear_history();
+        impl_->_publish();
+    }else
+        throw std::runtime_error("The VFIConfigurationFile pointer is undefined!");
+}
+
+/**
+ * @brief RobotConstraintEditor::set_journal_mode enables the edit journal. In journal mode, load_data
+ *        replays the journal of the configuration file (config_file + ".journal"), and every
+ *        modification of the data is appended to it, so the edits survive a crash without
+ *        saving the whole file. When the journal exceeds the compaction threshold, the data is
+ *        written into the configuration file on a background thread and the journal starts over.
+ *        The background thread keeps its own copy of the constraints that are not lazy entries,
+ *        and applies the records to it, so the modifications do not wait for the compactions.
+ *        The setting applies from the next load_data.
+ * @param journal_mode True to enable the edit journal. Default: false.
+ */
+void RobotConstraintEditor::set_journal_mode(const bool& journal_mode)
+{
+    impl_->journal_mode_ = journal_mode;
+}
+
+/**
+ * @brief RobotConstraintEditor::set_journal_compaction_threshold sets the size of the journal that
+ *        triggers a compaction.
+ * @param threshold The desired size in bytes. Default: 4 MiB.
+ */
+void RobotConstraintEditor::set_journal_compaction_threshold(const std::size_t& threshold)
+{
+    impl_->journal_compaction_threshold_ = threshold;
+}
+
+/**
+ * @brief RobotConstraintEditor::set_lazy_loading enables the lazy loading of the configuration files.
+ *        In lazy loading, load_data only indexes the tags of the file, and each constraint is
+ *        decoded the first time it is accessed. The constraints that are not modified are saved
+ *        verbatim. Files that the VFIConfigurationFile cannot index are loaded as usual.
+ * @param lazy_loading True to enable the lazy loading. Default: false.
+ */
+void RobotConstraintEditor::set_lazy_loading(const bool& lazy_loading)
+{
+    impl_->lazy_loading_ = lazy_loading;
+}
+
+/**
+ * @brief RobotConstraintEditor::set_arena_mode selects where the editor allocates the entity lists
+ *        of its constraints (see VFIConfigurationFile::ARENA_MODE). The arena is owned by the
+ *        editor and released at once with it. A MONOTONIC arena only reuses memory when the
+ *        editor is destroyed, so POOL suits the editors that modify many constraints.
+ * @param arena_mode The desired arena mode. Default: VFIConfigurationFile::ARENA_MODE::HEAP.
+ */
+void RobotConstraintEditor::set_arena_mode(const VFIConfigurationFile::ARENA_MODE& arena_mode)
+{
+    if (!impl_->yaml_raw_data_map_.empty())
+        throw std::runtime_error("The arena mode must be set before adding constraints!");
+    // The removed constraints in the undo history may be allocated in the previous arena
+    impl_->_clear_history();
+    switch (arena_mode) {
+    case VFIConfigurationFile::ARENA_MODE::MONOTONIC:
+        impl_->arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>();
+        break;
+    case VFIConfigurationFile::ARENA_MODE::POOL:
+        impl_->arena_ = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+        break;
+    case VFIConfigurationFile::ARENA_MODE::HEAP:
+        impl_->arena_.reset();
+        break;
+    }
+}
+
+/**
+ * @brief RobotConstraintEditor::set_concurrent_mode enables the snapshots of the constraints. In
+ *        concurrent mode, each modification of the editor publishes a Snapshot, which the reader
+ *        threads get with get_snapshot while the editor is modified. The editor itself has a single
+ *        writer: the methods other than get_snapshot must be called from the same thread, and the
+ *        concurrent mode must be set before the readers start. This includes the readers of the
+ *        editor (get_data by tag or ConstraintId, get_id, get_data_view, for_each, the
+ *        get_tags_by_* indexes and the queries): they return references and views into the live
+ *        constraints, and may decode lazy entries or build the indexes, so they are not routed
+ *        through the snapshot. The reader threads use the Snapshot, whose find, get_data and
+ *        for_each have the same roles.
+ * @param concurrent_mode True to enable the concurrent mode. Default: false.
+ */
+void RobotConstraintEditor::set_concurrent_mode(const bool& concurrent_mode)
+{
+    impl_->concurrent_mode_ = concurrent_mode;
+    if (concurrent_mode)
+    {
+        impl_->_publish();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(impl_->snapshot_mutex_);
+        impl_->snapshot_.reset();
+    }
+    impl_->_stop_versioning();
+}
+
+/**
+ * @brief RobotConstraintEditor::get_snapshot gets an immutable snapshot of the constraints in O(1).
+ *        The snapshots share the constraints that did not change between them, so many versions
+ *        can be kept at the cost of the constraints modified between them. The first call copies
+ *        the constraints once; each later modification copies only the modified constraint.
+ *        In concurrent mode, this method gets the last published snapshot and can be called from
+ *        any thread. Otherwise, it must be called from the thread that modifies the editor.
+ * @return The desired snapshot.
+ */
+RobotConstraintEditor::Snapshot RobotConstraintEditor::get_snapshot() const
+{
+    if (!impl_->concurrent_mode_)
+        return Snapshot(impl_->_snapshot());
+    std::lock_guard<std::mutex> lock(impl_->snapshot_mutex_);
+    return Snapshot(impl_->snapshot_);
+}
+
+/**
+ * @brief RobotConstraintEditor::set_undo_mode enables the undo history. In undo mode, add_data,
+ *        remove_data, replace_data, edit_data, edit and apply_constraint_table record their
+ *        inverse changes: the modified fields, or the removed constraints. load_data clears the
+ *        history.
+ * @param undo_mode True to enable the undo history. Default: false.
+ */
+void RobotConstraintEditor::set_undo_mode(const bool& undo_mode)
+{
+    impl_->undo_mode_ = undo_mode;
+    if (!undo_mode)
+        impl_->_clear_history();
+}
+
+/**
+ * @brief RobotConstraintEditor::set_undo_memory_limit limits the memory of the undo history. The
+ *        oldest steps are dropped when the history exceeds the limit.
+ * @param bytes The limit, in bytes. Default: 64 MiB.
+ */
+void RobotConstraintEditor::set_undo_memory_limit(const std::size_t& bytes)
+{
+    impl_->undo_memory_limit_ = bytes;
+    impl_->_trim_history();
+}
+
+/**
+ * @brief RobotConstraintEditor::set_undo_coalescing_window sets the time within which the edits
+ *        of the same field of the same constraint are merged into a single undo step.
+ * @param window The desired window. Zero disables the coalescing. Default: 500 ms.
+ */
+void RobotConstraintEditor::set_undo_coalescing_window(const std::chrono::milliseconds& window)
+{
+    impl_->undo_coalescing_window_ = window;
+}
+
+/**
+ * @brief RobotConstraintEditor::undo reverts the last modification recorded in undo mode. The
+ *        cost depends on the size of the modification, not on the number of constraints. A
+ *        removed constraint gets its position back, unless the editor removed the holes of its
+ *        map in the meantime, in which case it is restored at the end.
+ * @return True if a modification was reverted. False if the undo history is empty.
+ */
+bool RobotConstraintEditor::undo()
+{
+    return _replay(false);
+}
+
+/**
+ * @brief RobotConstraintEditor::redo makes the last modification reverted by undo again. A new
+ *        modification clears the redo history.
+ * @return True if a modification was made again. False if the redo history is empty.
+ */
+bool RobotConstraintEditor::redo()
+{
+    return _replay(true);
+}
+
+bool RobotConstraintEditor::can_undo() const
+{
+    return !impl_->undo_.empty();
+}
+
+bool RobotConstraintEditor::can_redo() const
+{
+    return !impl_->redo_.empty();
+}
+
+void RobotConstraintEditor::clear_undo_history()
+{
+    impl_->_clear_history();
+}
+
+/**
+ * @brief RobotConstraintEditor::_replay applies the inverse changes of the last undo or redo step.
+ *        The changes are applied by the usual modifications, which record the opposite step.
+ * @param redo True to replay the last redo step. False to replay the last undo step.
+ * @return True if a step was replayed.
+ */
+bool RobotConstraintEditor::_replay(const bool& redo)
+{
+    auto& stack = redo ? impl_->redo_ : impl_->undo_;
+    if (stack.empty())
+        return false;
+    Impl::STEP step = std::move(stack.back());
+    stack.pop_back();
+    impl_->history_bytes_ -= step.bytes;
+    if (!impl_->undo_.empty())
+        impl_->undo_.back().coalescible = false;
+
+    impl_->recording_ = redo ? Impl::RECORDING::REDO : Impl::RECORDING::UNDO;
+    try {
+        Impl::BATCH batch(*impl_);
+        for (auto it = step.changes.rbegin(); it != step.changes.rend(); ++it)
+        {
+            std::visit([this](auto&& change) {
+                using ChangeType = std::decay_t<decltype(change)>;
+                if constexpr (std::is_same_v<ChangeType, Impl::PRESENCE_CHANGE>) {
+                    if (!change.data) {
+                        remove_data(change.tag);
+                        return;
+                    }
+                    impl_->_add_data(std::move(*change.data), change.order);
+                    impl_->_record(Impl::PRESENCE_CHANGE{change.tag});
+                } else {
+                    _set_field(get_id(change.tag), change.field, change.before);
+                }
+            }, *it);
+        }
+    } catch (...) {
+        // The history does not match the constraints anymore
+        impl_->recording_ = Impl::RECORDING::EDIT;
+        impl_->_clear_history();
+        impl_->_publish();
+        throw;
+    }
+    impl_->_commit();
+    impl_->recording_ = Impl::RECORDING::EDIT;
+    return true;
+}
+
+/**
+ * @brief RobotConstraintEditor::_revert_pending reverts the changes of the pending step, which
+ *        were recorded in undo mode inside a journal group. Neither the changes nor their
+ *        inverses are journaled: the group is discarded.
+ * @param undo_mode The undo mode to restore afterwards.
+ */
+void RobotConstraintEditor::_revert_pending(const bool& undo_mode)
+{
+    impl_->undo_mode_ = false;
+    impl_->journal_grouping_ = true;
+    impl_->pending_.bytes = 0;
+    impl_->undo_.push_back(std::move(impl_->pending_));
+    impl_->pending_ = Impl::STEP();
+    try {
+        _replay(false);
+    } catch (...) {
+        // _replay cleared the history, which does not match the constraints anymore
+    }
+    impl_->_end_journal_group(true);
+    impl_->undo_mode_ = undo_mode;
+}
+
+/**
+ * @brief RobotConstraintEditor::_set_field modifies a field of a constraint, as edit() does.
+ * @param id The handle of the constraint.
+ * @param field The field.
+ * @param value The new value, which must hold the type of the field.
+ */
+void RobotConstraintEditor::_set_field(const ConstraintId& id, const FIELD& field, const FIELD_VALUE& value)
+{
+    if (field == FIELD::TAG)
+    {
+        edit_data(id, "tag", std::get<std::string>(value));
+        return;
+    }
+    bool modified = false;
+    std::visit([&](auto&& data) {
+        for_each_field(data, [&](auto descriptor, auto& field_value) {
+            using FieldType = typename decltype(descriptor)::type;
+            if (descriptor.field != field)
+                return;
+            if (const auto new_value = std::get_if<FieldType>(&value))
+            {
+                field_value = *new_value;
+                modified = true;
+            }
+        });
+    }, _begin_edit(id, field));
+    _end_edit(id, modified, field);
+}
+
+/**
+ * @brief RobotConstraintEditor::add_data adds data to compose the YAML file.
+ * @param vector_data A vector containing VFIConfigurationFile::RawData elements
+ */
+void  RobotConstraintEditor::add_data(const std::vector<VFIConfigurationFile::Data>& vector_data)
+{
+    try {
+        Impl::BATCH batch(*impl_);
+        for (auto& data : vector_data)
+            add_data(data);
+    } catch (...) {
+        impl_->_commit(); // The constraints added before the error
+        throw;
+    }
+    impl_->_commit();
+}
+
+/**
+ * @brief RobotConstraintEditor::replace_data removes the data stored in the corresponding tag, and adds
+ *              the new data. The new data will will be tagged automatically.
+ * @param tag The tag of the data to be removed
+ * @param data The new data to add.
+ */
+void RobotConstraintEditor::replace_data(const std::string& tag, const VFIConfigurationFile::Data& data)
+{
+    try{
+        Impl::BATCH batch(*impl_);
+        remove_data(tag);
+        add_data(data);
+    } catch (const std::runtime_error& e) {
+        impl_->_commit();
+        std::cerr<<e.what()<<std::endl;
+        throw std::runtime_error("RobotConstraintEditor::edit_data: Fail to update the VFI data!");
+    }
+    impl_->_commit();
+}
+
+/**
+ * @brief RobotConstraintEditor::begin starts a transaction, whose operations are applied by its
+ *        commit() as a single modification of the editor (and a single undo step).
+ * @return The desired transaction.
+ */
+RobotConstraintEditor::Transaction RobotConstraintEditor::begin()
+{
+    return Transaction(this);
+}
+
+RobotConstraintEditor::Transaction::Transaction(RobotConstraintEditor* editor)
+    : editor_(editor)
+{
+}
+
+void RobotConstraintEditor::Transaction::add_data(const VFIConfigurationFile::Data& data)
+{
+    operations_.push_back(OPERATION{OPERATION::TYPE::ADD, {}, data, std::nullopt, {}, {}});
+}
+
+void RobotConstraintEditor::Transaction::add_data(VFIConfigurationFile::Data&& data)
+{
+    operations_.push_back(OPERATION{OPERATION::TYPE::ADD, {}, std::move(data), std::nullopt, {}, {}});
+}
+
+void RobotConstraintEditor::Transaction::remove_data(const std::string& tag)
+{
+    operations_.push_back(OPERATION{OPERATION::TYPE::REMOVE, tag, std::nullopt, std::nullopt, {}, {}});
+}
+
+/**
+ * @brief RobotConstraintEditor::Transaction::replace_data stages the removal of a constraint and
+ *        the addition of another one. Unlike RobotConstraintEditor::replace_data, nothing is
+ *        removed if the addition fails.
+ * @param tag The tag of the constraint to be removed.
+ * @param data The new constraint.
+ */
+void RobotConstraintEditor::Transaction::replace_data(const std::string& tag, const VFIConfigurationFile::Data& data)
+{
+    remove_data(tag);
+    add_data(data);
+}
+
+/**
+ * @brief RobotConstraintEditor::Transaction::edit_data stages the modification of the value of a
+ *        key. The key and the value are converted to a field now, and checked by commit().
+ * @param tag The tag of the constraint, as it is when the previous operations are applied.
+ * @param key The key you want to modify.
+ * @param value The new value of the key.
+ */
+template<typename T>
+void RobotConstraintEditor::Transaction::edit_data(const std::string& tag, const std::string& key, const T& value)
+{
+    OPERATION operation{OPERATION::TYPE::EDIT, tag, std::nullopt, find_field(key), {}, {}};
+    if (!operation.field)
+        operation.error = "Key '" + key + "' not found!";
+
+    // A field has the same type in all the configurations, so the first descriptor found is used
+    bool converted = !operation.field;
+    auto convert = [&](auto descriptor) {
+        using FieldType = typename decltype(descriptor)::type;
+        if (converted || descriptor.field != *operation.field)
+            return;
+        converted = true;
+        if constexpr (std::is_convertible_v<T, FieldType>) {
+            operation.value = FieldType(value);
+        } else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList> &&
+                             std::is_same_v<T, std::vector<std::string>>) {
+            operation.value = FieldType(value.begin(), value.end());  // Intern the entity names
+        } else {
+            operation.error = "Type mismatch for field '" + key + "'. Expected: " + typeid(FieldType).name() +
+                              ", Got: " + typeid(T).name();
+        }
+    };
+    std::apply([&](auto... descriptors) { (convert(descriptors), ...); },
+               data_fields_t<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>{});
+    std::apply([&](auto... descriptors) { (convert(descriptors), ...); },
+               data_fields_t<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>{});
+    operations_.push_back(std::move(operation));
+}
+
+std::size_t RobotConstraintEditor::Transaction::size() const
+{
+    return operations_.size();
+}
+
+bool RobotConstraintEditor::Transaction::empty() const
+{
+    return operations_.empty();
+}
+
+/**
+ * @brief RobotConstraintEditor::Transaction::rollback discards the staged operations. The editor
+ *        is not modified.
+ */
+void RobotConstraintEditor::Transaction::rollback()
+{
+    operations_.clear();
+}
+
+/**
+ * @brief RobotConstraintEditor::Transaction::commit applies the staged operations, in order. All
+ *        the operations are validated first, against the tags as they are after the previous
+ *        operations: if any of them fails, nothing is applied and the error of each failed
+ *        operation is reported. The operations are then applied by handle, without string
+ *        lookups, and each constraint involved leaves and enters the indexes once. If an
+ *        operation still fails, the applied ones are reverted. The operations are journaled as
+ *        a single record group. The staged operations are discarded in all cases.
+ */
+void RobotConstraintEditor::Transaction::commit()
+{
+    std::vector<OPERATION> operations = std::move(operations_);
+    operations_.clear();
+    auto& impl = *editor_->impl_;
+
+    // The constraints involved in the operations, as they are after each operation
+    struct STAGED{
+        ConstraintId id; // Invalid for the constraints added by the transaction
+        std::size_t type_index;
+        bool present;
+    };
+    std::vector<STAGED> staged;
+    std::unordered_map<std::string, std::size_t> staged_tags;
+    std::vector<std::size_t> targets(operations.size(), 0);
+    constexpr std::size_t not_found = std::numeric_limits<std::size_t>::max();
+
+    auto find = [&](const std::string& tag) {
+        const auto it = staged_tags.find(tag);
+        if (it != staged_tags.end())
+            return staged[it->second].present ? it->second : not_found;
+        const auto entry = impl.yaml_raw_data_map_.find(tag);
+        if (entry == impl.yaml_raw_data_map_.end())
+            return not_found;
+        const std::uint32_t handle = entry->second.handle;
+        staged.push_back(STAGED{ConstraintId(handle, impl.handles_[handle].generation),
+                                impl._materialize(entry->second).index(), true});
+        staged_tags.emplace(tag, staged.size() - 1);
+        return staged.size() - 1;
+    };
+    auto has_field = [](const std::size_t& type_index, const FIELD& field) {
+        bool found = false;
+        auto check = [&](auto descriptor) { found = found || descriptor.field == field; };
+        if (type_index == 0)
+            std::apply([&](auto... descriptors) { (check(descriptors), ...); },
+                       data_fields_t<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>{});
+        else
+            std::apply([&](auto... descriptors) { (check(descriptors), ...); },
+                       data_fields_t<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>{});
+        return found;
+    };
+
+    std::string errors;
+    for (std::size_t i = 0; i < operations.size(); ++i)
+    {
+        auto& operation = operations[i];
+        std::string error = operation.error;
+        if (error.empty() && operation.type == OPERATION::TYPE::ADD) {
+            const std::string tag = impl._extract_tag(*operation.data);
+            if (find(tag) != not_found) {
+                error = "Tag '" + tag + "' is being used!";
+            } else {
+                staged.push_back(STAGED{ConstraintId(), operation.data->index(), true});
+                staged_tags.insert_or_assign(tag, staged.size() - 1);
+                targets[i] = staged.size() - 1;
+            }
+        } else if (error.empty()) {
+            targets[i] = find(operation.tag);
+            if (targets[i] == not_found) {
+                error = "Tag '" + operation.tag + "' not found!";
+            } else if (operation.type == OPERATION::TYPE::REMOVE) {
+                staged[targets[i]].present = false;
+            } else if (!has_field(staged[targets[i]].type_index, *operation.field)) {
+                error = "Key '" + std::string(field_names[static_cast<std::size_t>(*operation.field)]) +
+                        "' not found for " + (staged[targets[i]].type_index == 0 ? "ENVIRONMENT_TO_ROBOT" : "ROBOT_TO_ROBOT");
+            } else if (*operation.field == FIELD::TAG && std::get<std::string>(operation.value) != operation.tag) {
+                const std::string& new_tag = std::get<std::string>(operation.value);
+                if (find(new_tag) != not_found) {
+                    error = "Tag '" + new_tag + "' is being used!";
+                } else {
+                    // The old tag is free after the rename
+                    staged.push_back(STAGED{ConstraintId(), 0, false});
+                    staged_tags.insert_or_assign(operation.tag, staged.size() - 1);
+                    staged_tags.insert_or_assign(new_tag, targets[i]);
+                }
+            }
+        }
+        if (!error.empty())
+            errors += "\n  Operation " + std::to_string(i) + ": " + error;
+    }
+    if (!errors.empty())
+        throw std::runtime_error("RobotConstraintEditor::Transaction::commit: The transaction was rolled back." + errors);
+
+    // The constraints of the editor leave the indexes before the first operation, and all the
+    // constraints that remain enter them after the last one
+    std::vector<ConstraintId> ids(staged.size());
+    for (std::size_t i = 0; i < staged.size(); ++i)
+    {
+        ids[i] = staged[i].id;
+        if (impl.indexes_ && editor_->is_valid(ids[i]))
+            impl._update_indexes(editor_->get_data(ids[i]), false);
+    }
+    // The changes are recorded even without the undo mode, to revert the applied operations if
+    // a later one fails, and the records are journaled as a single group
+    const bool undo_mode = impl.undo_mode_;
+    impl.undo_mode_ = true;
+    impl.indexes_deferred_ = true;
+    impl._begin_journal_group();
+    try {
+        {
+            Impl::BATCH batch(impl);
+            for (std::size_t i = 0; i < operations.size(); ++i)
+            {
+                auto& operation = operations[i];
+                switch (operation.type) {
+                case OPERATION::TYPE::ADD:
+                    ids[targets[i]] = editor_->add_data(std::move(*operation.data));
+                    break;
+                case OPERATION::TYPE::REMOVE:
+                    editor_->remove_data(ids[targets[i]]);
+                    break;
+                case OPERATION::TYPE::EDIT:
+                    editor_->_set_field(ids[targets[i]], *operation.field, operation.value);
+                    break;
+                }
+            }
+        }
+        impl._end_journal_group();
+    } catch (...) {
+        // Not expected after the validation. The applied operations are reverted, without
+        // journaling them or their inverses, and the indexes are built again by the next query.
+        impl.indexes_deferred_ = false;
+        impl.indexes_.reset();
+        editor_->_revert_pending(undo_mode);
+        throw;
+    }
+    impl.undo_mode_ = undo_mode;
+    if (!undo_mode)
+        impl.pending_ = Impl::STEP();
+    impl.indexes_deferred_ = false;
+    if (impl.indexes_)
+        for (std::size_t i = 0; i < staged.size(); ++i)
+            if (staged[i].present)
+                impl._update_indexes(editor_->get_data(ids[i]), true);
+    impl._commit();
+}
+
+/**
+ * @brief RobotConstraintEditor::add_data adds data to compose the YAML file.
+ * @param data
+ * @return The handle of the new constraint.
  */
-RobotConstraintEditor::RobotConstraintEditor(const std::shared_ptr<VFIConfigurationFile> &interface) {
-    impl_ = std::make_shared<RobotConstraintEditor::Impl>();
-    impl_->interface_ = interface;
+ConstraintId RobotConstraintEditor::add_data(const VFIConfigurationFile::Data& data)
+{
+    const auto& entry = impl_->_add_data(impl_->_adopt(data));
+    const ConstraintId id(entry.handle, impl_->handles_[entry.handle].generation);
+    if (impl_->undo_mode_)
+        impl_->_record(Impl::PRESENCE_CHANGE{impl_->_extract_tag(*entry.data)});
+    impl_->_commit();
+    return id;
 }
 
 /**
- * @brief RobotConstraintEditor::load_data
- * @param config_file
+ * @brief RobotConstraintEditor::add_data adds data to compose the YAML file, without copying it.
+ * @param data
+ * @return The handle of the new constraint.
  */
-void RobotConstraintEditor::load_data(const std::string& config_file)
+ConstraintId RobotConstraintEditor::add_data(VFIConfigurationFile::Data&& data)
 {
-    if (impl_->interface_)
-    {
-        impl_->interface_->load_data(config_file);
-        add_data(impl_->interface_->get_data());
-    }else
-        throw std::runtime_error("The VFIConfigurationFile pointer is undefined!");
+    const auto& entry = impl_->_add_data(std::move(data));
+    const ConstraintId id(entry.handle, impl_->handles_[entry.handle].generation);
+    if (impl_->undo_mode_)
+        impl_->_record(Impl::PRESENCE_CHANGE{impl_->_extract_tag(*entry.data)});
+    impl_->_commit();
+    return id;
 }
 
 /**
- * @brief RobotConstraintEditor::add_data adds data to compose the YAML file.
- * @param vector_data A vector containing VFIConfigurationFile::RawData elements
+ * @brief RobotConstraintEditor::get_id gets the handle of a constraint, which can be used
+ *        instead of the tag to skip the string lookups.
+ * @param tag The tag of the constraint.
+ * @return The desired handle.
  */
-void  RobotConstraintEditor::add_data(const std::vector<VFIConfigurationFile::Data>& vector_data)
+ConstraintId RobotConstraintEditor::get_id(const std::string& tag) const
 {
-    for (auto& data : vector_data)
-        add_data(data);
+    const auto it = impl_->yaml_raw_data_map_.find(tag);
+    if (it == impl_->yaml_raw_data_map_.end())
+        throw std::runtime_error("Tag '" + tag + "' not found!");
+    return ConstraintId(it->second.handle, impl_->handles_[it->second.handle].generation);
 }
 
 /**
- * @brief RobotConstraintEditor::replace_data removes the data stored in the corresponding tag, and adds
- *              the new data. The new data will will be tagged automatically.
- * @param tag The tag of the data to be removed
- * @param data The new data to add.
+ * @brief RobotConstraintEditor::is_valid checks if a handle refers to a constraint of the editor.
+ * @param id The handle.
+ * @return True if the constraint was not removed. False otherwise.
  */
-void RobotConstraintEditor::replace_data(const std::string& tag, const VFIConfigurationFile::Data& data)
+bool RobotConstraintEditor::is_valid(const ConstraintId& id) const
 {
-    try{
-        remove_data(tag);
-        add_data(data);
-    } catch (const std::runtime_error& e) {
-        std::cerr<<e.what()<<std::endl;
-        throw std::runtime_error("RobotConstraintEditor::edit_data: Fail to update the VFI data!");
-    }
+    return impl_->_find_entry(id.index_, id.generation_) != nullptr;
 }
 
 /**
- * @brief RobotConstraintEditor::add_data adds data to compose the YAML file.
- * @param data
+ * @brief RobotConstraintEditor::remove_data removes data
+ * @param tag
  */
-void RobotConstraintEditor::add_data(const VFIConfigurationFile::Data& data)
+void RobotConstraintEditor::remove_data(const std::string& tag)
 {
-    const std::string tag = impl_->_extract_tag(data);
-    if (impl_->is_tag_in_map(tag))
-        throw std::runtime_error("Tag '" + tag + "' is being used!");
-    impl_->yaml_raw_data_map_.try_emplace(tag, data);
+    remove_data(get_id(tag));
 }
 
 /**
  * @brief RobotConstraintEditor::remove_data removes data
- * @param tag
+ * @param id The handle of the constraint.
  */
-void RobotConstraintEditor::remove_data(const std::string& tag)
+void RobotConstraintEditor::remove_data(const ConstraintId& id)
 {
-    if (!impl_->is_tag_in_map(tag))
-        throw std::runtime_error("Tag '" + tag + "' not found!");
-    impl_->yaml_raw_data_map_.erase(tag);
+    auto entry = impl_->_find_entry(id.index_, id.generation_);
+    if (!entry)
+        throw std::runtime_error("Invalid ConstraintId!");
+    if (impl_->indexes_)
+        impl_->_update_indexes(impl_->_materialize(*entry), false);
+    const std::size_t position = impl_->handles_[id.index_].position;
+    const std::string tag = impl_->yaml_raw_data_map_.at_position(position)->first;
+    // The removed constraint is moved into the undo history
+    Impl::PRESENCE_CHANGE change{tag, std::nullopt, impl_->yaml_raw_data_map_.order_at(position)};
+    if (impl_->undo_mode_)
+        change.data = std::move(impl_->_materialize(*entry));
+    impl_->_erase_entry(tag);
+    impl_->last_save_.reset();
+    impl_->_journal_erase(tag);
+    impl_->_record(std::move(change));
+    impl_->_commit();
 }
 
 /**
@@ -167,163 +2338,674 @@ void RobotConstraintEditor::remove_data(const std::string& tag)
 template<typename T>
 void RobotConstraintEditor::edit_data(const std::string& tag, const std::string& key, const T& value)
 {
-    // Check if tag exists
-    if (!impl_->is_tag_in_map(tag))
-        throw std::runtime_error("Tag '" + tag + "' not found!");
-
-    auto& raw_data = impl_->yaml_raw_data_map_.at(tag);
-    bool modified = false;
-
-    std::visit([&](auto&& arg) {
-        using DataType = std::decay_t<decltype(arg)>;
+    edit_data(get_id(tag), key, value);
+}
 
-        // Helper function to assign value with type checking
-        auto assign_if_match = [&](auto& field, const std::string& field_name) -> bool {
-            if (key != field_name) return false;
+/**
+ * @brief RobotConstraintEditor::edit_data modifies the value of a key in the specified data.
+ * @param id The handle of the data to be edited. The handle stays valid if the tag is edited.
+ * @param key The key you want to modify.
+ * @param value The new value of the key.
+ */
+template<typename T>
+void RobotConstraintEditor::edit_data(const ConstraintId& id, const std::string& key, const T& value)
+{
+    auto entry_pointer = impl_->_find_entry(id.index_, id.generation_);
+    if (!entry_pointer)
+        throw std::runtime_error("Invalid ConstraintId!");
 
-            using FieldType = std::decay_t<decltype(field)>;
+    auto& entry = *entry_pointer;
+    auto& raw_data = impl_->_materialize(entry);
+    const std::string tag = impl_->_extract_tag(raw_data);
+    const auto field = find_field(key);
+    const auto before = (impl_->undo_mode_ && field) ? impl_->_field_value(raw_data, *field) : std::nullopt;
+    bool modified = false;
 
-            // Check if types are compatible
-            if constexpr (std::is_same_v<FieldType, T>) {
-                field = value;
-                return true;
-            } else if constexpr (std::is_convertible_v<T, FieldType>) {
-                field = value;  // Allow implicit conversions (int to double, etc.)
-                return true;
-            } else {
-                throw std::runtime_error("Type mismatch for field '" + key +
-                                         "'. Expected: " + typeid(FieldType).name() +
-                                         ", Got: " + typeid(T).name());
-            }
-        };
+    // The keys of the constraint are indexed again after the edit, or restored if it fails
+    impl_->_update_indexes(raw_data, false);
+    try {
+        std::visit([&](auto&& arg) {
+            using DataType = std::decay_t<decltype(arg)>;
 
-        if constexpr (std::is_same_v<DataType, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
-            // String fields
-            if (assign_if_match(arg.vfi_type, "vfi_type")) modified = true;
-            else if (assign_if_match(arg.entity_environment_primitive_type, "entity_environment_primitive_type")) modified = true;
-            else if (assign_if_match(arg.entity_robot_primitive_type, "entity_robot_primitive_type")) modified = true;
-            else if (assign_if_match(arg.direction, "direction")) modified = true;
-
-            // Integer fields
-            else if (assign_if_match(arg.robot_index, "robot_index")) modified = true;
-            else if (assign_if_match(arg.joint_index, "joint_index")) modified = true;
-
-            // Double fields (also accept int via conversion)
-            else if (assign_if_match(arg.safe_distance, "safe_distance")) modified = true;
-            else if (assign_if_match(arg.vfi_gain, "vfi_gain")) modified = true;
-
-            // Vector fields
-            else if (assign_if_match(arg.cs_entity_environment, "cs_entity_environment")) modified = true;
-            else if (assign_if_match(arg.cs_entity_robot, "cs_entity_robot")) modified = true;
-
-            // Special handling for tag - update map key
-            else if (key == "tag") {
-                if constexpr (std::is_same_v<T, std::string> ||
-                              std::is_convertible_v<T, std::string>) {
-                    std::string old_tag = arg.tag;
+            if (field == FIELD::TAG) {
+                // Special handling for tag - update map key
+                if constexpr (std::is_convertible_v<T, std::string>) {
+                    // Update the map key. The entry keeps its position in the file.
+                    if (!impl_->yaml_raw_data_map_.rename(arg.tag, value))
+                        throw std::runtime_error("Tag '" + std::string(value) + "' is being used!");
+                    impl_->_version_rename(arg.tag, value);
                     arg.tag = value;
-
-                    // Update the map key
-                    auto node_handler = impl_->yaml_raw_data_map_.extract(old_tag);
-                    if (!node_handler.empty()) {
-                        node_handler.key() = value;
-                        impl_->yaml_raw_data_map_.insert(std::move(node_handler));
-                    }
                     modified = true;
                 } else {
                     throw std::runtime_error("Tag must be convertible to string");
                 }
-            }
-            else {
-                throw std::runtime_error("Key '" + key + "' not found for ENVIRONMENT_TO_ROBOT");
-            }
+            } else if (field) {
+                for_each_field(arg, [&](auto descriptor, auto& field_value) {
+                    if (descriptor.field != *field)
+                        return;
 
-        } else if constexpr (std::is_same_v<DataType, VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>) {
-            // String fields
-            if (assign_if_match(arg.vfi_type, "vfi_type")) modified = true;
-            else if (assign_if_match(arg.entity_one_primitive_type, "entity_one_primitive_type")) modified = true;
-            else if (assign_if_match(arg.entity_two_primitive_type, "entity_two_primitive_type")) modified = true;
-            else if (assign_if_match(arg.direction, "direction")) modified = true;
-
-            // Integer fields
-            else if (assign_if_match(arg.robot_index_one, "robot_index_one")) modified = true;
-            else if (assign_if_match(arg.robot_index_two, "robot_index_two")) modified = true;
-            else if (assign_if_match(arg.joint_index_one, "joint_index_one")) modified = true;
-            else if (assign_if_match(arg.joint_index_two, "joint_index_two")) modified = true;
-
-            // Double fields
-            else if (assign_if_match(arg.safe_distance, "safe_distance")) modified = true;
-            else if (assign_if_match(arg.vfi_gain, "vfi_gain")) modified = true;
-
-            // Vector fields
-            else if (assign_if_match(arg.cs_entity_one, "cs_entity_one")) modified = true;
-            else if (assign_if_match(arg.cs_entity_two, "cs_entity_two")) modified = true;
-
-            // Special handling for tag
-            // IF the tag is modified, we need to update the new tag in the map.
-            else if (key == "tag") {
-                if constexpr (std::is_same_v<T, std::string> ||
-                              std::is_convertible_v<T, std::string>) {
-                    std::string old_tag = arg.tag;
-                    arg.tag = value;
+                    using FieldType = typename decltype(descriptor)::type;
 
-                    // Update the map key
-                    auto node_handler = impl_->yaml_raw_data_map_.extract(old_tag);
-                    if (!node_handler.empty()) {
-                        node_handler.key() = value;
-                        impl_->yaml_raw_data_map_.insert(std::move(node_handler));
+                    // Check if types are compatible
+                    if constexpr (std::is_convertible_v<T, FieldType>) {
+                        field_value = value;  // Allow implicit conversions (int to double, etc.)
+                    } else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList> &&
+                                         std::is_same_v<T, std::vector<std::string>>) {
+                        field_value.assign(value.begin(), value.end());  // Intern the entity names
+                    } else {
+                        throw std::runtime_error("Type mismatch for field '" + key +
+                                                 "'. Expected: " + typeid(FieldType).name() +
+                                                 ", Got: " + typeid(T).name());
                     }
                     modified = true;
-                } else {
-                    throw std::runtime_error("Tag must be convertible to string");
-                }
+                });
             }
-            else {
-                throw std::runtime_error("Key '" + key + "' not found for ROBOT_TO_ROBOT");
+
+            if (!modified) {
+                throw std::runtime_error("Key '" + key + "' not found for " +
+                                         (std::is_same_v<DataType, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA> ?
+                                          "ENVIRONMENT_TO_ROBOT" : "ROBOT_TO_ROBOT"));
             }
-        }
-    }, raw_data);
+        }, raw_data);
+    } catch (...) {
+        impl_->_update_indexes(raw_data, true);
+        throw;
+    }
+    impl_->_update_indexes(raw_data, true);
 
     if (!modified) {
         throw std::runtime_error("Failed to edit field '" + key + "' for tag '" + tag + "'");
     }
+    entry.lazy_entry.reset();
+    impl_->_touch(entry);
+    impl_->last_save_.reset();
+    if (impl_->_extract_tag(raw_data) != tag)
+        impl_->_journal_rename(tag, raw_data);
+    else
+        impl_->_journal_put(raw_data);
+    if (before)
+    {
+        auto after = *impl_->_field_value(raw_data, *field);
+        if (after != *before)
+            impl_->_record(Impl::FIELD_CHANGE{impl_->_extract_tag(raw_data), *field, *before, std::move(after)});
+    }
+    impl_->_commit();
+
+}
+
+/**
+ * @brief RobotConstraintEditor::_begin_edit gets the data to be modified by edit(). The keys of
+ *        the data are removed from the indexes until _end_edit() is called.
+ * @param id The handle of the data to be edited.
+ * @param field The field to be edited, whose value is kept for the undo history.
+ * @return The desired data.
+ */
+VFIConfigurationFile::Data& RobotConstraintEditor::_begin_edit(const ConstraintId& id, const FIELD& field)
+{
+    auto entry = impl_->_find_entry(id.index_, id.generation_);
+    if (!entry)
+        throw std::runtime_error("Invalid ConstraintId!");
+
+    auto& raw_data = impl_->_materialize(*entry);
+    if (impl_->undo_mode_)
+        impl_->edit_before_ = impl_->_field_value(raw_data, field);
+    impl_->_update_indexes(raw_data, false);
+    return raw_data;
+}
 
+/**
+ * @brief RobotConstraintEditor::_end_edit indexes the data modified by edit() again, and records
+ *        the modification.
+ * @param id The handle of the edited data.
+ * @param modified True if the data has the edited field.
+ * @param field The edited field.
+ */
+void RobotConstraintEditor::_end_edit(const ConstraintId& id, const bool& modified, const FIELD& field)
+{
+    auto& entry = *impl_->_find_entry(id.index_, id.generation_);
+    const auto& raw_data = *entry.data;
+    impl_->_update_indexes(raw_data, true);
+
+    if (!modified) {
+        const bool environment_to_robot = std::holds_alternative<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(raw_data);
+        throw std::runtime_error("Key '" + std::string(field_names[static_cast<std::size_t>(field)]) +
+                                 "' not found for " + (environment_to_robot ? "ENVIRONMENT_TO_ROBOT" : "ROBOT_TO_ROBOT"));
+    }
+    entry.lazy_entry.reset();
+    impl_->_touch(entry);
+    impl_->last_save_.reset();
+    impl_->_journal_put(raw_data);
+    if (impl_->edit_before_)
+    {
+        auto after = *impl_->_field_value(raw_data, field);
+        if (after != *impl_->edit_before_)
+            impl_->_record(Impl::FIELD_CHANGE{impl_->_extract_tag(raw_data), field, std::move(*impl_->edit_before_),
+                                              std::move(after)});
+        impl_->edit_before_.reset();
+    }
+    impl_->_commit();
 }
 
 
 /**
- * @brief RobotConstraintEditor::save_data saves the current data in a YAML file.
+ * @brief RobotConstraintEditor::save_data saves the current data in a YAML file. Only the entries
+ *        modified since the previous save are serialized again, and the file is not written if
+ *        nothing changed since it was saved with the same parameters.
  * @param path_config_file The path to the YAML file, including its name and format.
  * @param vfi_file_version The version you want to specify.
  * @param zero_indexed The desired zero indexed flag you want to specify.
+ * @return True if the file was written. False if it was already saved with the same data.
  */
-void RobotConstraintEditor::save_data(const std::string& path_config_file,
+bool RobotConstraintEditor::save_data(const std::string& path_config_file,
                                       const int &vfi_file_version,
                                       const bool &zero_indexed)
 {
     if (impl_->interface_)
     {
-        std::vector<VFIConfigurationFile::Data> data;
-        data.reserve(impl_->yaml_raw_data_map_.size());
-        for (auto& pair : impl_->yaml_raw_data_map_)
-            data.push_back(pair.second);
+        if (impl_->_is_saved(path_config_file, vfi_file_version, zero_indexed))
+            return false;
+
+        if (impl_->validator_)
+        {
+            const auto diagnostics = impl_->_validate_for_save(zero_indexed);
+            if (ConstraintValidator::has_errors(diagnostics))
+            {
+                std::string errors;
+                for (const auto& diagnostic : diagnostics)
+                    if (diagnostic.severity == ConstraintValidator::SEVERITY::ERROR)
+                        errors += "\n  " + diagnostic.tag + " (" + diagnostic.rule + "): " + diagnostic.message;
+                throw std::runtime_error("RobotConstraintEditor::save_data: The constraints are invalid:" + errors);
+            }
+        }
 
-        impl_->interface_->save_data(data, vfi_file_version, zero_indexed, path_config_file);
+        const bool journal_file = impl_->journal_fd_ >= 0 &&
+                                  std::filesystem::weakly_canonical(path_config_file) ==
+                                  std::filesystem::weakly_canonical(impl_->journal_config_file_);
+        if (journal_file)
+            impl_->_wait_for_compaction();
+
+        impl_->_serialize_dirty_entries();
+        if (impl_->validator_)
+            impl_->validated_zero_indexed_ = zero_indexed;
+        else
+            impl_->validated_zero_indexed_.reset();
+        auto writer = impl_->interface_->open_writer(path_config_file, vfi_file_version, zero_indexed);
+        for (auto& pair : impl_->yaml_raw_data_map_)
+        {
+            if (pair.second.lazy_entry)
+                writer->write(*pair.second.lazy_entry);
+            else
+                writer->write(*pair.second.data);
+        }
+        writer->close();
+        impl_->_record_save(path_config_file, vfi_file_version, zero_indexed);
+        if (journal_file)
+            impl_->_reset_journal();
+        return true;
     }else
         throw std::runtime_error("The VFIConfigurationFile pointer is undefined!");
 }
 
 /**
- * @brief RobotConstraintEditor::get_raw_data returns the raw data vector
- * @return The desired vector
+ * @brief RobotConstraintEditor::set_validator sets the validator that save_data runs before
+ *        writing the file, with the index convention of the file. The file is not written if the
+ *        validator reports an error. After the first validated save, a save only checks the
+ *        constraints modified since the previous one, unless the convention changes. Call
+ *        set_validator again after changing the rules of the validator to check all of them.
+ * @param validator The desired validator, or nullptr to save without validation. Default: nullptr.
+ */
+void RobotConstraintEditor::set_validator(const std::shared_ptr<ConstraintValidator>& validator)
+{
+    impl_->validator_ = validator;
+    impl_->validated_zero_indexed_.reset();
+}
+
+/**
+ * @brief RobotConstraintEditor::validate checks the constraints with a validator, without copying
+ *        them. The lazy entries are decoded.
+ * @param validator The validator.
+ * @return The diagnostics, in file order. The index of a diagnostic is the position of its
+ *         constraint in get_data().
+ */
+std::vector<ConstraintValidator::DIAGNOSTIC> RobotConstraintEditor::validate(const ConstraintValidator& validator)
+{
+    std::vector<const VFIConfigurationFile::Data*> data;
+    data.reserve(impl_->yaml_raw_data_map_.size());
+    for (auto& pair : impl_->yaml_raw_data_map_)
+        data.push_back(&impl_->_materialize(pair.second));
+    return validator.validate(data);
+}
+
+/**
+ * @brief RobotConstraintEditor::find_duplicates finds the constraints that constrain the same
+ *        entities in the same way under different tags (see DuplicateDetector). The lazy entries
+ *        are decoded.
+ * @return The groups of duplicates, in file order. The indices of a group are the positions of its
+ *         constraints in get_data().
+ */
+std::vector<DuplicateDetector::GROUP> RobotConstraintEditor::find_duplicates()
+{
+    std::vector<const VFIConfigurationFile::Data*> data;
+    data.reserve(impl_->yaml_raw_data_map_.size());
+    for (auto& pair : impl_->yaml_raw_data_map_)
+        data.push_back(&impl_->_materialize(pair.second));
+    return DuplicateDetector::find_duplicates(data);
+}
+
+/**
+ * @brief RobotConstraintEditor::merge_duplicates merges each group of duplicates into its first
+ *        constraint, which takes the strictest safe_distance of the group. The other constraints
+ *        are removed. The merge is a single modification of the editor, journaled as a single record
+ *        group: if it fails, the constraints that were already merged are restored.
+ * @return The number of constraints removed.
+ */
+std::size_t RobotConstraintEditor::merge_duplicates()
+{
+    const auto groups = find_duplicates();
+    std::size_t removed = 0;
+    // The changes are recorded even without the undo mode, to revert the merge if it fails
+    const bool undo_mode = impl_->undo_mode_;
+    impl_->undo_mode_ = true;
+    impl_->_begin_journal_group();
+    try {
+        {
+            Impl::BATCH batch(*impl_);
+            for (const auto& group : groups)
+            {
+                const ConstraintId kept = get_id(group.tags.front());
+                const double safe_distance = std::visit([](auto&& arg) { return arg.safe_distance; }, get_data(kept));
+                if (safe_distance != group.safe_distance)
+                    _set_field(kept, FIELD::SAFE_DISTANCE, group.safe_distance);
+                for (std::size_t i = 1; i < group.tags.size(); ++i, ++removed)
+                    remove_data(group.tags[i]);
+            }
+        }
+        impl_->_end_journal_group();
+    } catch (...) {
+        _revert_pending(undo_mode);
+        throw;
+    }
+    impl_->undo_mode_ = undo_mode;
+    if (!undo_mode)
+        impl_->pending_ = Impl::STEP();
+    impl_->_commit();
+    return removed;
+}
+
+/**
+ * @brief RobotConstraintEditor::get_constraint_table gets a columnar view of the constraints.
+ * @return The desired table, with the rows in file order.
+ */
+ConstraintTable RobotConstraintEditor::get_constraint_table()
+{
+    ConstraintTable table;
+    for (auto& pair : impl_->yaml_raw_data_map_)
+        table.add(impl_->_materialize(pair.second));
+    return table;
+}
+
+/**
+ * @brief RobotConstraintEditor::apply_constraint_table copies the rows modified in a ConstraintTable
+ *        into the constraints with the same tags. Either all the rows are applied, or none is.
+ * @param table The table obtained from get_constraint_table.
+ */
+void RobotConstraintEditor::apply_constraint_table(const ConstraintTable& table)
+{
+    const auto& environment_to_robot = table.get_environment_to_robot_columns();
+    const auto& robot_to_robot = table.get_robot_to_robot_columns();
+
+    // Finds all the entries first, so nothing is modified if a row cannot be applied
+    std::vector<Impl::ENTRY*> environment_to_robot_entries(environment_to_robot.tag.size(), nullptr);
+    std::vector<Impl::ENTRY*> robot_to_robot_entries(robot_to_robot.tag.size(), nullptr);
+    auto find_entry = [this](const std::string& tag, const std::size_t& type_index) {
+        auto it = impl_->yaml_raw_data_map_.find(tag);
+        if (it == impl_->yaml_raw_data_map_.end())
+            throw std::runtime_error("Tag '" + tag + "' not found!");
+        if (impl_->_materialize(it->second).index() != type_index)
+            throw std::runtime_error("Tag '" + tag + "' has a different VFI type in the ConstraintTable!");
+        return &it->second;
+    };
+    for (std::size_t i = 0; i < environment_to_robot.tag.size(); ++i)
+        if (environment_to_robot.modified[i])
+            environment_to_robot_entries[i] = find_entry(environment_to_robot.tag[i], 0);
+    for (std::size_t i = 0; i < robot_to_robot.tag.size(); ++i)
+        if (robot_to_robot.modified[i])
+            robot_to_robot_entries[i] = find_entry(robot_to_robot.tag[i], 1);
+
+    // Only the fields that change are recorded in the undo history
+    auto assign = [this](const auto& data, const FIELD& field, auto& member, const auto& value) {
+        if (impl_->undo_mode_ && member != value)
+            impl_->_record(Impl::FIELD_CHANGE{data.tag, field, member, value});
+        member = value;
+    };
+    auto commit = [this](Impl::ENTRY* entry) {
+        impl_->_update_indexes(*entry->data, true);
+        entry->lazy_entry.reset();
+        impl_->_touch(*entry);
+        impl_->last_save_.reset();
+        impl_->_journal_put(*entry->data);
+    };
+    for (std::size_t i = 0; i < environment_to_robot_entries.size(); ++i)
+    {
+        if (!environment_to_robot_entries[i])
+            continue;
+        auto& data = std::get<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(*environment_to_robot_entries[i]->data);
+        impl_->_update_indexes(*environment_to_robot_entries[i]->data, false);
+        assign(data, FIELD::SAFE_DISTANCE, data.safe_distance, environment_to_robot.safe_distance[i]);
+        assign(data, FIELD::VFI_GAIN, data.vfi_gain, environment_to_robot.vfi_gain[i]);
+        assign(data, FIELD::ROBOT_INDEX, data.robot_index, environment_to_robot.robot_index[i]);
+        assign(data, FIELD::JOINT_INDEX, data.joint_index, environment_to_robot.joint_index[i]);
+        commit(environment_to_robot_entries[i]);
+    }
+    for (std::size_t i = 0; i < robot_to_robot_entries.size(); ++i)
+    {
+        if (!robot_to_robot_entries[i])
+            continue;
+        auto& data = std::get<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(*robot_to_robot_entries[i]->data);
+        impl_->_update_indexes(*robot_to_robot_entries[i]->data, false);
+        assign(data, FIELD::SAFE_DISTANCE, data.safe_distance, robot_to_robot.safe_distance[i]);
+        assign(data, FIELD::VFI_GAIN, data.vfi_gain, robot_to_robot.vfi_gain[i]);
+        assign(data, FIELD::ROBOT_INDEX_ONE, data.robot_index_one, robot_to_robot.robot_index_one[i]);
+        assign(data, FIELD::ROBOT_INDEX_TWO, data.robot_index_two, robot_to_robot.robot_index_two[i]);
+        assign(data, FIELD::JOINT_INDEX_ONE, data.joint_index_one, robot_to_robot.joint_index_one[i]);
+        assign(data, FIELD::JOINT_INDEX_TWO, data.joint_index_two, robot_to_robot.joint_index_two[i]);
+        commit(robot_to_robot_entries[i]);
+    }
+    impl_->_commit();
+}
+
+/**
+ * @brief RobotConstraintEditor::set_number_of_query_threads sets the number of threads used by
+ *        select_tags and apply_query to match the constraints. The constraints are only split
+ *        when there are enough of them for each thread. If zero,
+ *        std::thread::hardware_concurrency() is used. Default: 1.
+ * @param number_of_threads The desired number of threads.
+ */
+void RobotConstraintEditor::set_number_of_query_threads(const int& number_of_threads)
+{
+    impl_->number_of_query_threads_ = number_of_threads;
+}
+
+/**
+ * @brief RobotConstraintEditor::select_tags finds the constraints that satisfy the conditions of
+ *        a query, without copying them.
+ * @param query The query.
+ * @return The tags of the constraints, in file order.
+ */
+std::vector<std::string> RobotConstraintEditor::select_tags(const ConstraintQuery& query)
+{
+    std::vector<std::string> tags;
+    for (const auto& position : impl_->_match(query))
+        tags.push_back(impl_->yaml_raw_data_map_.at_position(position)->first);
+    return tags;
+}
+
+/**
+ * @brief RobotConstraintEditor::apply_query applies the updates of a query to the constraints that
+ *        satisfy its conditions, in one pass and as a single modification of the editor.
+ * @param query The query.
+ * @return The number of constraints that changed.
+ */
+std::size_t RobotConstraintEditor::apply_query(const ConstraintQuery& query)
+{
+    const auto& fields = query.get_updated_fields();
+    std::vector<std::optional<FIELD_VALUE>> before(fields.size());
+    std::size_t updated = 0;
+    for (const auto& position : impl_->_match(query))
+    {
+        auto& entry = impl_->yaml_raw_data_map_.at_position(position)->second;
+        auto& data = *entry.data;
+        if (impl_->undo_mode_)
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                before[i] = impl_->_field_value(data, fields[i]);
+        impl_->_update_indexes(data, false);
+        const bool modified = query.update(data);
+        impl_->_update_indexes(data, true);
+        if (!modified)
+            continue;
+
+        // Only the fields that change are recorded in the undo history
+        for (std::size_t i = 0; i < fields.size() && impl_->undo_mode_; ++i)
+        {
+            if (!before[i])
+                continue;
+            auto after = *impl_->_field_value(data, fields[i]);
+            if (after != *before[i])
+                impl_->_record(Impl::FIELD_CHANGE{impl_->_extract_tag(data), fields[i], std::move(*before[i]), std::move(after)});
+        }
+        entry.lazy_entry.reset();
+        impl_->_touch(entry);
+        impl_->_journal_put(data);
+        ++updated;
+    }
+    if (updated > 0)
+        impl_->last_save_.reset();
+    impl_->_commit();
+    return updated;
+}
+
+/**
+ * @brief RobotConstraintEditor::get_tags_by_robot finds the constraints that involve a robot. The
+ *        indexes are built by the first query, which decodes the lazy entries, and are kept up to
+ *        date by the modifications after that.
+ * @param robot_index The robot index (robot_index, robot_index_one or robot_index_two).
+ * @return A view of the tags, which is invalidated by the next modification of the data.
+ */
+TagView RobotConstraintEditor::get_tags_by_robot(const int& robot_index)
+{
+    const auto& index = impl_->_get_indexes().robot;
+    const auto it = index.find(robot_index);
+    return TagView(it == index.end() ? nullptr : &it->second);
+}
+
+/**
+ * @brief RobotConstraintEditor::get_tags_by_joint finds the constraints that involve a joint of a robot.
+ * @param robot_index The robot index.
+ * @param joint_index The joint index of the same side of the constraint.
+ * @return A view of the tags, which is invalidated by the next modification of the data.
+ */
+TagView RobotConstraintEditor::get_tags_by_joint(const int& robot_index, const int& joint_index)
+{
+    const auto& index = impl_->_get_indexes().robot_joint;
+    const auto it = index.find(Impl::_robot_joint_key(robot_index, joint_index));
+    return TagView(it == index.end() ? nullptr : &it->second);
+}
+
+/**
+ * @brief RobotConstraintEditor::get_tags_by_entity finds the constraints that reference an entity
+ *        in any of their cs_entity_* lists.
+ * @param entity The entity name.
+ * @return A view of the tags, which is invalidated by the next modification of the data.
+ */
+TagView RobotConstraintEditor::get_tags_by_entity(const std::string& entity)
+{
+    // An entity name that is not interned is not referenced by any constraint
+    const auto symbol = Symbol::find(entity);
+    if (!symbol)
+        return TagView(nullptr);
+    const auto& index = impl_->_get_indexes().entity;
+    const auto it = index.find(*symbol);
+    return TagView(it == index.end() ? nullptr : &it->second);
+}
+
+/**
+ * @brief RobotConstraintEditor::get_data gets a constraint without copying it. In concurrent mode,
+ *        only the writer thread may call it (see set_concurrent_mode).
+ * @param tag The tag of the constraint.
+ * @return The constraint, which is valid until it is modified or removed.
+ */
+const VFIConfigurationFile::Data& RobotConstraintEditor::get_data(const std::string& tag)
+{
+    auto it = impl_->yaml_raw_data_map_.find(tag);
+    if (it == impl_->yaml_raw_data_map_.end())
+        throw std::runtime_error("Tag '" + tag + "' not found!");
+    return impl_->_materialize(it->second);
+}
+
+/**
+ * @brief RobotConstraintEditor::get_data gets a constraint without copying it.
+ * @param id The handle of the constraint.
+ * @return The constraint, which is valid until it is modified or removed.
+ */
+const VFIConfigurationFile::Data& RobotConstraintEditor::get_data(const ConstraintId& id)
+{
+    auto entry = impl_->_find_entry(id.index_, id.generation_);
+    if (!entry)
+        throw std::runtime_error("Invalid ConstraintId!");
+    return impl_->_materialize(*entry);
+}
+
+/**
+ * @brief RobotConstraintEditor::get_data_view gets a view of the constraints, which does not copy them.
+ * @return The desired view, in file order.
+ */
+RobotConstraintEditor::DataView RobotConstraintEditor::get_data_view()
+{
+    return DataView(impl_.get());
+}
+
+RobotConstraintEditor::DataView::DataView(Impl* impl)
+    : impl_(impl)
+{
+}
+
+RobotConstraintEditor::DataView::const_iterator RobotConstraintEditor::DataView::begin() const
+{
+    return const_iterator(impl_, impl_->_next_position(0));
+}
+
+RobotConstraintEditor::DataView::const_iterator RobotConstraintEditor::DataView::end() const
+{
+    return const_iterator(impl_, impl_->yaml_raw_data_map_.position_end());
+}
+
+std::size_t RobotConstraintEditor::DataView::size() const
+{
+    return impl_->yaml_raw_data_map_.size();
+}
+
+bool RobotConstraintEditor::DataView::empty() const
+{
+    return impl_->yaml_raw_data_map_.empty();
+}
+
+RobotConstraintEditor::DataView::const_iterator::const_iterator(Impl* impl, const std::size_t& position)
+    : impl_(impl), position_(position)
+{
+}
+
+const VFIConfigurationFile::Data& RobotConstraintEditor::DataView::const_iterator::operator*() const
+{
+    return impl_->_materialize(impl_->yaml_raw_data_map_.at_position(position_)->second);
+}
+
+const VFIConfigurationFile::Data* RobotConstraintEditor::DataView::const_iterator::operator->() const
+{
+    return &**this;
+}
+
+RobotConstraintEditor::DataView::const_iterator& RobotConstraintEditor::DataView::const_iterator::operator++()
+{
+    position_ = impl_->_next_position(position_ + 1);
+    return *this;
+}
+
+RobotConstraintEditor::DataView::const_iterator RobotConstraintEditor::DataView::const_iterator::operator++(int)
+{
+    const_iterator it = *this;
+    ++(*this);
+    return it;
+}
+
+/**
+ * @brief RobotConstraintEditor::get_raw_data returns the raw data vector. In concurrent mode, the
+ *        vector is copied from the last published snapshot.
+ * @return The desired vector, in file order. The data added after loading the file is at the end.
  */
 std::vector<VFIConfigurationFile::Data> RobotConstraintEditor::get_data()
 {
+    if (impl_->concurrent_mode_)
+        return get_snapshot().get_data();
     std::vector<VFIConfigurationFile::Data> raw_data;
     raw_data.reserve(impl_->yaml_raw_data_map_.size());
     for (auto& pair : impl_->yaml_raw_data_map_)
-        raw_data.push_back(pair.second);
+        raw_data.push_back(impl_->_materialize(pair.second));
+    return raw_data;
+}
+
+RobotConstraintEditor::Snapshot::Snapshot(const std::shared_ptr<const State>& state)
+    : state_(state)
+{
+
+}
+
+/**
+ * @brief RobotConstraintEditor::Snapshot::size gets the number of constraints of the snapshot.
+ * @return The desired number.
+ */
+std::size_t RobotConstraintEditor::Snapshot::size() const
+{
+    return state_ ? state_->positions.size() : 0;
+}
+
+bool RobotConstraintEditor::Snapshot::empty() const
+{
+    return size() == 0;
+}
+
+bool RobotConstraintEditor::Snapshot::contains(const std::string& tag) const
+{
+    return find(tag) != nullptr;
+}
+
+/**
+ * @brief RobotConstraintEditor::Snapshot::find finds a constraint of the snapshot.
+ * @param tag The tag of the constraint.
+ * @return The desired constraint, or nullptr if the snapshot has no such tag.
+ */
+const VFIConfigurationFile::Data* RobotConstraintEditor::Snapshot::find(const std::string& tag) const
+{
+    if (!state_)
+        return nullptr;
+    const auto position = state_->positions.find(tag);
+    if (!position)
+        return nullptr;
+    return state_->entries.get(*position).get();
+}
+
+/**
+ * @brief RobotConstraintEditor::Snapshot::get_data gets a constraint of the snapshot without copying it.
+ * @param tag The tag of the constraint.
+ * @return A reference to the constraint, valid while the snapshot exists.
+ */
+const VFIConfigurationFile::Data& RobotConstraintEditor::Snapshot::get_data(const std::string& tag) const
+{
+    const auto data = find(tag);
+    if (!data)
+        throw std::runtime_error("Tag '" + tag + "' not found!");
+    return *data;
+}
+
+/**
+ * @brief RobotConstraintEditor::Snapshot::get_data copies the constraints of the snapshot.
+ * @return The desired vector, in file order.
+ */
+std::vector<VFIConfigurationFile::Data> RobotConstraintEditor::Snapshot::get_data() const
+{
+    std::vector<VFIConfigurationFile::Data> raw_data;
+    raw_data.reserve(size());
+    _for_each([&raw_data](const VFIConfigurationFile::Data& data) { raw_data.push_back(data); });
     return raw_data;
 }
 
+void RobotConstraintEditor::Snapshot::_for_each(const std::function<void(const VFIConfigurationFile::Data&)>& function) const
+{
+    if (!state_)
+        return;
+    state_->entries.for_each([&function](const std::shared_ptr<const VFIConfigurationFile::Data>& entry) {
+        if (entry)
+            function(*entry);
+    });
+}
+
 }
@@ -0,0 +1,197 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+
+#include <dqrobotics_extensions/robot_constraint_editor/symbol.hpp>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace DQ_robotics_extensions
+{
+
+struct Symbol::ENTRY
+{
+    std::string value;
+    std::uint32_t id;
+};
+
+namespace
+{
+
+/**
+ * @brief The SymbolPool class stores the interned strings. The pool is split in shards, each one
+ *        with its own mutex, so threads that intern different strings rarely wait on each other.
+ */
+class SymbolPool
+{
+    static constexpr std::size_t number_of_shards_ = 64;
+    struct SHARD
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, const Symbol::ENTRY*> index;
+        std::deque<Symbol::ENTRY> entries; // Stable addresses
+    };
+    std::array<SHARD, number_of_shards_> shards_;
+    std::atomic<std::uint32_t> next_id_{0};
+    std::array<const Symbol::ENTRY*, 9> well_known_;
+
+public:
+    SymbolPool()
+    {
+        // The order defines the ids of the VFI_TYPE, DIRECTION and PRIMITIVE_TYPE enums
+        const char* well_known[] = {"", "ENVIRONMENT_TO_ROBOT", "ROBOT_TO_ROBOT", "SAFE_ZONE", "RESTRICTED_ZONE",
+                                    "POINT", "LINE", "PLANE", "LINESEGMENT"};
+        for (std::size_t i = 0; i < well_known_.size(); ++i)
+            well_known_[i] = intern(well_known[i]);
+    }
+
+    const Symbol::ENTRY* intern(const std::string_view& value)
+    {
+        const std::size_t hash = std::hash<std::string_view>()(value);
+        SHARD& shard = shards_[hash % number_of_shards_];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.index.find(value);
+        if (it != shard.index.end())
+            return it->second;
+        shard.entries.push_back(Symbol::ENTRY{std::string(value), next_id_++});
+        const Symbol::ENTRY* entry = &shard.entries.back();
+        shard.index.emplace(entry->value, entry);
+        return entry;
+    }
+
+    /**
+     * @brief find looks up a string without interning it.
+     * @return The entry of the string, or nullptr if the string is not interned.
+     */
+    const Symbol::ENTRY* find(const std::string_view& value)
+    {
+        const std::size_t hash = std::hash<std::string_view>()(value);
+        SHARD& shard = shards_[hash % number_of_shards_];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.index.find(value);
+        return (it != shard.index.end()) ? it->second : nullptr;
+    }
+
+    const Symbol::ENTRY* well_known(const std::uint32_t& id) const
+    {
+        return well_known_.at(id);
+    }
+};
+
+SymbolPool& symbol_pool()
+{
+    static SymbolPool pool;
+    return pool;
+}
+
+}
+
+/**
+ * @brief Symbol::Symbol ctor of the empty string.
+ */
+Symbol::Symbol()
+    : entry_(symbol_pool().well_known(0))
+{
+}
+
+Symbol::Symbol(const std::string& value)
+    : entry_(symbol_pool().intern(value))
+{
+}
+
+Symbol::Symbol(const char* value)
+    : entry_(symbol_pool().intern(value))
+{
+}
+
+Symbol::Symbol(const std::string_view& value)
+    : entry_(symbol_pool().intern(value))
+{
+}
+
+Symbol::Symbol(const ENTRY* entry)
+    : entry_(entry)
+{
+}
+
+Symbol::Symbol(const VFI_TYPE& value)
+    : entry_(symbol_pool().well_known(static_cast<std::uint32_t>(value)))
+{
+}
+
+Symbol::Symbol(const DIRECTION& value)
+    : entry_(symbol_pool().well_known(static_cast<std::uint32_t>(value)))
+{
+}
+
+Symbol::Symbol(const PRIMITIVE_TYPE& value)
+    : entry_(symbol_pool().well_known(static_cast<std::uint32_t>(value)))
+{
+}
+
+/**
+ * @brief Symbol::find gets the Symbol of a string only if the string is already interned, so
+ *        lookups with arbitrary strings do not grow the pool.
+ * @param value The string.
+ * @return The desired Symbol, or std::nullopt if no Symbol holds the string.
+ */
+std::optional<Symbol> Symbol::find(const std::string_view& value)
+{
+    if (const ENTRY* entry = symbol_pool().find(value))
+        return Symbol(entry);
+    return std::nullopt;
+}
+
+/**
+ * @brief Symbol::str gets the interned string.
+ * @return The desired string.
+ */
+const std::string& Symbol::str() const
+{
+    return entry_->value;
+}
+
+Symbol::operator const std::string&() const
+{
+    return entry_->value;
+}
+
+/**
+ * @brief Symbol::id gets the id of the interned string. The ids of the well-known strings are the
+ *        values of the VFI_TYPE, DIRECTION and PRIMITIVE_TYPE enums.
+ * @return The desired id.
+ */
+std::uint32_t Symbol::id() const
+{
+    return entry_->id;
+}
+
+bool Symbol::empty() const
+{
+    return entry_->value.empty();
+}
+
+}
@@ -1,6 +1,15 @@
 #include <dqrobotics_extensions/robot_constraint_editor/utils.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_field_table.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace DQ_robotics_extensions {
 
@@ -28,6 +37,126 @@ std::string join_vector(const std::vector<std::string>& vec, const std::string&
 }
 
 
+/**
+ * @brief join_vector create a string from a Symbol vector.
+ * @param vec The Symbol vector
+ * @param delimiter A string to separate the elements of the vector
+ * @return The desired string
+ */
+std::string join_vector(const VFIConfigurationFile::EntityList& vec, const std::string& delimiter) {
+    std::string result;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        result += vec[i].str();
+        if (i < vec.size() - 1) {
+            result += delimiter;
+        }
+    }
+    return result;
+}
+
+
+/**
+ * @brief write_file_atomically writes a file with an AtomicFile. Readers never see a half-written
+ *        file, and a crash during the write leaves the previous file intact.
+ * @param file_name The name of the file including its path.
+ * @param contents The contents of the file.
+ */
+void write_file_atomically(const std::string& file_name, const std::string& contents)
+{
+    AtomicFile file(file_name);
+    file.write(contents.data(), contents.size());
+    file.commit();
+}
+
+/**
+ * @brief AtomicFile::AtomicFile creates a temporary file with a unique name (file_name + ".XXXXXX"),
+ *        so concurrent writers of the same file never share it. The temporary file takes the
+ *        permissions of the file, if it exists, or 0644 otherwise.
+ * @param file_name The name of the file including its path.
+ */
+AtomicFile::AtomicFile(const std::string& file_name)
+    : file_name_(file_name)
+{
+    std::string name_template = file_name + ".XXXXXX";
+    fd_ = ::mkstemp(name_template.data());
+    if (fd_ < 0)
+        throw std::runtime_error("Cannot open file for writing: " + name_template + ": " + std::strerror(errno));
+    temporary_file_ = name_template;
+
+    struct stat file_status;
+    const mode_t mode = (::stat(file_name_.c_str(), &file_status) == 0) ? (file_status.st_mode & 07777) : 0644;
+    if (::fcntl(fd_, F_SETFD, FD_CLOEXEC) != 0 || ::fchmod(fd_, mode) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd_);
+        ::unlink(temporary_file_.c_str());
+        throw std::runtime_error("Cannot open file for writing: " + temporary_file_ + ": " + error);
+    }
+}
+
+/**
+ * @brief AtomicFile::~AtomicFile removes the temporary file if commit() was not called.
+ */
+AtomicFile::~AtomicFile()
+{
+    if (fd_ >= 0) {
+        ::close(fd_);
+        ::unlink(temporary_file_.c_str());
+    }
+}
+
+/**
+ * @brief AtomicFile::write appends bytes to the temporary file.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ */
+void AtomicFile::write(const char* data, const std::size_t& size)
+{
+    if (fd_ < 0)
+        throw std::runtime_error("The file " + file_name_ + " is already committed!");
+    std::size_t remaining = size;
+    while (remaining > 0) {
+        const ssize_t written = ::write(fd_, data, remaining);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            throw std::runtime_error("Cannot write file " + temporary_file_ + ": " + std::strerror(errno));
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+}
+
+/**
+ * @brief AtomicFile::commit flushes the temporary file to the disk and renames it over the file.
+ *        The directory is flushed too, so the rename survives a power loss.
+ */
+void AtomicFile::commit()
+{
+    if (fd_ < 0)
+        throw std::runtime_error("The file " + file_name_ + " is already committed!");
+    const bool synced = ::fsync(fd_) == 0;
+    const bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    if (!synced || !closed) {
+        const std::string error = std::strerror(errno);
+        ::unlink(temporary_file_.c_str());
+        throw std::runtime_error("Cannot write file " + temporary_file_ + ": " + error);
+    }
+    if (std::rename(temporary_file_.c_str(), file_name_.c_str()) != 0) {
+        const std::string error = std::strerror(errno);
+        ::unlink(temporary_file_.c_str());
+        throw std::runtime_error("Cannot rename " + temporary_file_ + " to " + file_name_ + ": " + error);
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(file_name_).parent_path();
+    const int directory_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    const bool directory_synced = directory_fd >= 0 && ::fsync(directory_fd) == 0;
+    const std::string error = std::strerror(errno);
+    if (directory_fd >= 0)
+        ::close(directory_fd);
+    if (!directory_synced)
+        throw std::runtime_error("Cannot flush the directory of " + file_name_ + ": " + error);
+}
+
 /**
  * @brief log_complete_raw_data displays on the terminal the raw data vector.
  * @param data The raw data vector obtained from the YAML file.
@@ -50,52 +179,22 @@ void VFIConfigurationFileData::show_data(const std::vector<VFIConfigurationFile:
     for (size_t i = 0; i < data.size(); ++i) {
         std::cout << "\n\n[" << i + 1 << "/" << data.size() << "] ";
 
-        if (std::holds_alternative<DQ_robotics_extensions::VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(data[i])) {
-            std::cout << "ENVIRONMENT_TO_ROBOT" << std::endl;
-            std::cout << std::string(50, '-') << std::endl;
-
-            auto& env_data = std::get<DQ_robotics_extensions::VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(data[i]);
-
-            std::cout << std::left << std::setw(35) << "  vfi_type:" << env_data.vfi_type << std::endl;
-            std::cout << std::setw(35) << "  cs_entity_environment:"
-                      << "[" << join_vector(env_data.cs_entity_environment) << "]" << std::endl;
-            std::cout << std::setw(35) << "  cs_entity_robot:"
-                      << "[" << join_vector(env_data.cs_entity_robot) << "]" << std::endl;
-            std::cout << std::setw(35) << "  entity_environment_primitive_type:"
-                      << env_data.entity_environment_primitive_type << std::endl;
-            std::cout << std::setw(35) << "  entity_robot_primitive_type:"
-                      << env_data.entity_robot_primitive_type << std::endl;
-            std::cout << std::setw(35) << "  robot_index:" << env_data.robot_index << std::endl;
-            std::cout << std::setw(35) << "  joint_index:" << env_data.joint_index << std::endl;
-            std::cout << std::setw(35) << "  safe_distance:" << env_data.safe_distance << std::endl;
-            std::cout << std::setw(35) << "  vfi_gain:" << env_data.vfi_gain << std::endl;
-            std::cout << std::setw(35) << "  direction:" << env_data.direction << std::endl;
-            std::cout << std::setw(35) << "  tag:" << env_data.tag << std::endl;
-
-        } else {
-            std::cout << "ROBOT_TO_ROBOT" << std::endl;
-            std::cout << std::string(50, '-') << std::endl;
-
-            auto& robot_data = std::get<DQ_robotics_extensions::VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(data[i]);
-
-            std::cout << std::left << std::setw(35) << "  vfi_type:" << robot_data.vfi_type << std::endl;
-            std::cout << std::setw(35) << "  cs_entity_one:"
-                      << "[" << join_vector(robot_data.cs_entity_one) << "]" << std::endl;
-            std::cout << std::setw(35) << "  cs_entity_two:"
-                      << "[" << join_vector(robot_data.cs_entity_two) << "]" << std::endl;
-            std::cout << std::setw(35) << "  entity_one_primitive_type:"
-                      << robot_data.entity_one_primitive_type << std::endl;
-            std::cout << std::setw(35) << "  entity_two_primitive_type:"
-                      << robot_data.entity_two_primitive_type << std::endl;
-            std::cout << std::setw(35) << "  robot_index_one:" << robot_data.robot_index_one << std::endl;
-            std::cout << std::setw(35) << "  robot_index_two:" << robot_data.robot_index_two << std::endl;
-            std::cout << std::setw(35) << "  joint_index_one:" << robot_data.joint_index_one << std::endl;
-            std::cout << std::setw(35) << "  joint_index_two:" << robot_data.joint_index_two << std::endl;
-            std::cout << std::setw(35) << "  safe_distance:" << robot_data.safe_distance << std::endl;
-            std::cout << std::setw(35) << "  vfi_gain:" << robot_data.vfi_gain << std::endl;
-            std::cout << std::setw(35) << "  direction:" << robot_data.direction << std::endl;
-            std::cout << std::setw(35) << "  tag:" << robot_data.tag << std::endl;
-        }
+        const bool environment_to_robot = std::holds_alternative<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(data[i]);
+        std::cout << (environment_to_robot ? "ENVIRONMENT_TO_ROBOT" : "ROBOT_TO_ROBOT") << std::endl;
+        std::cout << std::string(50, '-') << std::endl;
+        std::cout << std::left;
+
+        std::visit([](auto&& arg) {
+            for_each_field(arg, [](auto descriptor, const auto& value) {
+                using Descriptor = decltype(descriptor);
+                const std::string label = "  " + std::string(Descriptor::name) + ":";
+
+                if constexpr (std::is_same_v<typename Descriptor::type, VFIConfigurationFile::EntityList>)
+                    std::cout << std::setw(35) << label << "[" << join_vector(value) << "]" << std::endl;
+                else
+                    std::cout << std::setw(35) << label << value << std::endl;
+            });
+        }, data[i]);
     }
     std::cout << "\n==========================================" << std::endl;
     std::cout << "END OF LOG" << std::endl;
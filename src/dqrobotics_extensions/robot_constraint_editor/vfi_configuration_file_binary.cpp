@@ -0,0 +1,539 @@
+/*
+#    Copyright (c) 2024-2026 Adorno-Lab
+#
+#    robot_constraint_editor is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU Lesser General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    robot_constraint_editor is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public License
+#    along with robot_constraint_editor.  If not, see <https://www.gnu.org/licenses/>.
+#
+# ################################################################
+#
+#   Author: Juan Jose Quiroz Omana (email: juanjose.quirozomana@manchester.ac.uk)
+#
+# ################################################################
+*/
+
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_binary.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/utils.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace DQ_robotics_extensions
+{
+
+namespace
+{
+
+// Layout of format version 1. All the integers are little-endian.
+constexpr char magic[4] = {'V', 'F', 'I', 'B'};
+constexpr std::uint32_t format_version = 1;
+constexpr std::size_t header_size = 64;
+constexpr std::size_t record_size = 96;
+constexpr std::size_t entity_size = 8;
+
+constexpr std::uint32_t environment_to_robot_record = 0;
+constexpr std::uint32_t robot_to_robot_record = 1;
+constexpr std::uint32_t zero_indexed_flag = 1;
+
+template<typename T>
+T load_le(const unsigned char* p)
+{
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        bits |= static_cast<std::uint64_t>(p[i]) << (8*i);
+    T value;
+    if constexpr (sizeof(T) == 8) {
+        std::memcpy(&value, &bits, sizeof(T));
+    } else {
+        const auto narrow_bits = static_cast<std::uint32_t>(bits);
+        std::memcpy(&value, &narrow_bits, sizeof(T));
+    }
+    return value;
+}
+
+template<typename T>
+void store_le(std::string& buffer, const std::size_t& position, const T& value)
+{
+    std::uint64_t bits = 0;
+    if constexpr (sizeof(T) == 8) {
+        std::memcpy(&bits, &value, sizeof(T));
+    } else {
+        std::uint32_t narrow_bits;
+        std::memcpy(&narrow_bits, &value, sizeof(T));
+        bits = narrow_bits;
+    }
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        buffer[position + i] = static_cast<char>((bits >> (8*i)) & 0xFF);
+}
+
+/**
+ * @brief The VFIBinaryWriter class builds the image of a .vfib file in memory.
+ *        Repeated strings (types, directions, entity names) are stored once in the string pool.
+ */
+class VFIBinaryWriter
+{
+    std::string records_;
+    std::string entities_;
+    std::string string_pool_;
+    std::unordered_map<std::string, std::uint32_t> string_offsets_;
+    std::uint32_t entity_count_ = 0;
+
+    std::uint32_t _checked_u32(const std::size_t& value, const std::string& what)
+    {
+        if (value > std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("The " + what + " exceeds the limits of the VFI binary format!");
+        return static_cast<std::uint32_t>(value);
+    }
+
+    void _store_string(std::string& buffer, const std::size_t& position, const std::string& value)
+    {
+        auto it = string_offsets_.find(value);
+        if (it == string_offsets_.end()) {
+            it = string_offsets_.emplace(value, _checked_u32(string_pool_.size(), "string pool")).first;
+            string_pool_ += value;
+        }
+        store_le<std::uint32_t>(buffer, position, it->second);
+        store_le<std::uint32_t>(buffer, position + 4, _checked_u32(value.size(), "string length"));
+    }
+
+    void _store_entities(const std::size_t& position, const VFIConfigurationFile::EntityList& entities)
+    {
+        store_le<std::uint32_t>(records_, position, entity_count_);
+        store_le<std::uint32_t>(records_, position + 4, _checked_u32(entities.size(), "entity list"));
+        for (const auto& entity : entities) {
+            const std::size_t entity_position = entities_.size();
+            entities_.resize(entity_position + entity_size);
+            _store_string(entities_, entity_position, entity);
+            entity_count_ = _checked_u32(std::size_t(entity_count_) + 1, "entity table");
+        }
+    }
+
+public:
+    void add(const VFIConfigurationFile::Data& data)
+    {
+        const std::size_t p = records_.size();
+        records_.resize(p + record_size, '\0');
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            store_le<double>(records_, p + 8, arg.safe_distance);
+            store_le<double>(records_, p + 16, arg.vfi_gain);
+            _store_string(records_, p + 24, arg.vfi_type);
+            _store_string(records_, p + 32, arg.direction);
+            _store_string(records_, p + 40, arg.tag);
+
+            if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
+                store_le<std::uint32_t>(records_, p, environment_to_robot_record);
+                _store_string(records_, p + 48, arg.entity_environment_primitive_type);
+                _store_string(records_, p + 56, arg.entity_robot_primitive_type);
+                _store_entities(p + 64, arg.cs_entity_environment);
+                _store_entities(p + 72, arg.cs_entity_robot);
+                store_le<std::int32_t>(records_, p + 80, arg.robot_index);
+                store_le<std::int32_t>(records_, p + 88, arg.joint_index);
+
+            } else if constexpr (std::is_same_v<T, VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>) {
+                store_le<std::uint32_t>(records_, p, robot_to_robot_record);
+                _store_string(records_, p + 48, arg.entity_one_primitive_type);
+                _store_string(records_, p + 56, arg.entity_two_primitive_type);
+                _store_entities(p + 64, arg.cs_entity_one);
+                _store_entities(p + 72, arg.cs_entity_two);
+                store_le<std::int32_t>(records_, p + 80, arg.robot_index_one);
+                store_le<std::int32_t>(records_, p + 84, arg.robot_index_two);
+                store_le<std::int32_t>(records_, p + 88, arg.joint_index_one);
+                store_le<std::int32_t>(records_, p + 92, arg.joint_index_two);
+            }
+        }, data);
+    }
+
+    std::string image(const int& vfi_file_version, const bool& zero_indexed) const
+    {
+        std::string header(header_size, '\0');
+        std::memcpy(header.data(), magic, sizeof(magic));
+        store_le<std::uint32_t>(header, 4, format_version);
+        store_le<std::int32_t>(header, 8, vfi_file_version);
+        store_le<std::uint32_t>(header, 12, zero_indexed ? zero_indexed_flag : 0);
+        store_le<std::uint64_t>(header, 16, records_.size() / record_size);
+        store_le<std::uint64_t>(header, 24, header_size);
+        store_le<std::uint64_t>(header, 32, entity_count_);
+        store_le<std::uint64_t>(header, 40, header_size + records_.size());
+        store_le<std::uint64_t>(header, 48, string_pool_.size());
+        store_le<std::uint64_t>(header, 56, header_size + records_.size() + entities_.size());
+        return header + records_ + entities_ + string_pool_;
+    }
+};
+
+}
+
+class VFIConfigurationFileBinary::Impl
+{
+public:
+    std::string config_file_;
+    int vfi_file_version_ = 2; // default value
+    bool zero_indexed_ = true; // default value
+
+    std::shared_ptr<const unsigned char> mapping_;
+    std::size_t size_ = 0;
+    std::size_t record_count_ = 0;
+    const unsigned char* records_ = nullptr;
+    std::size_t entity_count_ = 0;
+    const unsigned char* entities_ = nullptr;
+    std::size_t string_pool_size_ = 0;
+    const unsigned char* string_pool_ = nullptr;
+
+    /**
+     * @brief The FILE_OWNER struct deletes the source of the entries indexed by index_data. It
+     *        holds a copy of the Impl that indexed them, so the entries keep the mapping alive
+     *        after another file is loaded, and decode_entry gets it back with std::get_deleter.
+     */
+    struct FILE_OWNER{
+        std::shared_ptr<const Impl> file;
+        void operator()(const std::string* source) const
+        {
+            delete source;
+        }
+    };
+
+    Impl()
+    {
+
+    };
+
+    /**
+     * @brief _map_file maps the configuration file in memory.
+     */
+    void _map_file()
+    {
+        mapping_.reset();
+        size_ = 0;
+        record_count_ = 0;
+
+        const int fd = ::open(config_file_.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open file for reading: " + config_file_);
+        struct stat file_status;
+        if (::fstat(fd, &file_status) != 0 || file_status.st_size < static_cast<off_t>(header_size)) {
+            ::close(fd);
+            throw std::runtime_error("The file " + config_file_ + " is not a VFI binary file!");
+        }
+        const std::size_t size = static_cast<std::size_t>(file_status.st_size);
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED)
+            throw std::runtime_error("Cannot map file: " + config_file_);
+
+        mapping_ = std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(address),
+                                                        [size](const unsigned char* p) {
+            ::munmap(const_cast<unsigned char*>(p), size);
+        });
+        size_ = size;
+    }
+
+    /**
+     * @brief _section returns a pointer to a section of the file after checking its bounds.
+     */
+    const unsigned char* _section(const std::uint64_t& offset, const std::uint64_t& count,
+                                  const std::size_t& width, const std::string& name) const
+    {
+        if (offset > size_ || (width != 0 && count > (size_ - offset) / width))
+            throw std::runtime_error("The " + name + " of " + config_file_ + " is out of bounds!");
+        return mapping_.get() + offset;
+    }
+
+    /**
+     * @brief _read_header validates the header and locates the sections of the file.
+     */
+    void _read_header()
+    {
+        const unsigned char* header = mapping_.get();
+        if (std::memcmp(header, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("The file " + config_file_ + " is not a VFI binary file!");
+        const auto version = load_le<std::uint32_t>(header + 4);
+        if (version != format_version)
+            throw std::runtime_error("Unsupported VFI binary format version " + std::to_string(version) +
+                                     " in " + config_file_);
+
+        const auto record_count = load_le<std::uint64_t>(header + 16);
+        const auto entity_count = load_le<std::uint64_t>(header + 32);
+        const auto string_pool_size = load_le<std::uint64_t>(header + 48);
+        records_ = _section(load_le<std::uint64_t>(header + 24), record_count, record_size, "record table");
+        entities_ = _section(load_le<std::uint64_t>(header + 40), entity_count, entity_size, "entity table");
+        string_pool_ = _section(load_le<std::uint64_t>(header + 56), string_pool_size, 1, "string pool");
+
+        vfi_file_version_ = load_le<std::int32_t>(header + 8);
+        zero_indexed_ = (load_le<std::uint32_t>(header + 12) & zero_indexed_flag) != 0;
+        record_count_ = static_cast<std::size_t>(record_count);
+        entity_count_ = static_cast<std::size_t>(entity_count);
+        string_pool_size_ = static_cast<std::size_t>(string_pool_size);
+    }
+
+    std::string _decode_string(const unsigned char* p) const
+    {
+        const auto offset = load_le<std::uint32_t>(p);
+        const auto length = load_le<std::uint32_t>(p + 4);
+        if (offset > string_pool_size_ || length > string_pool_size_ - offset)
+            throw std::runtime_error("Invalid string reference in " + config_file_);
+        return std::string(reinterpret_cast<const char*>(string_pool_) + offset, length);
+    }
+
+    VFIConfigurationFile::EntityList _decode_entities(const unsigned char* p) const
+    {
+        const auto first = load_le<std::uint32_t>(p);
+        const auto count = load_le<std::uint32_t>(p + 4);
+        if (first > entity_count_ || count > entity_count_ - first)
+            throw std::runtime_error("Invalid entity list in " + config_file_);
+        VFIConfigurationFile::EntityList entities;
+        entities.reserve(count);
+        for (std::size_t i = first; i < std::size_t(first) + count; ++i)
+            entities.push_back(_decode_string(entities_ + i*entity_size));
+        return entities;
+    }
+
+    /**
+     * @brief _decode_record decodes a record of the record table.
+     * @param index The index of the record.
+     * @return The VFI data.
+     */
+    VFIConfigurationFile::Data _decode_record(const std::size_t& index) const
+    {
+        if (index >= record_count_)
+            throw std::runtime_error("Record index " + std::to_string(index) + " is out of range!");
+        const unsigned char* p = records_ + index*record_size;
+        const auto record_type = load_le<std::uint32_t>(p);
+
+        if (record_type == environment_to_robot_record) {
+            VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA env_data;
+            env_data.vfi_type = _decode_string(p + 24);
+            env_data.cs_entity_environment = _decode_entities(p + 64);
+            env_data.cs_entity_robot = _decode_entities(p + 72);
+            env_data.entity_environment_primitive_type = _decode_string(p + 48);
+            env_data.entity_robot_primitive_type = _decode_string(p + 56);
+            env_data.robot_index = load_le<std::int32_t>(p + 80);
+            env_data.joint_index = load_le<std::int32_t>(p + 88);
+            env_data.safe_distance = load_le<double>(p + 8);
+            env_data.vfi_gain = load_le<double>(p + 16);
+            env_data.direction = _decode_string(p + 32);
+            env_data.tag = _decode_string(p + 40);
+            return env_data;
+
+        }else if (record_type == robot_to_robot_record) {
+            VFIConfigurationFile::ROBOT_TO_ROBOT_DATA robot_data;
+            robot_data.vfi_type = _decode_string(p + 24);
+            robot_data.cs_entity_one = _decode_entities(p + 64);
+            robot_data.cs_entity_two = _decode_entities(p + 72);
+            robot_data.entity_one_primitive_type = _decode_string(p + 48);
+            robot_data.entity_two_primitive_type = _decode_string(p + 56);
+            robot_data.robot_index_one = load_le<std::int32_t>(p + 80);
+            robot_data.robot_index_two = load_le<std::int32_t>(p + 84);
+            robot_data.joint_index_one = load_le<std::int32_t>(p + 88);
+            robot_data.joint_index_two = load_le<std::int32_t>(p + 92);
+            robot_data.safe_distance = load_le<double>(p + 8);
+            robot_data.vfi_gain = load_le<double>(p + 16);
+            robot_data.direction = _decode_string(p + 32);
+            robot_data.tag = _decode_string(p + 40);
+            return robot_data;
+
+        }else {
+            throw std::runtime_error("Unknown record type " + std::to_string(record_type) + " in " + config_file_);
+        }
+    }
+};
+
+/**
+ * @brief VFIConfigurationFileBinary::VFIConfigurationFileBinary ctor of the class.
+ */
+VFIConfigurationFileBinary::VFIConfigurationFileBinary()
+{
+    impl_ = std::make_shared<VFIConfigurationFileBinary::Impl>();
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::load_data maps a .vfib file in memory and validates its header.
+ *        The records are decoded on demand.
+ * @param config_file The name of the file including its path and format.
+ */
+void VFIConfigurationFileBinary::load_data(const std::string& config_file)
+{
+    impl_->config_file_ = config_file;
+    impl_->_map_file();
+    impl_->_read_header();
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::index_data maps a .vfib file in memory as load_data does, and
+ *        indexes its records. Only the tag of each record is decoded. The first field of an
+ *        indexed entry is the index of its record.
+ * @param config_file The name of the file including its path and format.
+ * @param entries The indexed entries, in file order.
+ * @return True.
+ */
+bool VFIConfigurationFileBinary::index_data(const std::string& config_file, std::vector<LAZY_ENTRY>& entries)
+{
+    load_data(config_file);
+    const std::shared_ptr<const std::string> source(new std::string(config_file),
+                                                    Impl::FILE_OWNER{std::make_shared<const Impl>(*impl_)});
+    entries.clear();
+    entries.reserve(impl_->record_count_);
+    for (std::size_t i = 0; i < impl_->record_count_; ++i)
+        entries.push_back(LAZY_ENTRY{impl_->_decode_string(impl_->records_ + i*record_size + 40), source, i, i + 1, 0});
+    return true;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::decode_entry decodes a record indexed by index_data.
+ * @param entry The indexed entry.
+ * @return The decoded data.
+ */
+VFIConfigurationFile::Data VFIConfigurationFileBinary::decode_entry(const LAZY_ENTRY& entry) const
+{
+    const auto owner = std::get_deleter<Impl::FILE_OWNER>(entry.source);
+    if (!owner)
+        throw std::runtime_error("Entry '" + entry.tag + "' was not indexed from a VFI binary file!");
+    return owner->file->_decode_record(entry.first);
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::get_data decodes all the records of the file.
+ * @return A data vector.
+ */
+std::vector<VFIConfigurationFile::Data> VFIConfigurationFileBinary::get_data() const
+{
+    if (impl_->record_count_ == 0)
+        throw std::runtime_error("The vector data is empty!");
+    std::vector<VFIConfigurationFile::Data> data;
+    data.reserve(impl_->record_count_);
+    for (std::size_t i = 0; i < impl_->record_count_; ++i)
+        data.push_back(impl_->_decode_record(i));
+    return data;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::for_each_data decodes the records of the file one at a time,
+ *        and calls a function with each one, so the whole data vector is never built.
+ * @param function The function.
+ */
+void VFIConfigurationFileBinary::for_each_data(const std::function<void(const Data&)>& function) const
+{
+    for (std::size_t i = 0; i < impl_->record_count_; ++i)
+        function(impl_->_decode_record(i));
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::get_vfi_file_version gets the vfi_file_version stored in the file.
+ * @return The desired data.
+ */
+int VFIConfigurationFileBinary::get_vfi_file_version() const
+{
+    return impl_->vfi_file_version_;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::is_zero_indexed.
+ * @return Returns true if the configuration file uses a zero-indexed convention to
+ *         describe the joint and robot indexes. False otherwise.
+ */
+bool VFIConfigurationFileBinary::is_zero_indexed() const
+{
+    return impl_->zero_indexed_;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::get_number_of_records gets the number of records of the loaded file.
+ * @return The number of records.
+ */
+std::size_t VFIConfigurationFileBinary::get_number_of_records() const
+{
+    return impl_->record_count_;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::get_record decodes a single record of the loaded file.
+ * @param index The index of the record, in file order.
+ * @return The VFI data.
+ */
+VFIConfigurationFile::Data VFIConfigurationFileBinary::get_record(const std::size_t& index) const
+{
+    return impl_->_decode_record(index);
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::save_data saves a .vfib file containing the VFI constraints.
+ * @param data the vector that contains the VFI configurations
+ * @param vfi_file_version The desired format version
+ * @param zero_indexed To define if the data uses a zero-indexed convention.
+ * @param config_file The desired name of the file including its path and format.
+ */
+void VFIConfigurationFileBinary::save_data(const std::vector<Data>& data,
+                                           const int& vfi_file_version,
+                                           const bool& zero_indexed,
+                                           const std::string& config_file)
+{
+    if (!config_file.empty()) {
+        const std::filesystem::path directory = std::filesystem::path(config_file).parent_path();
+        std::error_code error;
+        if (!directory.empty() && !std::filesystem::exists(directory, error))
+            std::cout << "Creating directory: " << directory << std::endl;
+    }
+
+    write_data(data, vfi_file_version, zero_indexed, config_file);
+
+    std::cout << "Successfully saved " << data.size()
+              << " VFI entries to: " << config_file << std::endl;
+}
+
+/**
+ * @brief VFIConfigurationFileBinary::write_data saves a .vfib file as save_data does, without
+ *        reporting it on the console. The parse cache of VFIConfigurationFileYaml uses it.
+ * @param data the vector that contains the VFI configurations
+ * @param vfi_file_version The desired format version
+ * @param zero_indexed To define if the data uses a zero-indexed convention.
+ * @param config_file The desired name of the file including its path and format.
+ */
+void VFIConfigurationFileBinary::write_data(const std::vector<Data>& data,
+                                            const int& vfi_file_version,
+                                            const bool& zero_indexed,
+                                            const std::string& config_file)
+{
+    try {
+        if (config_file.empty())
+            throw std::runtime_error("config_file path cannot be empty!");
+
+        // Create directory if it doesn't exist
+        std::filesystem::path file_path(config_file);
+        std::filesystem::path directory = file_path.parent_path();
+
+        if (!directory.empty() && !std::filesystem::exists(directory))
+            std::filesystem::create_directories(directory);
+
+        VFIBinaryWriter writer;
+        for (const auto& item : data)
+            writer.add(item);
+        const std::string image = writer.image(vfi_file_version, zero_indexed);
+
+        // The file is written next to the destination and then renamed, so a file that is
+        // currently mapped by load_data is never truncated.
+        write_file_atomically(config_file, image);
+
+    } catch (const std::filesystem::filesystem_error& e) {
+        throw std::runtime_error("Filesystem error in save_data: " + std::string(e.what()));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in save_data: " + std::string(e.what()));
+    }
+}
+
+}
@@ -25,12 +25,1236 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <cstdint>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include <dqrobotics_extensions/robot_constraint_editor/utils.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_configuration_file_binary.hpp>
+#include <dqrobotics_extensions/robot_constraint_editor/vfi_field_table.hpp>
 
 namespace DQ_robotics_extensions
 {
 
+namespace
+{
+
+// Version of the cache file names and contents. Increase it when the cache becomes incompatible.
+constexpr int cache_format_version = 2;
+
+/**
+ * @brief hash_bytes computes a 64-bit non-cryptographic hash of a byte string, eight bytes at a time.
+ * @param text The byte string.
+ * @return The desired hash.
+ */
+std::uint64_t hash_bytes(const std::string& text)
+{
+    constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t hash = 0xCBF29CE484222325ULL ^ text.size();
+    std::size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, text.data() + i, sizeof(word));
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    for (; i < text.size(); ++i)
+        hash = (hash ^ static_cast<unsigned char>(text[i])) * multiplier;
+    hash ^= hash >> 32;
+    hash *= multiplier;
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * @brief The VFIItemField struct stores a single key of a YAML map as it was received from the
+ *        parser events. Only scalars, nulls and flat sequences of scalars are supported.
+ */
+struct VFIItemField
+{
+    enum class KIND{
+        SCALAR,
+        NULL_VALUE,
+        SEQUENCE
+    };
+    std::string key;
+    KIND kind = KIND::SCALAR;
+    std::string scalar;
+    std::vector<std::string> sequence;
+    YAML::Mark mark;
+};
+
+/**
+ * @brief The VFIItemFields class stores the fields of a YAML map without building a YAML::Node.
+ *        The field slots are reused between items to keep the string capacities.
+ */
+class VFIItemFields
+{
+    std::vector<VFIItemField> fields_;
+    std::size_t size_ = 0;
+public:
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    VFIItemField& emplace(const std::string_view& key, const VFIItemField::KIND& kind, const YAML::Mark& mark)
+    {
+        if (size_ == fields_.size())
+            fields_.emplace_back();
+        VFIItemField& field = fields_[size_++];
+        field.key = key;
+        field.kind = kind;
+        field.scalar.clear();
+        field.sequence.clear();
+        field.mark = mark;
+        return field;
+    }
+
+    VFIItemField& back()
+    {
+        return fields_[size_-1];
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    const VFIItemField* find(const std::string_view& key) const
+    {
+        for (std::size_t i = 0; i < size_; ++i)
+            if (fields_[i].key == key)
+                return &fields_[i];
+        return nullptr;
+    }
+};
+
+/**
+ * @brief The UnsupportedYamlStructure struct is thrown by the streaming loader when the file uses a
+ *        YAML feature (aliases, nested maps, duplicated keys, etc.) it does not handle. The caller
+ *        falls back to the DOM loader in that case.
+ */
+struct UnsupportedYamlStructure {};
+
+/**
+ * @brief decode_scalar converts a YAML scalar using the same rules as YAML::Node::as<T>().
+ *        Plain decimal numbers are converted with std::from_chars. Any other input uses the
+ *        yaml-cpp conversion.
+ * @param input The scalar.
+ * @param value The converted value.
+ * @return True if the conversion succeeded. False otherwise.
+ */
+template<typename T>
+bool decode_scalar(const std::string& input, T& value)
+{
+    if constexpr (std::is_same_v<T, int>) {
+        // yaml-cpp detects the base of integers, so leading zeros are left to yaml-cpp.
+        const std::size_t first_digit = (!input.empty() && input[0] == '-') ? 1 : 0;
+        const bool plain_decimal = input.size() > first_digit &&
+                                   (input[first_digit] != '0' || input.size() == first_digit + 1) &&
+                                   input.find_first_not_of("0123456789", first_digit) == std::string::npos;
+        if (plain_decimal) {
+            const auto [ptr, ec] = std::from_chars(input.data(), input.data() + input.size(), value);
+            if (ec == std::errc() && ptr == input.data() + input.size())
+                return true;
+        }
+    } else if constexpr (std::is_same_v<T, double>) {
+        const bool plain_decimal = !input.empty() && input[0] != '+' &&
+                                   input.find_first_not_of("0123456789.eE+-") == std::string::npos;
+        if (plain_decimal) {
+            const auto [ptr, ec] = std::from_chars(input.data(), input.data() + input.size(), value);
+            if (ec == std::errc() && ptr == input.data() + input.size())
+                return true;
+        }
+    }
+    return YAML::convert<T>::decode(YAML::Node(input), value);
+}
+
+/**
+ * @brief field_as_string mimics YAML::Node::as<std::string>() on the field.
+ */
+std::string field_as_string(const VFIItemFields& item, const std::string_view& key)
+{
+    const VFIItemField* field = item.find(key);
+    if (!field)
+        throw YAML::InvalidNode(std::string(key));
+    if (field->kind == VFIItemField::KIND::NULL_VALUE)
+        return "null";
+    if (field->kind != VFIItemField::KIND::SCALAR)
+        throw YAML::TypedBadConversion<std::string>(field->mark);
+    return field->scalar;
+}
+
+/**
+ * @brief field_as mimics YAML::Node::as<T>() on the field for non-string types.
+ */
+template<typename T>
+T field_as(const VFIItemFields& item, const std::string_view& key)
+{
+    const VFIItemField* field = item.find(key);
+    if (!field)
+        throw YAML::InvalidNode(std::string(key));
+    T value;
+    if (field->kind != VFIItemField::KIND::SCALAR || !decode_scalar(field->scalar, value))
+        throw YAML::TypedBadConversion<T>(field->mark);
+    return value;
+}
+
+/**
+ * @brief field_as_vector_list mimics VFIConfigurationFileYaml::Impl::get_vector_list on the field.
+ *        The list is allocated from the given memory resource.
+ */
+VFIConfigurationFile::EntityList field_as_vector_list(const VFIItemFields& item, const std::string_view& key,
+                                                      std::pmr::memory_resource* resource)
+{
+    VFIConfigurationFile::EntityList entities(resource);
+    const VFIItemField* field = item.find(key);
+    if (!field)
+        throw YAML::InvalidNode(std::string(key));
+    if (field->kind == VFIItemField::KIND::SEQUENCE) {
+        entities.assign(field->sequence.begin(), field->sequence.end());
+        if (entities.empty())
+            throw std::runtime_error(std::string(key) + "is an empty list!");
+    }
+    return entities;
+}
+
+/**
+ * @brief convert_vfi_fields converts the fields of a vfi_array item of a known VFI type, in the
+ *        order of DATA_FIELDS.
+ * @param item The fields of the item.
+ * @param vfi_type The VFI type, already read from the item.
+ * @param resource The memory resource of the entity lists.
+ * @return The VFI data.
+ */
+template<typename DataType>
+DataType convert_vfi_fields(const VFIItemFields& item, const std::string& vfi_type,
+                            std::pmr::memory_resource* resource)
+{
+    DataType data(resource);
+    for_each_field(data, [&](auto descriptor, auto& value) {
+        using Descriptor = decltype(descriptor);
+        using FieldType = typename Descriptor::type;
+
+        if constexpr (Descriptor::field == FIELD::VFI_TYPE)
+            value = vfi_type;
+        else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList>)
+            value = field_as_vector_list(item, Descriptor::name, resource);
+        else if constexpr (std::is_same_v<FieldType, Symbol> || std::is_same_v<FieldType, std::string>)
+            value = field_as_string(item, Descriptor::name);
+        else
+            value = field_as<FieldType>(item, Descriptor::name);
+    });
+    return data;
+}
+
+/**
+ * @brief convert_vfi_item converts the fields of a vfi_array item. The fields are read in the same
+ *        order used by the DOM loader, so the first error reported for an item is the same.
+ * @param item The fields of the item.
+ * @param resource The memory resource of the entity lists.
+ * @return The VFI data.
+ */
+VFIConfigurationFile::Data convert_vfi_item(const VFIItemFields& item, std::pmr::memory_resource* resource)
+{
+    std::string vfi_type = field_as_string(item, "vfi_type");
+
+    if (vfi_type == "ENVIRONMENT_TO_ROBOT") {
+        return convert_vfi_fields<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>(item, vfi_type, resource);
+
+    }else if (vfi_type == "ROBOT_TO_ROBOT") {
+        return convert_vfi_fields<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>(item, vfi_type, resource);
+
+    }else {
+        throw std::runtime_error("Unknown VFI type: " + vfi_type);
+    }
+}
+
+/**
+ * @brief check_vfi_item checks the fields of a vfi_array item as convert_vfi_item converts them,
+ *        in the same order, without building the VFI data. The errors are the same as those of
+ *        convert_vfi_item.
+ * @param item The fields of the item.
+ */
+void check_vfi_item(const VFIItemFields& item)
+{
+    auto check_fields = [&item](auto... descriptors) {
+        ([&item](auto descriptor) {
+            using Descriptor = decltype(descriptor);
+            using FieldType = typename Descriptor::type;
+
+            if constexpr (Descriptor::field == FIELD::VFI_TYPE)
+                return;
+            else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList>) {
+                const VFIItemField* field = item.find(Descriptor::name);
+                if (!field)
+                    throw YAML::InvalidNode(std::string(Descriptor::name));
+                if (field->kind == VFIItemField::KIND::SEQUENCE && field->sequence.empty())
+                    throw std::runtime_error(std::string(Descriptor::name) + "is an empty list!");
+            }
+            else if constexpr (std::is_same_v<FieldType, Symbol> || std::is_same_v<FieldType, std::string>)
+                field_as_string(item, Descriptor::name);
+            else
+                field_as<FieldType>(item, Descriptor::name);
+        }(descriptors), ...);
+    };
+
+    const std::string vfi_type = field_as_string(item, "vfi_type");
+    if (vfi_type == "ENVIRONMENT_TO_ROBOT")
+        std::apply(check_fields, data_fields_t<VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>{});
+    else if (vfi_type == "ROBOT_TO_ROBOT")
+        std::apply(check_fields, data_fields_t<VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>{});
+    else
+        throw std::runtime_error("Unknown VFI type: " + vfi_type);
+}
+
+/**
+ * @brief The VFIItemSink class converts the vfi_array items and stores the results.
+ *        The item diagnostics are deferred, so they can be printed after the header warnings,
+ *        exactly as in the DOM loader. After the first non-YAML error the remaining items
+ *        are ignored, since the DOM loader stops at that point.
+ */
+class VFIItemSink
+{
+public:
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(); // Of the entity lists
+    std::vector<VFIConfigurationFile::Data> data;
+    std::vector<std::string> diagnostics;
+    std::exception_ptr fatal_error;
+
+    void add(const VFIItemFields& item, const char*, const char*, const int&)
+    {
+        add(item);
+    }
+
+    void add(const VFIItemFields& item)
+    {
+        if (fatal_error)
+            return;
+        try {
+            data.push_back(convert_vfi_item(item, resource));
+        }
+        catch (const YAML::Exception& e) {
+            diagnostics.push_back(std::string("Error parsing VFI item: ") + e.what());
+        }
+        catch (...) {
+            fatal_error = std::current_exception();
+        }
+    }
+};
+
+/**
+ * @brief The VFIIndexSink class receives the vfi_array items for VFIConfigurationFileYaml::index_data.
+ *        The fields of each item are checked (see check_vfi_item), but only its tag is decoded.
+ *        An item with a malformed field is reported and skipped, as in load_data. After the first
+ *        non-YAML error the remaining items are ignored, as in VFIItemSink.
+ */
+class VFIIndexSink
+{
+public:
+    std::shared_ptr<const std::string> source;
+    std::vector<VFIConfigurationFile::LAZY_ENTRY> entries;
+    std::vector<std::string> diagnostics;
+    std::exception_ptr fatal_error;
+
+    void add(const VFIItemFields& item, const char* first, const char* last, const int& first_line_number)
+    {
+        if (fatal_error)
+            return;
+        try {
+            check_vfi_item(item);
+            entries.push_back({field_as_string(item, "tag"), source,
+                               static_cast<std::size_t>(first - source->data()),
+                               static_cast<std::size_t>(last - source->data()),
+                               first_line_number});
+        }
+        catch (const YAML::Exception& e) {
+            diagnostics.push_back(std::string("Error parsing VFI item: ") + e.what());
+        }
+        catch (...) {
+            fatal_error = std::current_exception();
+        }
+    }
+};
+
+/**
+ * @brief find_any_of returns the first position in [first, last) that holds c1, c2 or c3.
+ *        Uses SSE2 to test 16 bytes per step when available.
+ * @return The desired position, or last if none of the characters is found.
+ */
+inline const char* find_any_of(const char* first, const char* last, const char& c1, const char& c2, const char& c3)
+{
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+    while (last - first >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, v1),
+                                                          _mm_cmpeq_epi8(chunk, v2)),
+                                             _mm_cmpeq_epi8(chunk, v3));
+        const int mask = _mm_movemask_epi8(matches);
+        if (mask != 0)
+            return first + __builtin_ctz(static_cast<unsigned int>(mask));
+        first += 16;
+    }
+#endif
+    for (; first != last; ++first)
+        if (*first == c1 || *first == c2 || *first == c3)
+            return first;
+    return last;
+}
+
+/**
+ * @brief The MemoryStreamBuffer class reads a buffer in place, so a stream parses the contents
+ *        of a file that were already read without copying them.
+ */
+class MemoryStreamBuffer: public std::streambuf
+{
+public:
+    MemoryStreamBuffer(const char* data, const std::size_t& size)
+    {
+        char* first = const_cast<char*>(data);
+        setg(first, first, first + size);
+    }
+};
+
+/**
+ * @brief The VFIDialectScanner class reads the narrow YAML dialect written by
+ *        VFIConfigurationFileYaml::save_data: a header of plain `key: value` lines, a vfi_array of
+ *        `-` blocks whose fields are plain scalars, double-quoted strings without escapes, or
+ *        single-line flow sequences of double-quoted strings.
+ *        The scanner is a strict subset of YAML. Anything else (comments, anchors, tabs, other
+ *        top-level keys, multi-line values, etc.) makes scan() return false, so the caller can
+ *        use yaml-cpp instead.
+ */
+class VFIDialectScanner
+{
+    const char* begin_;
+    const char* next_;
+    const char* end_;
+    const char* line_ = nullptr;
+    const char* line_end_ = nullptr;
+    int line_number_;
+    int item_indent_ = -1;
+    VFIItemFields item_;
+
+public:
+    explicit VFIDialectScanner(const std::string& text)
+        : begin_(text.data()), next_(text.data()), end_(text.data() + text.size()), line_number_(-1)
+    {
+    }
+
+    /**
+     * @brief VFIDialectScanner ctor of a scanner for a slice of the vfi_array of a text.
+     * @param text The whole text, used to compute the marks.
+     * @param first The first line of the slice. It must be the first line of an item.
+     * @param last The end of the slice.
+     * @param first_line_number The zero-based line number of first.
+     * @param item_indent The indentation of the vfi_array items.
+     */
+    VFIDialectScanner(const std::string& text, const char* first, const char* last,
+                      const int& first_line_number, const int& item_indent)
+        : begin_(text.data()), next_(first), end_(last), line_number_(first_line_number - 1),
+          item_indent_(item_indent)
+    {
+    }
+
+    /**
+     * @brief scan reads the whole text.
+     * @param header The header fields.
+     * @param items The sink that receives the vfi_array items.
+     * @return True if the text is written in the dialect. False otherwise.
+     */
+    bool scan(VFIItemFields& header, VFIItemSink& items)
+    {
+        return scan_header(header) && scan_items(items);
+    }
+
+    /**
+     * @brief scan_header reads the header up to and including the `vfi_array:` line.
+     * @param header The header fields.
+     * @return True if the header is written in the dialect. False otherwise.
+     */
+    bool scan_header(VFIItemFields& header)
+    {
+        while (_next_line()) {
+            const char* p = _skip_spaces(line_);
+            if (p == line_end_)
+                continue; // Blank line
+            if (p != line_)
+                return false;
+            const char* key_end = _parse_key(p);
+            if (!key_end)
+                return false;
+            const std::string_view key(p, key_end - p);
+            const char* value = _skip_spaces(key_end + 1);
+            if (key == "vfi_array")
+                return value == line_end_;
+            if ((key != "vfi_file_version" && key != "zero_indexed") || header.find(key))
+                return false;
+            if (value == line_end_ || *value == '[' || !_parse_value(header, key, value))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief scan_items reads the vfi_array items up to the end of the text (or slice).
+     * @param items The sink that receives the vfi_array items. For each item, the sink receives
+     *        its fields and the range of text from its `-` line to the next item.
+     * @return True if the items are written in the dialect. False otherwise.
+     */
+    template<typename SINK>
+    bool scan_items(SINK& items)
+    {
+        const char* item_first = nullptr;
+        int item_first_line = 0;
+        int field_indent = -1;
+
+        while (_next_line()) {
+            const char* p = _skip_spaces(line_);
+            if (p == line_end_)
+                continue; // Blank line
+            const int indent = static_cast<int>(p - line_);
+
+            if (*p == '-') {
+                if (_skip_spaces(p + 1) != line_end_)
+                    return false;
+                if (item_indent_ == -1)
+                    item_indent_ = indent;
+                if (indent != item_indent_ || (item_first && item_.size() == 0))
+                    return false;
+                if (item_first)
+                    items.add(item_, item_first, line_, item_first_line);
+                item_.clear();
+                item_first = line_;
+                item_first_line = line_number_;
+                field_indent = -1;
+            }
+            else {
+                if (!item_first || indent <= item_indent_)
+                    return false;
+                if (field_indent == -1)
+                    field_indent = indent;
+                if (indent != field_indent)
+                    return false;
+                const char* key_end = _parse_key(p);
+                if (!key_end)
+                    return false;
+                const std::string_view key(p, key_end - p);
+                const char* value = _skip_spaces(key_end + 1);
+                if (value == line_end_ || item_.find(key) || !_parse_value(item_, key, value))
+                    return false;
+            }
+        }
+
+        if (item_first) {
+            if (item_.size() == 0)
+                return false;
+            items.add(item_, item_first, end_, item_first_line);
+        }
+        return true;
+    }
+
+    /**
+     * @brief position returns the start of the first line not read yet.
+     */
+    const char* position() const
+    {
+        return next_;
+    }
+
+    /**
+     * @brief line_number returns the zero-based line number of position().
+     */
+    int line_number() const
+    {
+        return line_number_ + 1;
+    }
+
+private:
+    /**
+     * @brief _next_line moves to the next line of the text.
+     * @return False if there are no more lines.
+     */
+    bool _next_line()
+    {
+        if (next_ >= end_)
+            return false;
+        line_ = next_;
+        line_end_ = find_any_of(line_, end_, '\n', '\n', '\n');
+        next_ = (line_end_ == end_) ? end_ : line_end_ + 1;
+        line_number_++;
+        return true;
+    }
+
+    const char* _skip_spaces(const char* p) const
+    {
+        while (p != line_end_ && *p == ' ')
+            ++p;
+        return p;
+    }
+
+    YAML::Mark _mark(const char* p) const
+    {
+        YAML::Mark mark;
+        mark.pos = static_cast<int>(p - begin_);
+        mark.line = line_number_;
+        mark.column = static_cast<int>(p - line_);
+        return mark;
+    }
+
+    /**
+     * @brief _parse_key reads a `key:` prefix made of alphanumeric characters and underscores.
+     * @return The position of the ':' character, or nullptr if the line does not start with a key.
+     */
+    const char* _parse_key(const char* p) const
+    {
+        const char* key = p;
+        while (p != line_end_ && (std::isalnum(static_cast<unsigned char>(*p)) || *p == '_'))
+            ++p;
+        if (p == key || p == line_end_ || *p != ':')
+            return nullptr;
+        if (p + 1 != line_end_ && p[1] != ' ')
+            return nullptr;
+        return p;
+    }
+
+    /**
+     * @brief _parse_quoted reads a double-quoted string without escape sequences.
+     * @return The position after the closing quote, or nullptr if the string is not supported.
+     */
+    const char* _parse_quoted(const char* p, std::string_view& content) const
+    {
+        const char* close = find_any_of(p + 1, line_end_, '"', '\\', '\r');
+        if (close == line_end_ || *close != '"')
+            return nullptr;
+        content = std::string_view(p + 1, close - p - 1);
+        return close + 1;
+    }
+
+    /**
+     * @brief _parse_value reads the value of a field and stores it in fields.
+     * @return True if the value is written in the dialect. False otherwise.
+     */
+    bool _parse_value(VFIItemFields& fields, const std::string_view& key, const char* p)
+    {
+        if (*p == '"') {
+            std::string_view content;
+            p = _parse_quoted(p, content);
+            if (!p || _skip_spaces(p) != line_end_)
+                return false;
+            fields.emplace(key, VFIItemField::KIND::SCALAR, _mark(content.data() - 1)).scalar = content;
+            return true;
+        }
+
+        if (*p == '[') {
+            VFIItemField& field = fields.emplace(key, VFIItemField::KIND::SEQUENCE, _mark(p));
+            p = _skip_spaces(p + 1);
+            if (p != line_end_ && *p == ']')
+                return _skip_spaces(p + 1) == line_end_;
+            while (p != line_end_ && *p == '"') {
+                std::string_view content;
+                p = _parse_quoted(p, content);
+                if (!p)
+                    return false;
+                field.sequence.emplace_back(content);
+                p = _skip_spaces(p);
+                if (p != line_end_ && *p == ']')
+                    return _skip_spaces(p + 1) == line_end_;
+                if (p == line_end_ || *p != ',')
+                    return false;
+                p = _skip_spaces(p + 1);
+            }
+            return false;
+        }
+
+        // Plain scalar. Only a conservative set of characters is accepted, so the value
+        // cannot be a YAML null, an indicator, or a comment.
+        const char* start = p;
+        while (p != line_end_ && *p != ' ') {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (!std::isalnum(c) && c != '_' && c != '.' && c != '+' && c != '-')
+                return false;
+            ++p;
+        }
+        const std::string_view value(start, p - start);
+        if (_skip_spaces(p) != line_end_ || (value[0] == '-' && value.size() == 1) ||
+            value == "null" || value == "Null" || value == "NULL")
+            return false;
+        fields.emplace(key, VFIItemField::KIND::SCALAR, _mark(start)).scalar = value;
+        return true;
+    }
+};
+
+/**
+ * @brief The VFIArrayChunk struct is a slice of the vfi_array that starts at the first line of an item.
+ */
+struct VFIArrayChunk
+{
+    const char* first;
+    const char* last;
+    int first_line_number;
+};
+
+/**
+ * @brief split_vfi_array splits the vfi_array text into chunks of similar size. Every chunk
+ *        boundary is placed on a `-` line with the indentation of the first item.
+ * @param first The first line after the `vfi_array:` line.
+ * @param last The end of the text.
+ * @param first_line_number The zero-based line number of first.
+ * @param number_of_chunks The desired number of chunks.
+ * @param item_indent The indentation of the items, or -1 if the first item was not found.
+ * @return The chunks, in file order.
+ */
+std::vector<VFIArrayChunk> split_vfi_array(const char* first, const char* last, const int& first_line_number,
+                                           const std::size_t& number_of_chunks, int& item_indent)
+{
+    // Returns the indentation of the line if it is an item line. -1 otherwise.
+    auto item_line_indent = [last](const char* line) -> int {
+        const char* p = line;
+        while (p != last && *p == ' ')
+            ++p;
+        if (p == last || *p != '-')
+            return -1;
+        const int indent = static_cast<int>(p - line);
+        for (++p; p != last && *p != '\n'; ++p)
+            if (*p != ' ')
+                return -1;
+        return indent;
+    };
+    auto next_line = [last](const char* line) -> const char* {
+        const char* line_end = find_any_of(line, last, '\n', '\n', '\n');
+        return (line_end == last) ? last : line_end + 1;
+    };
+
+    std::vector<VFIArrayChunk> chunks;
+    const char* item = first;
+    int item_line_number = first_line_number;
+    while (item != last && item_line_indent(item) == -1) {
+        item = next_line(item);
+        item_line_number++;
+    }
+    item_indent = (item == last) ? -1 : item_line_indent(item);
+    if (item_indent == -1 || number_of_chunks < 2)
+        return {{first, last, first_line_number}};
+
+    chunks.push_back({first, last, first_line_number});
+    const std::size_t chunk_size = static_cast<std::size_t>(last - item) / number_of_chunks;
+    for (std::size_t i = 1; i < number_of_chunks; ++i) {
+        const char* target = item + i * chunk_size;
+        const char* boundary = next_line(target - 1);
+        while (boundary != last && item_line_indent(boundary) != item_indent)
+            boundary = next_line(boundary);
+        VFIArrayChunk& previous = chunks.back();
+        if (boundary == last || boundary <= previous.first)
+            break;
+        previous.last = boundary;
+        chunks.push_back({boundary, last, previous.first_line_number +
+                          static_cast<int>(std::count(previous.first, boundary, '\n'))});
+    }
+    chunks.back().last = last;
+    return chunks;
+}
+
+/**
+ * @brief The VFILoadThreadPool class runs the chunks of a parallel load. Its threads are started
+ *        by the first load that needs them and are reused by the next loads, so a load does not
+ *        pay for thread creation. The threads are joined when the pool is destroyed.
+ */
+class VFILoadThreadPool
+{
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable tasks_done_;
+    std::vector<std::thread> threads_;
+    const std::function<void(const std::size_t&)>* task_ = nullptr;
+    std::size_t next_task_ = 0;
+    std::size_t number_of_tasks_ = 0;
+    std::size_t pending_tasks_ = 0;
+    bool stopping_ = false;
+
+    /**
+     * @brief _run_tasks runs the tasks that no thread took yet. The lock is released while a task runs.
+     */
+    void _run_tasks(std::unique_lock<std::mutex>& lock)
+    {
+        while (next_task_ < number_of_tasks_) {
+            const std::size_t i = next_task_++;
+            lock.unlock();
+            (*task_)(i);
+            lock.lock();
+            if (--pending_tasks_ == 0)
+                tasks_done_.notify_all();
+        }
+    }
+
+    void _work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            task_ready_.wait(lock, [this]() { return stopping_ || next_task_ < number_of_tasks_; });
+            if (stopping_)
+                return;
+            _run_tasks(lock);
+        }
+    }
+
+public:
+    VFILoadThreadPool() = default;
+    VFILoadThreadPool(const VFILoadThreadPool&) = delete;
+    VFILoadThreadPool& operator=(const VFILoadThreadPool&) = delete;
+
+    ~VFILoadThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        task_ready_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    /**
+     * @brief run calls a task with each index in [0, number_of_tasks) and waits for all of them.
+     *        The calling thread runs tasks as well, so the pool starts number_of_tasks - 1
+     *        threads at most.
+     * @param number_of_tasks The number of tasks.
+     * @param task The task. It must not throw.
+     */
+    void run(const std::size_t& number_of_tasks, const std::function<void(const std::size_t&)>& task)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (threads_.size() + 1 < number_of_tasks)
+            threads_.emplace_back(&VFILoadThreadPool::_work, this);
+        task_ = &task;
+        next_task_ = 0;
+        number_of_tasks_ = number_of_tasks;
+        pending_tasks_ = number_of_tasks;
+        task_ready_.notify_all();
+        _run_tasks(lock);
+        tasks_done_.wait(lock, [this]() { return pending_tasks_ == 0; });
+        task_ = nullptr;
+        number_of_tasks_ = 0;
+    }
+};
+
+/**
+ * @brief The VFIStreamHandler class receives the yaml-cpp parser events of a VFI configuration
+ *        file and converts each vfi_array item as soon as its map is closed.
+ */
+class VFIStreamHandler: public YAML::EventHandler
+{
+    enum class STATE{
+        ROOT,
+        TOP_KEY,
+        TOP_VALUE,
+        ARRAY,
+        ITEM_KEY,
+        ITEM_VALUE,
+        ITEM_SEQUENCE,
+        SKIP,
+        DONE
+    };
+    STATE state_ = STATE::ROOT;
+    std::size_t skip_depth_ = 0;
+    std::string key_;
+    std::vector<std::string> top_keys_;
+    VFIItemFields item_;
+
+public:
+    VFIItemFields header;
+    VFIItemSink items;
+
+    bool is_complete() const
+    {
+        return state_ == STATE::DONE || state_ == STATE::ROOT;
+    }
+
+    void OnDocumentStart(const YAML::Mark&) override {}
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t) override
+    {
+        _on_scalar(mark, nullptr);
+    }
+
+    void OnAlias(const YAML::Mark&, YAML::anchor_t) override
+    {
+        throw UnsupportedYamlStructure();
+    }
+
+    void OnScalar(const YAML::Mark& mark, const std::string&, YAML::anchor_t, const std::string& value) override
+    {
+        _on_scalar(mark, &value);
+    }
+
+    void OnSequenceStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+    {
+        switch (state_) {
+        case STATE::TOP_VALUE:
+            if (key_ == "vfi_array")
+                state_ = STATE::ARRAY;
+            else if (_is_header_key(key_))
+                throw UnsupportedYamlStructure();
+            else
+                _start_skip();
+            break;
+        case STATE::ITEM_VALUE:
+            item_.emplace(key_, VFIItemField::KIND::SEQUENCE, mark);
+            state_ = STATE::ITEM_SEQUENCE;
+            break;
+        case STATE::SKIP:
+            skip_depth_++;
+            break;
+        default:
+            throw UnsupportedYamlStructure();
+        }
+    }
+
+    void OnSequenceEnd() override
+    {
+        switch (state_) {
+        case STATE::ARRAY:
+            state_ = STATE::TOP_KEY;
+            break;
+        case STATE::ITEM_SEQUENCE:
+            state_ = STATE::ITEM_KEY;
+            break;
+        case STATE::SKIP:
+            _end_skip();
+            break;
+        default:
+            throw UnsupportedYamlStructure();
+        }
+    }
+
+    void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+    {
+        switch (state_) {
+        case STATE::ROOT:
+            state_ = STATE::TOP_KEY;
+            break;
+        case STATE::TOP_VALUE:
+            if (key_ == "vfi_array" || _is_header_key(key_))
+                throw UnsupportedYamlStructure();
+            _start_skip();
+            break;
+        case STATE::ARRAY:
+            item_.clear();
+            state_ = STATE::ITEM_KEY;
+            break;
+        case STATE::SKIP:
+            skip_depth_++;
+            break;
+        default:
+            throw UnsupportedYamlStructure();
+        }
+    }
+
+    void OnMapEnd() override
+    {
+        switch (state_) {
+        case STATE::TOP_KEY:
+            state_ = STATE::DONE;
+            break;
+        case STATE::ITEM_KEY:
+            items.add(item_);
+            state_ = STATE::ARRAY;
+            break;
+        case STATE::SKIP:
+            _end_skip();
+            break;
+        default:
+            throw UnsupportedYamlStructure();
+        }
+    }
+
+private:
+    static bool _is_header_key(const std::string& key)
+    {
+        return key == "vfi_file_version" || key == "zero_indexed";
+    }
+
+    void _start_skip()
+    {
+        skip_depth_ = 1;
+        state_ = STATE::SKIP;
+    }
+
+    void _end_skip()
+    {
+        if (--skip_depth_ == 0)
+            state_ = STATE::TOP_KEY;
+    }
+
+    /**
+     * @brief _on_scalar handles both scalar and null events. A null event has value == nullptr.
+     */
+    void _on_scalar(const YAML::Mark& mark, const std::string* value)
+    {
+        const VFIItemField::KIND kind = value ? VFIItemField::KIND::SCALAR : VFIItemField::KIND::NULL_VALUE;
+        switch (state_) {
+        case STATE::TOP_KEY:
+            if (!value || std::find(top_keys_.begin(), top_keys_.end(), *value) != top_keys_.end())
+                throw UnsupportedYamlStructure();
+            top_keys_.push_back(*value);
+            key_ = *value;
+            state_ = STATE::TOP_VALUE;
+            break;
+        case STATE::TOP_VALUE:
+            // A scalar vfi_array has no items, as in the DOM loader.
+            if (_is_header_key(key_) && value)
+                header.emplace(key_, kind, mark).scalar = *value;
+            else if (_is_header_key(key_))
+                header.emplace(key_, kind, mark);
+            state_ = STATE::TOP_KEY;
+            break;
+        case STATE::ITEM_KEY:
+            if (!value || item_.find(*value))
+                throw UnsupportedYamlStructure();
+            key_ = *value;
+            state_ = STATE::ITEM_VALUE;
+            break;
+        case STATE::ITEM_VALUE:
+            if (value)
+                item_.emplace(key_, kind, mark).scalar = *value;
+            else
+                item_.emplace(key_, kind, mark);
+            state_ = STATE::ITEM_KEY;
+            break;
+        case STATE::ITEM_SEQUENCE:
+            item_.back().sequence.push_back(value ? *value : std::string("null"));
+            break;
+        case STATE::SKIP:
+            break;
+        default:
+            throw UnsupportedYamlStructure();
+        }
+    }
+};
+
+/**
+ * @brief append_double appends the shortest text that reads back as the same double.
+ * @param out The output buffer.
+ * @param value The value.
+ * @param decimal_point True to append ".0" to integral values, so they read as floating-point.
+ */
+void append_double(std::string& out, const double& value, const bool& decimal_point)
+{
+    if (std::isnan(value)) {
+        out += ".nan";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += (value < 0) ? "-.inf" : ".inf";
+        return;
+    }
+    char buffer[32];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<std::size_t>(end - buffer));
+    if (decimal_point && std::find_if(buffer, end, [](const char& c) { return c == '.' || c == 'e'; }) == end)
+        out += ".0";
+}
+
+void append_int(std::string& out, const int& value)
+{
+    char buffer[16];
+    out.append(buffer, static_cast<std::size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+}
+
+void append_string_field(std::string& out, const std::string_view& key, const std::string& value)
+{
+    out += "    ";
+    out += key;
+    out += ": \"";
+    out += value;
+    out += "\"\n";
+}
+
+void append_list_field(std::string& out, const std::string_view& key, const VFIConfigurationFile::EntityList& values)
+{
+    out += "    ";
+    out += key;
+    out += ": [";
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i > 0)
+            out += ", ";
+        out += '"';
+        out += values[i];
+        out += '"';
+    }
+    out += "]\n";
+}
+
+void append_int_field(std::string& out, const std::string_view& key, const int& value)
+{
+    out += "    ";
+    out += key;
+    out += ": ";
+    append_int(out, value);
+    out += '\n';
+}
+
+/**
+ * @brief write_entry writes the fields of a VFI item in the dialect of save_data.
+ * @param out The output buffer.
+ * @param item The VFI item.
+ */
+void write_entry(std::string& out, const VFIConfigurationFile::Data& item)
+{
+    std::visit([&out](auto&& arg) {
+        for_each_field(arg, [&out](auto descriptor, const auto& value) {
+            using Descriptor = decltype(descriptor);
+            using FieldType = typename Descriptor::type;
+
+            if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList>) {
+                append_list_field(out, Descriptor::name, value);
+            } else if constexpr (std::is_same_v<FieldType, int>) {
+                append_int_field(out, Descriptor::name, value);
+            } else if constexpr (std::is_same_v<FieldType, double>) {
+                out += "    ";
+                out += Descriptor::name;
+                out += ": ";
+                append_double(out, value, Descriptor::field == FIELD::VFI_GAIN); // vfi_gain with .0 for integers
+                out += '\n';
+            } else {
+                append_string_field(out, Descriptor::name, value);
+            }
+        });
+    }, item);
+}
+
+/**
+ * @brief write_entry writes the fields of an indexed entry as they are in the source file,
+ *        re-indented to the indentation of save_data.
+ * @param out The output buffer.
+ * @param entry The indexed entry.
+ */
+void write_entry(std::string& out, const VFIConfigurationFile::LAZY_ENTRY& entry)
+{
+    const char* p = entry.source->data() + entry.first;
+    const char* last = entry.source->data() + entry.last;
+    p = std::find(p, last, '\n'); // Skips the '-' line
+    while (p != last) {
+        const char* line = p + 1;
+        p = std::find(line, last, '\n');
+        const char* line_end = p;
+        while (line != line_end && *line == ' ')
+            ++line;
+        while (line_end != line && line_end[-1] == ' ')
+            --line_end;
+        if (line != line_end) {
+            out += "    ";
+            out.append(line, line_end);
+            out += '\n';
+        }
+    }
+}
+
+constexpr std::size_t estimated_entry_size = 512; // Typical size of a serialized item, in bytes
+
+/**
+ * @brief The VFIYamlWriter class writes a configuration file in the dialect of save_data, one
+ *        entry at a time. The entries are formatted into a buffer that goes to an AtomicFile
+ *        each time it fills up, so the memory use does not depend on the number of entries.
+ */
+class VFIYamlWriter: public VFIConfigurationFile::Writer
+{
+private:
+    static constexpr std::size_t buffer_capacity_ = 1 << 20;
+    std::string config_file_;
+    std::unique_ptr<AtomicFile> file_;
+    std::string buffer_;
+    std::size_t number_of_entries_ = 0;
+
+    void _flush()
+    {
+        file_->write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    template<typename ENTRY>
+    void _write(const ENTRY& entry)
+    {
+        if (!file_)
+            throw std::runtime_error("The file " + config_file_ + " is already closed!");
+        buffer_ += "  -\n";
+        write_entry(buffer_, entry);
+        ++number_of_entries_;
+        if (buffer_.size() >= buffer_capacity_)
+            _flush();
+    }
+
+public:
+    VFIYamlWriter(const std::string& config_file, const int& vfi_file_version, const bool& zero_indexed)
+        : config_file_(config_file)
+    {
+        if (config_file.empty())
+            throw std::runtime_error("config_file path cannot be empty!");
+
+        // Create directory if it doesn't exist
+        std::filesystem::path file_path(config_file);
+        std::filesystem::path directory = file_path.parent_path();
+
+        if (!directory.empty() && !std::filesystem::exists(directory)) {
+            std::cout << "Creating directory: " << directory << std::endl;
+            std::filesystem::create_directories(directory);
+        }
+
+        file_ = std::make_unique<AtomicFile>(config_file);
+        buffer_.reserve(buffer_capacity_ + 4 * estimated_entry_size);
+
+        // Write header using provided parameters
+        buffer_ += "vfi_file_version: ";
+        append_int(buffer_, vfi_file_version);
+        buffer_ += "\nzero_indexed: ";
+        buffer_ += zero_indexed ? "true" : "false";
+        buffer_ += "\nvfi_array:\n";
+    }
+
+    void write(const VFIConfigurationFile::Data& data) override
+    {
+        _write(data);
+    }
+
+    void write(const VFIConfigurationFile::LAZY_ENTRY& entry) override
+    {
+        _write(entry);
+    }
+
+    void close() override
+    {
+        if (!file_)
+            throw std::runtime_error("The file " + config_file_ + " is already closed!");
+        _flush();
+        file_->commit();
+        file_.reset();
+
+        std::cout << "Successfully saved " << number_of_entries_
+                  << " VFI entries to: " << config_file_ << std::endl;
+    }
+};
+
+}
+
 class VFIConfigurationFileYaml::Impl
 {
 public:
@@ -38,55 +1262,131 @@ public:
     std::string config_file_;
     int vfi_file_version_ = 2; // default value
     bool zero_indexed_ = true; // default value
+    LOAD_MODE load_mode_ = LOAD_MODE::DOM; // default value
+    int number_of_load_threads_ = 0; // default value: std::thread::hardware_concurrency()
+    std::string cache_directory_; // default value: the cache is disabled
+    bool has_diagnostics_ = false; // True if the last load reported warnings or item errors
+    ARENA_MODE arena_mode_ = ARENA_MODE::HEAP; // default value
+    // The arenas of the loaded data. They are declared before raw_data_, so they outlive it.
+    std::vector<std::unique_ptr<std::pmr::memory_resource>> arenas_;
     std::vector<Data> raw_data_;
+    VFILoadThreadPool load_thread_pool_; // The threads of the LOAD_MODE::PARALLEL mode
     Impl()
     {
 
     };
 
+    /**
+     * @brief _new_arena creates an arena for the data of the current load, according to the
+     *        arena mode.
+     * @return The memory resource of the arena, or the default memory resource in the HEAP mode.
+     */
+    std::pmr::memory_resource* _new_arena()
+    {
+        switch (arena_mode_) {
+        case ARENA_MODE::MONOTONIC:
+            arenas_.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>());
+            return arenas_.back().get();
+        case ARENA_MODE::POOL:
+            arenas_.push_back(std::make_unique<std::pmr::unsynchronized_pool_resource>());
+            return arenas_.back().get();
+        case ARENA_MODE::HEAP:
+            break;
+        }
+        return std::pmr::get_default_resource();
+    }
+
+    /**
+     * @brief _release_data discards the loaded data and releases its arenas at once.
+     */
+    void _release_data()
+    {
+        raw_data_.clear();
+        arenas_.clear();
+    }
+
 
 
     /**
-     * @brief get_vector_list returns a string vector containing the data from a given YAML node.
+     * @brief get_vector_list returns a Symbol vector containing the data from a given YAML node.
      * @param node A YAML node
      * @param key_name The key name to display an error message.
-     * @return The desired string vector.
+     * @param resource The memory resource of the vector.
+     * @return The desired Symbol vector.
      */
-    std::vector<std::string> get_vector_list(const YAML::Node& node, const std::string& key_name)
+    VFIConfigurationFile::EntityList get_vector_list(const YAML::Node& node, const std::string& key_name,
+                                                     std::pmr::memory_resource* resource)
     {
-        std::vector<std::string> entities;
+        VFIConfigurationFile::EntityList entities(resource);
         if (node.IsSequence()) {
-            entities = node.as<std::vector<std::string>>();
+            const auto values = node.as<std::vector<std::string>>();
+            entities.assign(values.begin(), values.end());
             if (entities.empty())
                 throw std::runtime_error(key_name + "is an empty list!");
         }
         return entities;
     }
 
+    /**
+     * @brief _get_vfi_fields reads the fields of a vfi_array item of a known VFI type, in the
+     *        order of DATA_FIELDS.
+     * @param parameter The YAML node of the item.
+     * @param vfi_type The VFI type, already read from the item.
+     * @param resource The memory resource of the entity lists.
+     * @return The VFI data.
+     */
+    template<typename DataType>
+    DataType _get_vfi_fields(const YAML::Node& parameter, const std::string& vfi_type,
+                             std::pmr::memory_resource* resource)
+    {
+        DataType data(resource);
+        for_each_field(data, [&](auto descriptor, auto& value) {
+            using Descriptor = decltype(descriptor);
+            using FieldType = typename Descriptor::type;
+            const std::string key(Descriptor::name);
+
+            if constexpr (Descriptor::field == FIELD::VFI_TYPE)
+                value = vfi_type;
+            else if constexpr (std::is_same_v<FieldType, VFIConfigurationFile::EntityList>)
+                value = get_vector_list(parameter[key], key, resource);
+            else if constexpr (std::is_same_v<FieldType, Symbol>)
+                value = parameter[key].template as<std::string>();
+            else
+                value = parameter[key].template as<FieldType>();
+        });
+        return data;
+    }
+
     /**
      * @brief VFIConfigurationFileYaml::_extract_yaml_data reads the YAML file and store the data on a RAW_DATA vector.
+     * @param text The contents of the file, if they were already read. Default: the file is read.
      */
-    void _extract_yaml_data()
+    void _extract_yaml_data(const std::string* text = nullptr)
     {
         raw_data_.clear();
         try {
-            config_ = YAML::LoadFile(config_file_);
+            config_ = text ? YAML::Load(*text) : YAML::LoadFile(config_file_);
 
             if (config_["vfi_file_version"])
                 vfi_file_version_ = config_["vfi_file_version"].as<int>();
-            else
+            else {
+                has_diagnostics_ = true;
                 std::cerr << "Warning: vfi_file_version not found, using default: "
                           << vfi_file_version_ << std::endl;
+            }
 
 
             if (config_["zero_indexed"])
                 zero_indexed_ = config_["zero_indexed"].as<bool>();
-            else
+            else {
+                has_diagnostics_ = true;
                 std::cerr << "Warning: zero_indexed not found, using default: " + bool2string(zero_indexed_)<< std::endl;
+            }
 
 
 
             const YAML::Node& vfi_array = config_["vfi_array"]; //Aliasing
+            std::pmr::memory_resource* resource = _new_arena();
 
 
 
@@ -95,46 +1395,17 @@ public:
                     std::string vfi_type = parameter["vfi_type"].as<std::string>();
 
                     if (vfi_type == "ENVIRONMENT_TO_ROBOT") {
-                        ENVIRONMENT_TO_ROBOT_DATA env_data;
-                        env_data.vfi_type = vfi_type;
-                        env_data.cs_entity_environment  = get_vector_list(parameter["cs_entity_environment"],
-                                                                                "cs_entity_environment");
-                        env_data.cs_entity_robot  = get_vector_list(parameter["cs_entity_robot"],
-                                                                          "cs_entity_robot");
-                        env_data.entity_environment_primitive_type = parameter["entity_environment_primitive_type"].as<std::string>();
-                        env_data.entity_robot_primitive_type = parameter["entity_robot_primitive_type"].as<std::string>();
-                        env_data.robot_index = parameter["robot_index"].as<int>();
-                        env_data.joint_index = parameter["joint_index"].as<int>();
-                        env_data.safe_distance = parameter["safe_distance"].as<double>();
-                        env_data.vfi_gain = parameter["vfi_gain"].as<double>();
-                        env_data.direction = parameter["direction"].as<std::string>();
-                        env_data.tag = parameter["tag"].as<std::string>();
-                        raw_data_.push_back(env_data);
+                        raw_data_.push_back(_get_vfi_fields<ENVIRONMENT_TO_ROBOT_DATA>(parameter, vfi_type, resource));
 
                     }else if (vfi_type == "ROBOT_TO_ROBOT") {
-                        ROBOT_TO_ROBOT_DATA robot_data;
-                        robot_data.vfi_type = vfi_type;
-                        robot_data.cs_entity_one  = get_vector_list(parameter["cs_entity_one"],
-                                                                          "cs_entity_one");
-                        robot_data.cs_entity_two = get_vector_list(parameter["cs_entity_two"],
-                                                                          "cs_entity_two");
-                        robot_data.entity_one_primitive_type = parameter["entity_one_primitive_type"].as<std::string>();
-                        robot_data.entity_two_primitive_type = parameter["entity_two_primitive_type"].as<std::string>();
-                        robot_data.robot_index_one = parameter["robot_index_one"].as<int>();
-                        robot_data.robot_index_two = parameter["robot_index_two"].as<int>();
-                        robot_data.joint_index_one = parameter["joint_index_one"].as<int>();
-                        robot_data.joint_index_two = parameter["joint_index_two"].as<int>();
-                        robot_data.safe_distance = parameter["safe_distance"].as<double>();
-                        robot_data.vfi_gain = parameter["vfi_gain"].as<double>();
-                        robot_data.direction = parameter["direction"].as<std::string>();
-                        robot_data.tag = parameter["tag"].as<std::string>();
-                        raw_data_.push_back(robot_data);
+                        raw_data_.push_back(_get_vfi_fields<ROBOT_TO_ROBOT_DATA>(parameter, vfi_type, resource));
 
                     }else {
                         throw std::runtime_error("Unknown VFI type: " + vfi_type);
                     }
                 }
                 catch (const YAML::Exception& e) {
+                    has_diagnostics_ = true;
                     std::cerr << "Error parsing VFI item: " << e.what() << std::endl;
                 }
             }
@@ -152,6 +1423,316 @@ public:
 
     }
 
+    /**
+     * @brief _publish_items stores the header and the items extracted without the YAML::Node tree,
+     *        reporting the warnings and diagnostics in the same order used by the DOM loader.
+     * @param header The header fields.
+     * @param items The converted items.
+     */
+    void _publish_items(const VFIItemFields& header, VFIItemSink& items)
+    {
+        _publish_header(header);
+
+        has_diagnostics_ = has_diagnostics_ || !items.diagnostics.empty();
+        for (const auto& diagnostic : items.diagnostics)
+            std::cerr << diagnostic << std::endl;
+
+        raw_data_ = std::move(items.data);
+        if (items.fatal_error)
+            std::rethrow_exception(items.fatal_error);
+    }
+
+    /**
+     * @brief _publish_header stores the header fields, reporting the missing ones.
+     * @param header The header fields.
+     */
+    void _publish_header(const VFIItemFields& header)
+    {
+        if (header.find("vfi_file_version"))
+            vfi_file_version_ = field_as<int>(header, "vfi_file_version");
+        else {
+            has_diagnostics_ = true;
+            std::cerr << "Warning: vfi_file_version not found, using default: "
+                      << vfi_file_version_ << std::endl;
+        }
+
+
+        if (header.find("zero_indexed"))
+            zero_indexed_ = field_as<bool>(header, "zero_indexed");
+        else {
+            has_diagnostics_ = true;
+            std::cerr << "Warning: zero_indexed not found, using default: " + bool2string(zero_indexed_)<< std::endl;
+        }
+    }
+
+    /**
+     * @brief _extract_yaml_data_streaming reads the YAML file using the yaml-cpp parser events,
+     *        without building the YAML::Node tree. If the file uses a YAML feature that is not
+     *        supported by the streaming loader, the DOM loader is used instead.
+     * @param text The contents of the file, if they were already read. Default: the file is read.
+     */
+    void _extract_yaml_data_streaming(const std::string* text = nullptr)
+    {
+        raw_data_.clear();
+        config_ = YAML::Node();
+        try {
+            std::ifstream fin;
+            if (!text) {
+                fin.open(config_file_);
+                if (!fin)
+                    throw YAML::BadFile(config_file_);
+            }
+            MemoryStreamBuffer buffer(text ? text->data() : nullptr, text ? text->size() : 0);
+            std::istream memory(&buffer);
+
+            VFIStreamHandler handler;
+            handler.items.resource = _new_arena();
+            try {
+                YAML::Parser parser(text ? memory : fin);
+                parser.HandleNextDocument(handler);
+                if (!handler.is_complete())
+                    throw UnsupportedYamlStructure();
+            }
+            catch (const UnsupportedYamlStructure&) {
+                fin.close();
+                _extract_yaml_data(text);
+                return;
+            }
+
+            _publish_items(handler.header, handler.items);
+        }
+        catch(const YAML::BadFile& e)
+        {
+            std::cerr << e.msg << std::endl;
+            throw std::runtime_error(e.msg);
+        }
+        catch(const YAML::ParserException& e)
+        {
+            std::cerr << e.msg << std::endl;
+            throw std::runtime_error(e.msg);
+        }
+    }
+
+    /**
+     * @brief _read_config_file reads the whole configuration file.
+     * @param text The contents of the file.
+     * @return False if the file cannot be opened.
+     */
+    bool _read_config_file(std::string& text)
+    {
+        std::ifstream fin(config_file_, std::ios::binary);
+        if (!fin)
+            return false;
+        fin.seekg(0, std::ios::end);
+        text.resize(static_cast<std::size_t>(fin.tellg()));
+        fin.seekg(0, std::ios::beg);
+        fin.read(text.data(), static_cast<std::streamsize>(text.size()));
+        return true;
+    }
+
+    /**
+     * @brief _extract_yaml_data_scanner reads the YAML file with the VFIDialectScanner. If the file
+     *        is not written in the dialect of save_data, the streaming loader is used instead.
+     * @param contents The contents of the file, if they were already read. Default: the file is read.
+     */
+    void _extract_yaml_data_scanner(const std::string* contents = nullptr)
+    {
+        raw_data_.clear();
+        config_ = YAML::Node();
+
+        std::string buffer;
+        if (!contents && !_read_config_file(buffer)) {
+            _extract_yaml_data_streaming(); // Reports the missing file
+            return;
+        }
+        const std::string& text = contents ? *contents : buffer;
+
+        VFIItemFields header;
+        VFIItemSink items;
+        items.resource = _new_arena();
+        VFIDialectScanner scanner(text);
+        if (!scanner.scan(header, items)) {
+            _extract_yaml_data_streaming(&text);
+            return;
+        }
+        _publish_items(header, items);
+    }
+
+    /**
+     * @brief _extract_yaml_data_parallel splits the vfi_array into chunks at item boundaries and
+     *        reads them with the VFIDialectScanner on the threads of load_thread_pool_, which are
+     *        kept from one load to the next. The results are merged in file order, so the data
+     *        and diagnostics are the same as in the other load modes.
+     *        If any chunk is not written in the dialect of save_data, the streaming loader is
+     *        used for the whole file.
+     * @param contents The contents of the file, if they were already read. Default: the file is read.
+     */
+    void _extract_yaml_data_parallel(const std::string* contents = nullptr)
+    {
+        raw_data_.clear();
+        config_ = YAML::Node();
+
+        std::string buffer;
+        if (!contents && !_read_config_file(buffer)) {
+            _extract_yaml_data_streaming(); // Reports the missing file
+            return;
+        }
+        const std::string& text = contents ? *contents : buffer;
+
+        VFIItemFields header;
+        VFIDialectScanner header_scanner(text);
+        if (!header_scanner.scan_header(header)) {
+            _extract_yaml_data_streaming(&text);
+            return;
+        }
+
+        // Small chunks are not worth a thread
+        constexpr std::size_t min_chunk_size = 1 << 16;
+        const std::size_t array_size = static_cast<std::size_t>(text.data() + text.size() - header_scanner.position());
+        std::size_t number_of_threads = (number_of_load_threads_ > 0) ?
+                                            static_cast<std::size_t>(number_of_load_threads_) :
+                                            std::max(1u, std::thread::hardware_concurrency());
+        number_of_threads = std::max<std::size_t>(1, std::min(number_of_threads, array_size / min_chunk_size));
+
+        int item_indent;
+        const std::vector<VFIArrayChunk> chunks = split_vfi_array(header_scanner.position(),
+                                                                  text.data() + text.size(),
+                                                                  header_scanner.line_number(),
+                                                                  number_of_threads, item_indent);
+
+        // One arena per chunk, since the arenas are not synchronized
+        std::vector<VFIItemSink> chunk_items(chunks.size());
+        for (auto& items : chunk_items)
+            items.resource = _new_arena();
+        std::vector<char> chunk_is_valid(chunks.size(), false);
+        auto scan_chunk = [&](const std::size_t& i) {
+            VFIDialectScanner scanner(text, chunks[i].first, chunks[i].last,
+                                      chunks[i].first_line_number, item_indent);
+            chunk_is_valid[i] = scanner.scan_items(chunk_items[i]);
+        };
+
+        load_thread_pool_.run(chunks.size(), scan_chunk);
+
+        if (std::find(chunk_is_valid.begin(), chunk_is_valid.end(), false) != chunk_is_valid.end()) {
+            _extract_yaml_data_streaming(&text);
+            return;
+        }
+
+        // Merge in file order, stopping at the first chunk with a non-YAML error.
+        VFIItemSink items = std::move(chunk_items[0]);
+        for (std::size_t i = 1; i < chunk_items.size() && !items.fatal_error; ++i) {
+            items.data.insert(items.data.end(),
+                              std::make_move_iterator(chunk_items[i].data.begin()),
+                              std::make_move_iterator(chunk_items[i].data.end()));
+            items.diagnostics.insert(items.diagnostics.end(),
+                                     chunk_items[i].diagnostics.begin(),
+                                     chunk_items[i].diagnostics.end());
+            items.fatal_error = chunk_items[i].fatal_error;
+        }
+        _publish_items(header, items);
+    }
+
+    /**
+     * @brief _cache_file_prefix returns the prefix of the cache files of the configuration file.
+     *        It encodes the cache format version and the hash of the absolute path of the file.
+     * @return The desired prefix.
+     */
+    std::string _cache_file_prefix() const
+    {
+        std::error_code error;
+        std::filesystem::path source = std::filesystem::weakly_canonical(config_file_, error);
+        if (error)
+            source = std::filesystem::absolute(config_file_, error);
+        std::ostringstream prefix;
+        prefix << "vfi_cache_v" << cache_format_version << "_"
+               << std::hex << std::setw(16) << std::setfill('0') << hash_bytes(source.string()) << "_";
+        return prefix.str();
+    }
+
+    /**
+     * @brief _cache_file_path returns the cache file of the configuration file contents.
+     *        The name encodes the prefix of the configuration file (see _cache_file_prefix), the
+     *        content hash and the file size.
+     * @param text The contents of the configuration file.
+     * @return The desired path.
+     */
+    std::filesystem::path _cache_file_path(const std::string& text) const
+    {
+        std::ostringstream name;
+        name << _cache_file_prefix()
+             << std::hex << std::setw(16) << std::setfill('0') << hash_bytes(text)
+             << std::dec << "_" << text.size() << ".vfib";
+        return std::filesystem::path(cache_directory_) / name.str();
+    }
+
+    /**
+     * @brief _evict_from_cache removes the cache files of the previous contents of the
+     *        configuration file, so the cache keeps one entry per configuration file.
+     * @param cache_file The cache file of the current contents.
+     */
+    void _evict_from_cache(const std::filesystem::path& cache_file) const
+    {
+        const std::string prefix = _cache_file_prefix();
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(cache_directory_, error))
+        {
+            const std::string name = entry.path().filename().string();
+            // The temporary files of the writers of other processes do not end with .vfib
+            if (name.rfind(prefix, 0) == 0 && entry.path().extension() == ".vfib" &&
+                entry.path().filename() != cache_file.filename())
+                std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    /**
+     * @brief _load_from_cache loads the data from the cache, if the cache has an entry for the
+     *        contents of the configuration file.
+     * @param cache_file The cache file of the contents.
+     * @return True if the data was loaded from the cache. False otherwise.
+     */
+    bool _load_from_cache(const std::filesystem::path& cache_file)
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(cache_file, error))
+            return false;
+        try {
+            VFIConfigurationFileBinary cache;
+            cache.load_data(cache_file.string());
+            std::vector<Data> data;
+            data.reserve(cache.get_number_of_records());
+            std::pmr::memory_resource* resource = _new_arena();
+            for (std::size_t i = 0; i < cache.get_number_of_records(); ++i)
+                data.push_back(arenas_.empty() ? cache.get_record(i) : allocate_data(cache.get_record(i), resource));
+            raw_data_ = std::move(data);
+            vfi_file_version_ = cache.get_vfi_file_version();
+            zero_indexed_ = cache.is_zero_indexed();
+            config_ = YAML::Node();
+            return true;
+        } catch (const std::runtime_error& e) {
+            // A damaged cache entry is ignored. It is replaced after parsing the file.
+            std::cerr << "Warning: ignoring the cache file " << cache_file << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief _save_to_cache stores the loaded data in the cache. Loads that reported warnings or
+     *        item errors are not cached, so a cached load never hides a diagnostic.
+     * @param cache_file The cache file of the contents.
+     */
+    void _save_to_cache(const std::filesystem::path& cache_file)
+    {
+        if (has_diagnostics_)
+            return;
+        try {
+            VFIConfigurationFileBinary cache;
+            cache.write_data(raw_data_, vfi_file_version_, zero_indexed_, cache_file.string());
+            _evict_from_cache(cache_file);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Warning: cannot write the cache file " << cache_file << ": " << e.what() << std::endl;
+        }
+    }
+
 };
 
 /**
@@ -173,7 +1754,102 @@ VFIConfigurationFileYaml::VFIConfigurationFileYaml()
 void VFIConfigurationFileYaml::load_data(const std::string& config_file)
 {
     impl_->config_file_ = config_file;
-    impl_->_extract_yaml_data();
+    impl_->has_diagnostics_ = false;
+    impl_->_release_data();
+
+    // With the cache, the contents that were hashed are parsed, so the cache entry always
+    // matches the data even if the file changes in between
+    std::filesystem::path cache_file;
+    std::string text;
+    const std::string* contents = nullptr;
+    if (!impl_->cache_directory_.empty() && impl_->_read_config_file(text)) {
+        contents = &text;
+        cache_file = impl_->_cache_file_path(text);
+        if (impl_->_load_from_cache(cache_file))
+            return;
+    }
+
+    switch (impl_->load_mode_) {
+    case LOAD_MODE::DOM:
+        impl_->_extract_yaml_data(contents);
+        break;
+    case LOAD_MODE::STREAMING:
+        impl_->_extract_yaml_data_streaming(contents);
+        break;
+    case LOAD_MODE::SCANNER:
+        impl_->_extract_yaml_data_scanner(contents);
+        break;
+    case LOAD_MODE::PARALLEL:
+        impl_->_extract_yaml_data_parallel(contents);
+        break;
+    }
+
+    if (!cache_file.empty())
+        impl_->_save_to_cache(cache_file);
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::set_cache_directory enables a persistent cache of the loaded data.
+ *        The cache entries are .vfib files named after the path of the configuration file and the
+ *        hash and the size of its contents, so a modified file never matches a stale entry. A new
+ *        entry replaces the entry of the previous contents of the same file, so the cache holds
+ *        one entry per configuration file. A warm load costs one hash pass over the file plus a
+ *        binary read.
+ * @param cache_directory The directory of the cache. An empty string disables the cache. Default: "".
+ */
+void VFIConfigurationFileYaml::set_cache_directory(const std::string& cache_directory)
+{
+    impl_->cache_directory_ = cache_directory;
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::set_load_mode sets the strategy used by load_data.
+ * @param load_mode The desired load mode. Default: LOAD_MODE::DOM.
+ */
+void VFIConfigurationFileYaml::set_load_mode(const LOAD_MODE& load_mode)
+{
+    impl_->load_mode_ = load_mode;
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::set_arena_mode selects where load_data allocates the entity lists
+ *        of the data (see ARENA_MODE). With an arena, discarding the data of a load releases a few
+ *        large blocks instead of every list. The setting applies from the next load_data.
+ * @param arena_mode The desired arena mode. Default: ARENA_MODE::HEAP.
+ */
+void VFIConfigurationFileYaml::set_arena_mode(const ARENA_MODE& arena_mode)
+{
+    impl_->arena_mode_ = arena_mode;
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::get_arena_mode gets the arena mode.
+ * @return The arena mode.
+ */
+VFIConfigurationFile::ARENA_MODE VFIConfigurationFileYaml::get_arena_mode() const
+{
+    return impl_->arena_mode_;
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::set_number_of_load_threads sets the number of threads used
+ *        by the LOAD_MODE::PARALLEL mode.
+ * @param number_of_threads The desired number of threads. If zero or negative,
+ *        std::thread::hardware_concurrency() is used. Default: 0. The threads are started by
+ *        the first parallel load and reused by the next ones.
+ */
+void VFIConfigurationFileYaml::set_number_of_load_threads(const int& number_of_threads)
+{
+    impl_->number_of_load_threads_ = number_of_threads;
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::get_load_mode gets the strategy used by load_data.
+ * @return The current load mode.
+ */
+VFIConfigurationFileYaml::LOAD_MODE VFIConfigurationFileYaml::get_load_mode() const
+{
+    return impl_->load_mode_;
 }
 
 
@@ -189,6 +1865,36 @@ std::vector<VFIConfigurationFile::Data> VFIConfigurationFileYaml::get_data() con
     return impl_->raw_data_;
 }
 
+/**
+ * @brief VFIConfigurationFileYaml::take_data moves the raw data vector out of the object. The
+ *        file must be loaded again before the next get_data. The data built in an arena is
+ *        copied instead, since the arena is released by the next load.
+ * @return A raw data vector.
+ */
+std::vector<VFIConfigurationFile::Data> VFIConfigurationFileYaml::take_data()
+{
+    if (impl_->raw_data_.empty())
+        throw std::runtime_error("The vector data is empty!");
+    if (!impl_->arenas_.empty())
+    {
+        std::vector<Data> data(impl_->raw_data_.begin(), impl_->raw_data_.end());
+        impl_->_release_data();
+        return data;
+    }
+    return std::exchange(impl_->raw_data_, {});
+}
+
+/**
+ * @brief VFIConfigurationFileYaml::for_each_data calls a function with each element of the raw
+ *        data vector, without copying it.
+ * @param function The function.
+ */
+void VFIConfigurationFileYaml::for_each_data(const std::function<void(const Data&)>& function) const
+{
+    for (const auto& data : impl_->raw_data_)
+        function(data);
+}
+
 
 /**
  * @brief VFIConfigurationFileYaml::get_vfi_file_version gets the vfi_file_version data from
@@ -222,128 +1928,120 @@ void VFIConfigurationFileYaml::save_data(const std::vector<Data> &data,
                                          const std::string &config_file)
 {
     try {
-        if (config_file.empty())
-            throw std::runtime_error("config_file path cannot be empty!");
-
-        // Create directory if it doesn't exist
-        std::filesystem::path file_path(config_file);
-        std::filesystem::path directory = file_path.parent_path();
-
-        if (!directory.empty() && !std::filesystem::exists(directory)) {
-            std::cout << "Creating directory: " << directory << std::endl;
-            std::filesystem::create_directories(directory);
-        }
-
-        std::ofstream file(config_file);
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open file for writing: " + config_file);
-        }
-
-        // Write header using provided parameters
-        file << "vfi_file_version: " << vfi_file_version << "\n";
-        file << "zero_indexed: " << (zero_indexed ? "true" : "false") << "\n";
-        file << "vfi_array:\n";
-
-        // Write each data entry from the provided vector
-        for (const auto& item : data) {
-            file << "  -\n";
-            std::visit([&file](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-
-                if constexpr (std::is_same_v<T, VFIConfigurationFile::ENVIRONMENT_TO_ROBOT_DATA>) {
-                    file << "    vfi_type: \"" << arg.vfi_type << "\"\n";
-
-                    // cs_entity_environment
-                    file << "    cs_entity_environment: [";
-                    for (size_t i = 0; i < arg.cs_entity_environment.size(); ++i) {
-                        file << "\"" << arg.cs_entity_environment[i] << "\"";
-                        if (i < arg.cs_entity_environment.size() - 1) file << ", ";
-                    }
-                    file << "]\n";
-
-                    // cs_entity_robot
-                    file << "    cs_entity_robot: [";
-                    for (size_t i = 0; i < arg.cs_entity_robot.size(); ++i) {
-                        file << "\"" << arg.cs_entity_robot[i] << "\"";
-                        if (i < arg.cs_entity_robot.size() - 1) file << ", ";
-                    }
-                    file << "]\n";
-
-                    file << "    entity_environment_primitive_type: \""
-                         << arg.entity_environment_primitive_type << "\"\n";
-                    file << "    entity_robot_primitive_type: \""
-                         << arg.entity_robot_primitive_type << "\"\n";
-                    file << "    robot_index: " << arg.robot_index << "\n";
-                    file << "    joint_index: " << arg.joint_index << "\n";
-                    file << "    safe_distance: " << arg.safe_distance << "\n";
-
-                    // vfi_gain with .0 for integers
-                    file << "    vfi_gain: ";
-                    if (arg.vfi_gain == static_cast<int>(arg.vfi_gain)) {
-                        file << arg.vfi_gain << ".0";
-                    } else {
-                        file << arg.vfi_gain;
-                    }
-                    file << "\n";
-
-                    file << "    direction: \"" << arg.direction << "\"\n";
-                    file << "    tag: \"" << arg.tag << "\"\n";
+        VFIYamlWriter writer(config_file, vfi_file_version, zero_indexed);
+        for (const auto& item : data)
+            writer.write(item);
+        writer.close();
+    } catch (const std::filesystem::filesystem_error& e) {
+        throw std::runtime_error("Filesystem error in save_data: " + std::string(e.what()));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in save_data: " + std::string(e.what()));
+    }
+}
 
-                } else if constexpr (std::is_same_v<T, VFIConfigurationFile::ROBOT_TO_ROBOT_DATA>) {
-                    file << "    vfi_type: \"" << arg.vfi_type << "\"\n";
+/**
+ * @brief VFIConfigurationFileYaml::open_writer opens a configuration file to write its entries one
+ *        at a time, in the same format as save_data. The indexed entries are copied from their
+ *        source file.
+ * @param config_file The desired name of the file including its path and format.
+ * @param vfi_file_version The desired format version
+ * @param zero_indexed To define if the data uses a zero-indexed convention.
+ * @return The writer of the file.
+ */
+std::unique_ptr<VFIConfigurationFile::Writer> VFIConfigurationFileYaml::open_writer(const std::string& config_file,
+                                                                                     const int& vfi_file_version,
+                                                                                     const bool& zero_indexed)
+{
+    return std::make_unique<VFIYamlWriter>(config_file, vfi_file_version, zero_indexed);
+}
 
-                    // cs_entity_one
-                    file << "    cs_entity_one: [";
-                    for (size_t i = 0; i < arg.cs_entity_one.size(); ++i) {
-                        file << "\"" << arg.cs_entity_one[i] << "\"";
-                        if (i < arg.cs_entity_one.size() - 1) file << ", ";
-                    }
-                    file << "]\n";
+/**
+ * @brief VFIConfigurationFileYaml::index_data indexes a configuration file written in the dialect
+ *        of save_data. Only the header and the tag of each entry are decoded, but the other fields
+ *        are checked, so the indexed entries are the ones load_data keeps: an entry with a
+ *        malformed field is reported and skipped. A file that load_data rejects is left to
+ *        load_data, which reports the error.
+ * @param config_file The name of the file including its path and format.
+ * @param entries The indexed entries, in file order.
+ * @return True if the file was indexed. False if the file must be read with load_data.
+ */
+bool VFIConfigurationFileYaml::index_data(const std::string& config_file, std::vector<LAZY_ENTRY>& entries)
+{
+    auto text = std::make_shared<std::string>();
+    impl_->config_file_ = config_file;
+    if (!impl_->_read_config_file(*text))
+        return false;
 
-                    // cs_entity_two
-                    file << "    cs_entity_two: [";
-                    for (size_t i = 0; i < arg.cs_entity_two.size(); ++i) {
-                        file << "\"" << arg.cs_entity_two[i] << "\"";
-                        if (i < arg.cs_entity_two.size() - 1) file << ", ";
-                    }
-                    file << "]\n";
-
-                    file << "    entity_one_primitive_type: \""
-                         << arg.entity_one_primitive_type << "\"\n";
-                    file << "    entity_two_primitive_type: \""
-                         << arg.entity_two_primitive_type << "\"\n";
-                    file << "    robot_index_one: " << arg.robot_index_one << "\n";
-                    file << "    robot_index_two: " << arg.robot_index_two << "\n";
-                    file << "    joint_index_one: " << arg.joint_index_one << "\n";
-                    file << "    joint_index_two: " << arg.joint_index_two << "\n";
-                    file << "    safe_distance: " << arg.safe_distance << "\n";
-
-                    // vfi_gain with .0 for integers
-                    file << "    vfi_gain: ";
-                    if (arg.vfi_gain == static_cast<int>(arg.vfi_gain)) {
-                        file << arg.vfi_gain << ".0";
-                    } else {
-                        file << arg.vfi_gain;
-                    }
-                    file << "\n";
+    VFIItemFields header;
+    VFIIndexSink items;
+    items.source = text;
+    VFIDialectScanner scanner(*text);
+    if (!scanner.scan_header(header) || !scanner.scan_items(items) || items.fatal_error)
+        return false;
 
-                    file << "    direction: \"" << arg.direction << "\"\n";
-                    file << "    tag: \"" << arg.tag << "\"\n";
-                }
-            }, item);
-        }
+    impl_->_release_data();
+    impl_->config_ = YAML::Node();
+    impl_->has_diagnostics_ = !items.diagnostics.empty();
+    impl_->_publish_header(header);
+    for (const auto& diagnostic : items.diagnostics)
+        std::cerr << diagnostic << std::endl;
 
-        file.close();
+    entries = std::move(items.entries);
+    return true;
+}
 
-        std::cout << "Successfully saved " << data.size()
-                  << " VFI entries to: " << config_file << std::endl;
+/**
+ * @brief VFIConfigurationFileYaml::decode_entry decodes an entry indexed by index_data.
+ * @param entry The indexed entry.
+ * @return The decoded data.
+ */
+VFIConfigurationFile::Data VFIConfigurationFileYaml::decode_entry(const LAZY_ENTRY& entry) const
+{
+    VFIItemSink items;
+    VFIDialectScanner scanner(*entry.source,
+                              entry.source->data() + entry.first,
+                              entry.source->data() + entry.last,
+                              entry.first_line_number, -1);
+    if (!scanner.scan_items(items))
+        throw std::runtime_error("Entry '" + entry.tag + "' is not a VFI item!");
+    if (items.fatal_error)
+        std::rethrow_exception(items.fatal_error);
+    if (!items.diagnostics.empty())
+        throw std::runtime_error(items.diagnostics.front());
+    if (items.data.size() != 1)
+        throw std::runtime_error("Entry '" + entry.tag + "' is not a VFI item!");
+    return std::move(items.data.front());
+}
 
-    } catch (const std::filesystem::filesystem_error& e) {
-        throw std::runtime_error("Filesystem error in save_data: " + std::string(e.what()));
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Error in save_data: " + std::string(e.what()));
+/**
+ * @brief VFIConfigurationFileYaml::serialize_entries serializes data into entries that save_entries
+ *        copies verbatim. All the entries share a single buffer.
+ * @param data The data to serialize.
+ * @param entries The serialized entries, in the same order as data.
+ * @return True.
+ */
+bool VFIConfigurationFileYaml::serialize_entries(const std::vector<const Data*>& data,
+                                                 std::vector<LAZY_ENTRY>& entries) const
+{
+    auto text = std::make_shared<std::string>();
+    text->reserve(data.size() * estimated_entry_size);
+    std::vector<std::size_t> offsets;
+    offsets.reserve(data.size() + 1);
+    for (const auto& item : data) {
+        offsets.push_back(text->size());
+        *text += "  -\n";
+        write_entry(*text, *item);
     }
+    offsets.push_back(text->size());
+
+    entries.clear();
+    entries.reserve(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i)
+        entries.push_back({std::visit([](auto&& arg) { return arg.tag; }, *data[i]),
+                           text, offsets[i], offsets[i + 1], 0});
+    return true;
 }
 
 
+
 }